@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+namespace auction::bench {
+
+// Число вызовов operator new в текущем потоке с начала его жизни
+std::uint64_t allocationCount() noexcept;
+
+// Считает аллокации за время бенчмарка и публикует их как allocs/op
+class AllocationScope {
+ public:
+  explicit AllocationScope(benchmark::State& state) : state_(state), start_(allocationCount()) {}
+  ~AllocationScope() {
+    state_.counters["allocs/op"] = benchmark::Counter(static_cast<double>(allocationCount() - start_),
+                                                      benchmark::Counter::kAvgIterations);
+  }
+
+  AllocationScope(const AllocationScope&) = delete;
+  AllocationScope& operator=(const AllocationScope&) = delete;
+
+ private:
+  benchmark::State& state_;
+  std::uint64_t start_;
+};
+
+}  // namespace auction::bench
@@ -0,0 +1,169 @@
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+
+#include "alloc_counter.h"
+#include "auction/model/bid.h"
+#include "auction/model/json_writer.h"
+#include "auction/model/lot.h"
+#include "auction/model/money.h"
+#include "auction/model/timestamp.h"
+
+namespace {
+
+auction::model::Lot sampleLot() {
+  auction::model::Lot lot;
+  lot.id = 42;
+  lot.name = "Vintage mechanical watch";
+  lot.description = "Swiss movement, serviced in 2024, original box and papers";
+  lot.start_price = auction::model::Money::fromMinorUnits(15000);
+  lot.current_price = auction::model::Money::fromMinorUnits(27550);
+  lot.owner_id = "user-7f3c2a";
+  lot.created_at = auction::model::parseTimestamp("2025-11-02 09:15:30.123456+00");
+  lot.auction_end_date = auction::model::parseTimestamp("2025-12-31 18:00:00+00");
+  return lot;
+}
+
+const std::string kLotPayload =
+    R"({"name":"Vintage mechanical watch","description":"Swiss movement, serviced in 2024, original box and papers",)"
+    R"("start_price":150.0,"current_price":275.5,"owner_id":"user-7f3c2a","auction_end_date":"2025-12-31 18:00:00+00"})";
+
+void BM_LotToJson(benchmark::State& state) {
+  const auto lot = sampleLot();
+  auction::bench::AllocationScope allocations(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lot.toJson().dump());
+  }
+}
+BENCHMARK(BM_LotToJson);
+
+void BM_LotWriteJson(benchmark::State& state) {
+  const auto lot = sampleLot();
+  std::string out;
+  auction::bench::AllocationScope allocations(state);
+  for (auto _ : state) {
+    out.clear();
+    auction::model::json::appendLot(out, lot);
+    benchmark::DoNotOptimize(out.data());
+  }
+}
+BENCHMARK(BM_LotWriteJson);
+
+// Страница GET /lots: DOM-массив против прямой записи в буфер
+void BM_LotPageToJson(benchmark::State& state) {
+  const std::vector<auction::model::Lot> lots(static_cast<std::size_t>(state.range(0)), sampleLot());
+  auction::bench::AllocationScope allocations(state);
+  for (auto _ : state) {
+    nlohmann::json body = nlohmann::json::array();
+    for (const auto& lot : lots) {
+      body.push_back(lot.toJson());
+    }
+    benchmark::DoNotOptimize(body.dump());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LotPageToJson)->Arg(50)->Arg(1000);
+
+void BM_LotPageWriteJson(benchmark::State& state) {
+  const std::vector<auction::model::Lot> lots(static_cast<std::size_t>(state.range(0)), sampleLot());
+  std::string out;
+  auction::bench::AllocationScope allocations(state);
+  for (auto _ : state) {
+    out.clear();
+    auction::model::json::appendArray(out, lots, auction::model::json::appendLot);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LotPageWriteJson)->Arg(50)->Arg(1000);
+
+void BM_LotFromJson(benchmark::State& state) {
+  auction::bench::AllocationScope allocations(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(auction::model::lotFromJson(kLotPayload));
+  }
+}
+BENCHMARK(BM_LotFromJson);
+
+void BM_ApplyLotPatch(benchmark::State& state) {
+  const auto base = sampleLot();
+  const std::string patch = R"({"name":"Renamed lot","description":null,"auction_end_date":"2026-01-15 12:00:00+00"})";
+  auction::bench::AllocationScope allocations(state);
+  for (auto _ : state) {
+    auto lot = base;
+    auction::model::applyLotPatch(lot, patch);
+    benchmark::DoNotOptimize(lot);
+  }
+}
+BENCHMARK(BM_ApplyLotPatch);
+
+// Тело POST /lots/{id}/bid: прежний разбор через DOM против табличного декодера
+const std::string kBidPayload = R"({"amount":310.25,"bidder_id":"user-91d0e4"})";
+
+void BM_BidRequestDom(benchmark::State& state) {
+  auction::bench::AllocationScope allocations(state);
+  for (auto _ : state) {
+    const auto body = nlohmann::json::parse(kBidPayload);
+    auction::model::BidRequest request;
+    request.amount = auction::model::Money::fromMinorUnits(
+        std::llround(body.at("amount").get<double>() * auction::model::Money::kMinorPerUnit));
+    if (body.contains("bidder_id") && !body.at("bidder_id").is_null()) {
+      request.bidder_id = body.at("bidder_id").get<std::string>();
+    }
+    benchmark::DoNotOptimize(request);
+  }
+}
+BENCHMARK(BM_BidRequestDom);
+
+void BM_BidRequestFromJson(benchmark::State& state) {
+  auction::bench::AllocationScope allocations(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(auction::model::bidRequestFromJson(kBidPayload));
+  }
+}
+BENCHMARK(BM_BidRequestFromJson);
+
+void BM_ParseTimestamp(benchmark::State& state) {
+  const std::string value = "2025-12-31 18:00:00.123456+05:30";
+  auction::bench::AllocationScope allocations(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(auction::model::parseTimestamp(value));
+  }
+}
+BENCHMARK(BM_ParseTimestamp);
+
+void BM_FormatTimestamp(benchmark::State& state) {
+  const auto value = *auction::model::parseTimestamp("2025-11-02 09:15:30.123456+00");
+  std::string out;
+  auction::bench::AllocationScope allocations(state);
+  for (auto _ : state) {
+    out.clear();
+    auction::model::appendTimestamp(out, value);
+    benchmark::DoNotOptimize(out.data());
+  }
+}
+BENCHMARK(BM_FormatTimestamp);
+
+// Параметр NUMERIC: прежний std::to_string(double) против точной записи суммы
+void BM_MoneyToStringDouble(benchmark::State& state) {
+  const double value = 27550.25;
+  auction::bench::AllocationScope allocations(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::to_string(value));
+  }
+}
+BENCHMARK(BM_MoneyToStringDouble);
+
+void BM_MoneyToString(benchmark::State& state) {
+  const auto value = auction::model::Money::fromMinorUnits(2755025);
+  auction::bench::AllocationScope allocations(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(value.toString());
+  }
+}
+BENCHMARK(BM_MoneyToString);
+
+}  // namespace
@@ -0,0 +1,110 @@
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <libpq-fe.h>
+
+#include "alloc_counter.h"
+#include "auction/repository/lot_repository.h"
+
+namespace {
+
+using ResultPtr = std::unique_ptr<PGresult, decltype(&PQclear)>;
+
+// Бинарные представления значений, как их отдаёт сервер при resultFormat = 1
+std::string int4(std::int32_t value) {
+  const auto bits = static_cast<std::uint32_t>(value);
+  return {static_cast<char>(bits >> 24), static_cast<char>(bits >> 16), static_cast<char>(bits >> 8),
+          static_cast<char>(bits)};
+}
+
+std::string int8(std::int64_t value) {
+  const auto bits = static_cast<std::uint64_t>(value);
+  std::string out(8, '\0');
+  for (int i = 0; i < 8; ++i) {
+    out[static_cast<std::size_t>(i)] = static_cast<char>(bits >> (56 - 8 * i));
+  }
+  return out;
+}
+
+std::string int2(std::int16_t value) {
+  const auto bits = static_cast<std::uint16_t>(value);
+  return {static_cast<char>(bits >> 8), static_cast<char>(bits)};
+}
+
+// NUMERIC с двумя знаками после запятой: value в сотых
+std::string numeric(std::int64_t hundredths) {
+  std::vector<std::int16_t> digits;
+  auto integer = hundredths / 100;
+  const auto fraction = static_cast<std::int16_t>((hundredths % 100) * 100);
+  while (integer > 0) {
+    digits.insert(digits.begin(), static_cast<std::int16_t>(integer % 10000));
+    integer /= 10000;
+  }
+  const auto weight = static_cast<std::int16_t>(digits.size()) - 1;
+  digits.push_back(fraction);
+  std::string out = int2(static_cast<std::int16_t>(digits.size())) + int2(weight) + int2(0) + int2(2);
+  for (const auto digit : digits) {
+    out += int2(digit);
+  }
+  return out;
+}
+
+// Микросекунды от 2000-01-01 UTC
+std::string timestamptz(std::int64_t unixSeconds) { return int8((unixSeconds - 946684800LL) * 1000000LL); }
+
+ResultPtr makeLotResult(int rows) {
+  ResultPtr result(PQmakeEmptyPGresult(nullptr, PGRES_TUPLES_OK), &PQclear);
+  std::array<const char*, 8> names = {"id",       "name",       "description", "start_price",
+                                      "current_price", "owner_id", "created_at", "auction_end_date"};
+  std::array<PGresAttDesc, 8> attributes{};
+  for (std::size_t i = 0; i < names.size(); ++i) {
+    attributes[i].name = const_cast<char*>(names[i]);
+    attributes[i].format = 1;
+  }
+  if (PQsetResultAttrs(result.get(), static_cast<int>(attributes.size()), attributes.data()) == 0) {
+    throw std::runtime_error("PQsetResultAttrs failed");
+  }
+
+  for (int row = 0; row < rows; ++row) {
+    const std::array<std::string, 8> values = {
+        int4(row + 1),
+        "Vintage mechanical watch #" + std::to_string(row),
+        "Swiss movement, serviced in 2024, original box and papers",
+        numeric(15000),
+        numeric(27550 + row),
+        "user-7f3c2a",
+        timestamptz(1762074930),
+        timestamptz(1767204000),
+    };
+    for (std::size_t column = 0; column < values.size(); ++column) {
+      const auto& value = values[column];
+      if (PQsetvalue(result.get(), row, static_cast<int>(column), const_cast<char*>(value.data()),
+                     static_cast<int>(value.size())) == 0) {
+        throw std::runtime_error("PQsetvalue failed");
+      }
+    }
+  }
+  return result;
+}
+
+void BM_MapLot(benchmark::State& state) {
+  const int rows = static_cast<int>(state.range(0));
+  const auto result = makeLotResult(rows);
+  const auto columns = auction::repository::LotRepository::LotColumns::resolve(result.get());
+
+  auction::bench::AllocationScope allocations(state);
+  for (auto _ : state) {
+    for (int row = 0; row < rows; ++row) {
+      benchmark::DoNotOptimize(auction::repository::LotRepository::mapLot(result.get(), row, columns));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * rows);
+}
+BENCHMARK(BM_MapLot)->Arg(1)->Arg(50)->Arg(1000);
+
+}  // namespace
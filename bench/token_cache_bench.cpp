@@ -0,0 +1,75 @@
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "alloc_counter.h"
+#include "auction/core/token_cache.h"
+
+namespace {
+
+constexpr std::size_t kKeys = 4096;
+
+auction::core::TokenCache& sharedCache() {
+  static auction::core::TokenCache cache{auction::core::TokenCacheOptions{}};
+  return cache;
+}
+
+const std::vector<std::string>& keys() {
+  static const std::vector<std::string> values = [] {
+    std::vector<std::string> out;
+    out.reserve(kKeys);
+    for (std::size_t i = 0; i < kKeys; ++i) {
+      out.push_back("eyJhbGciOiJIUzI1NiJ9.token-" + std::to_string(i) + "::PlaceBid");
+    }
+    return out;
+  }();
+  return values;
+}
+
+void BM_TokenCacheGetHit(benchmark::State& state) {
+  auto& cache = sharedCache();
+  const auto& tokens = keys();
+  if (state.thread_index() == 0) {
+    for (const auto& token : tokens) {
+      cache.put(token, true);
+    }
+  }
+
+  std::size_t i = static_cast<std::size_t>(state.thread_index()) * 997;
+  auction::bench::AllocationScope allocations(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cache.get(tokens[i++ % kKeys]));
+  }
+}
+BENCHMARK(BM_TokenCacheGetHit)->ThreadRange(1, 16)->UseRealTime();
+
+void BM_TokenCachePut(benchmark::State& state) {
+  auto& cache = sharedCache();
+  const auto& tokens = keys();
+  std::size_t i = static_cast<std::size_t>(state.thread_index()) * 997;
+  auction::bench::AllocationScope allocations(state);
+  for (auto _ : state) {
+    cache.put(tokens[i++ % kKeys], true);
+  }
+}
+BENCHMARK(BM_TokenCachePut)->ThreadRange(1, 16)->UseRealTime();
+
+// Типичный профиль: 9 попаданий на одну запись
+void BM_TokenCacheMixed(benchmark::State& state) {
+  auto& cache = sharedCache();
+  const auto& tokens = keys();
+  std::size_t i = static_cast<std::size_t>(state.thread_index()) * 997;
+  auction::bench::AllocationScope allocations(state);
+  for (auto _ : state) {
+    const auto& token = tokens[i++ % kKeys];
+    if (i % 10 == 0) {
+      cache.put(token, true);
+    } else {
+      benchmark::DoNotOptimize(cache.get(token));
+    }
+  }
+}
+BENCHMARK(BM_TokenCacheMixed)->ThreadRange(1, 16)->UseRealTime();
+
+}  // namespace
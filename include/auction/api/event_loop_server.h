@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <httplib.h>
+
+#include "auction/api/http_parser.h"
+#include "auction/api/router.h"
+#include "auction/core/executor.h"
+#include "auction/core/task.h"
+
+namespace auction::api {
+
+struct EventLoopServerOptions {
+  // Потоки epoll: принимают соединения, читают, разбирают запросы и пишут ответы; 0 — по числу ядер
+  std::size_t loops{0};
+  // Потоки обычных обработчиков: они ходят в БД и платёжный сервис синхронно. 0 — как пул httplib,
+  // max(8, ядра - 1), чтобы бэкенды сравнивались при одинаковой параллельности обработчиков
+  std::size_t workers{0};
+  // Простой keep-alive соединения, а также недописанный запрос или непрочитанный ответ
+  std::chrono::milliseconds idleTimeout{5000};
+  // Сколько после stop() дообслуживать начатые запросы, прежде чем закрыть оставшиеся соединения
+  std::chrono::milliseconds drainTimeout{10000};
+  // Сколько разобранных запросов одного соединения ждут очереди; дальше сокет не читается
+  std::size_t maxPipelined{16};
+  // Сколько байт потокового ответа (GET /lots) может ждать отправки, прежде чем обработчик приостановится
+  std::size_t streamBufferBytes{256 * 1024};
+  // SO_REUSEPORT: порт делят несколько процессов, ядро распределяет между ними соединения
+  bool reusePort{false};
+  HttpLimits limits;
+
+  // HTTP_SERVER_LOOPS, HTTP_SERVER_WORKERS, HTTP_SERVER_IDLE_TIMEOUT_MS, HTTP_SERVER_MAX_PIPELINED,
+  // HTTP_SERVER_MAX_BODY_BYTES, HTTP_SERVER_DRAIN_TIMEOUT_MS
+  static EventLoopServerOptions fromEnvironment();
+};
+
+// HTTP/1.1-сервер на epoll — альтернатива httplib::Server, у которого на каждое keep-alive соединение
+// приходится поток пула. Здесь соединения, сколько бы их ни было, обслуживает фиксированный набор потоков:
+// по циклу событий на ядро (неблокирующие сокеты, инкрементальный разбор, pipelining, ответ одним
+// sendmsg с iovec) и пул обработчиков, в котором выполняются маршруты из той же таблицы Router.
+// Маршруты-корутины выполняются не в пуле, а в core::Executor: ожидающий БД запрос не держит поток.
+// Запросы одного соединения обрабатываются строго по очереди, ответы уходят в порядке запросов.
+class EventLoopServer {
+ public:
+  // executor должен пережить сервер
+  EventLoopServer(const Router& router, core::Executor& executor, EventLoopServerOptions options);
+  ~EventLoopServer();
+
+  EventLoopServer(const EventLoopServer&) = delete;
+  EventLoopServer& operator=(const EventLoopServer&) = delete;
+  EventLoopServer(EventLoopServer&&) = delete;
+  EventLoopServer& operator=(EventLoopServer&&) = delete;
+
+  // Блокирует до stop() и завершения начатых запросов; false, если не удалось открыть порт — как httplib::Server::listen
+  bool listen(const std::string& host, int port);
+  // Открыть порт, не запуская циклы, — как bind_to_port и listen_after_bind у httplib::Server
+  bool bind(const std::string& host, int port);
+  bool listenAfterBind();
+  void stop();
+
+ private:
+  class Loop;
+  class WorkerPool;
+
+  const Router& router_;
+  core::Executor& executor_;
+  EventLoopServerOptions options_;
+  std::atomic<bool> stopping_{false};
+  int listenFd_{-1};
+  // Циклы, ещё слушающие порт; последний остановившийся закрывает сокет
+  std::atomic<std::size_t> activeListeners_{0};
+  std::unique_ptr<WorkerPool> workers_;
+  std::vector<std::unique_ptr<Loop>> loops_;
+  // Незавершённые корутины обработчиков; циклы разбираются только после их завершения
+  std::mutex asyncMutex_;
+  std::condition_variable asyncDone_;
+  std::size_t asyncInFlight_{0};
+
+  // Выполняется в потоке пула: маршрут (nullptr — 404) и передача ответа обратно в цикл соединения
+  void handle(Loop& loop, std::uint64_t connection, const Router::Route* route, httplib::Request& request,
+              bool keepAlive);
+  // Маршрут-корутина: запускается в исполнителе, ответ передаётся в цикл так же, как из пула
+  void handleAsync(Loop& loop, std::uint64_t connection, const Router::Route& route,
+                   std::shared_ptr<httplib::Request> request, bool keepAlive);
+  core::Task<void> runAsync(Loop& loop, std::uint64_t connection, const Router::Route& route,
+                            std::shared_ptr<httplib::Request> request, bool keepAlive);
+  static void handlerFailed(const httplib::Request& request, httplib::Response& response,
+                            const std::exception_ptr& error);
+  void respond(Loop& loop, std::uint64_t connection, const httplib::Request& request, httplib::Response& response,
+               bool keepAlive);
+  void stream(Loop& loop, std::uint64_t connection, httplib::Response& response, bool close);
+  void closeListener();
+};
+
+}  // namespace auction::api
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+#include <httplib.h>
+
+namespace auction::api {
+
+struct HttpLimits {
+  // Строка запроса и заголовки вместе, как CPPHTTPLIB_HEADER_MAX_LENGTH
+  std::size_t maxHeaderBytes{8192};
+  std::size_t maxBodyBytes{8 * 1024 * 1024};
+};
+
+// Инкрементальный разбор запросов HTTP/1.1 из буфера соединения: данные можно подавать любыми порциями,
+// уже просмотренные заголовки повторно не сканируются. Тело — по Content-Length или chunked.
+// Несколько запросов подряд в одном буфере (pipelining) разбираются по одному: parse, take, снова parse.
+class HttpRequestParser {
+ public:
+  enum class Status { NeedMore, Complete, Error };
+
+  explicit HttpRequestParser(HttpLimits limits = {});
+
+  // Разбирает начало input; consumed — сколько байт поглощено и может быть выброшено из буфера
+  Status parse(std::string_view input, std::size_t& consumed);
+
+  // После Complete: готовый запрос; парсер переходит к следующему
+  httplib::Request take();
+
+  // Действительны после Complete, до take()
+  [[nodiscard]] bool keepAlive() const { return keepAlive_; }
+
+  // Однократно true, когда заголовки с "Expect: 100-continue" разобраны, а тела ещё нет
+  bool takeContinueRequest();
+
+  // Статус ответа после Error: 400, 413, 431, 501 или 505
+  [[nodiscard]] int errorStatus() const { return errorStatus_; }
+
+ private:
+  enum class Stage { Head, Body, ChunkSize, ChunkData, ChunkDataEnd, Trailer, Done, Failed };
+
+  HttpLimits limits_;
+  Stage stage_{Stage::Head};
+  httplib::Request request_;
+  // С какого места продолжать поиск конца заголовков
+  std::size_t scanFrom_{0};
+  std::size_t remaining_{0};
+  bool keepAlive_{true};
+  bool expectContinue_{false};
+  int errorStatus_{0};
+
+  bool parseHead(std::string_view head);
+  Status fail(int status);
+};
+
+}  // namespace auction::api
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <functional>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <httplib.h>
+
+#include "auction/core/executor.h"
+#include "auction/core/task.h"
+
+namespace auction::api {
+
+// Таблица маршрутов, общая для обоих HTTP-бэкендов: registerRoutes заполняет её один раз,
+// затем она монтируется в httplib::Server или обслуживается EventLoopServer.
+// Обработчики работают с httplib::Request/Response независимо от того, кто принял соединение.
+// Обработчик — обычная функция или корутина (*Async): корутины выполняются в core::Executor и,
+// ожидая БД или платёжный сервис, не занимают поток.
+class Router {
+ public:
+  using Handler = httplib::Server::Handler;
+  // Request и Response живут до завершения корутины
+  using AsyncHandler = std::function<core::Task<void>(const httplib::Request&, httplib::Response&)>;
+
+  struct Route {
+    std::string method;
+    std::string pattern;
+    std::regex regex;
+    // Задан ровно один из двух
+    Handler handler;
+    AsyncHandler asyncHandler;
+  };
+
+  Router& get(const std::string& pattern, Handler handler);
+  Router& post(const std::string& pattern, Handler handler);
+  Router& put(const std::string& pattern, Handler handler);
+  Router& del(const std::string& pattern, Handler handler);
+  Router& options(const std::string& pattern, Handler handler);
+
+  // Перегрузить get/post не получится: лямбда, возвращающая Task, подходит и под Handler
+  Router& getAsync(const std::string& pattern, AsyncHandler handler);
+  Router& postAsync(const std::string& pattern, AsyncHandler handler);
+  Router& putAsync(const std::string& pattern, AsyncHandler handler);
+  Router& delAsync(const std::string& pattern, AsyncHandler handler);
+
+  // У httplib на соединение свой поток: он ждёт корутину, выполняющуюся в executor
+  void mount(httplib::Server& server, core::Executor& executor) const;
+
+  // Как в httplib: первый маршрут в порядке регистрации, у которого совпали метод и шаблон пути;
+  // заполняет req.matches, HEAD обслуживается GET-маршрутами. nullptr — подходящего маршрута нет.
+  const Route* match(httplib::Request& req) const;
+
+ private:
+  std::vector<Route> routes_;
+
+  Router& add(const char* method, const std::string& pattern, Handler handler, AsyncHandler asyncHandler);
+};
+
+}  // namespace auction::api
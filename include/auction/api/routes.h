@@ -1,17 +1,24 @@
 #pragma once
 
+#include <cstddef>
+#include <optional>
 #include <vector>
 
-#include <httplib.h>
-
+#include "auction/api/router.h"
 #include "auction/core/auth_service.h"
+#include "auction/core/database.h"
 #include "auction/core/service_registry.h"
 #include "auction/service/lot_service.h"
 
 namespace auction::api {
 
-std::vector<core::ApiMethod> registerRoutes(httplib::Server& server, service::LotService& lotService,
-                                            core::AuthService& authService);
+// Методы для сервис-реестра; не зависят от сервисов, поэтому доступны и без registerRoutes
+std::vector<core::ApiMethod> apiMethods();
+
+// worker — номер рабочего процесса при SERVER_PROCESSES > 1, попадает в ответ /health
+std::vector<core::ApiMethod> registerRoutes(Router& router, service::LotService& lotService,
+                                            core::AuthService& authService, const core::Database& database,
+                                            std::optional<std::size_t> worker = std::nullopt);
 
 }  // namespace auction::api
 
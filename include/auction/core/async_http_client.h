@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <curl/curl.h>
+#include <nlohmann/json.hpp>
+
+#include "auction/core/executor.h"
+#include "auction/core/http_client.h"
+
+namespace auction::core {
+
+struct HttpRequestOptions {
+  std::vector<std::string> headers;
+  // Абсолютный срок; если не задан, действует totalTimeout клиента
+  std::optional<std::chrono::steady_clock::time_point> deadline;
+};
+
+// Асинхронный HTTP-клиент: все передачи ведёт один поток событий поверх curl_multi.
+// Вызывающий поток только ставит запрос в очередь и не ждёт сеть.
+// Колбэки завершения выполняются в потоке событий, поэтому должны быть короткими и не блокироваться.
+// Требует предварительного curl_global_init.
+class AsyncHttpClient {
+ public:
+  using RequestId = std::uint64_t;
+  // error == nullptr при успешной передаче (любой HTTP-статус)
+  using Completion = std::function<void(std::exception_ptr error, HttpResponse response)>;
+
+  AsyncHttpClient();
+  explicit AsyncHttpClient(HttpClientOptions options);
+  ~AsyncHttpClient();
+
+  AsyncHttpClient(const AsyncHttpClient&) = delete;
+  AsyncHttpClient& operator=(const AsyncHttpClient&) = delete;
+  AsyncHttpClient(AsyncHttpClient&&) = delete;
+  AsyncHttpClient& operator=(AsyncHttpClient&&) = delete;
+
+  RequestId postJson(const std::string& url, const nlohmann::json& payload, Completion onDone,
+                     HttpRequestOptions options = {});
+  std::future<HttpResponse> postJson(const std::string& url, const nlohmann::json& payload,
+                                     HttpRequestOptions options = {});
+  // Для корутин: пока идёт запрос, поток исполнителя обслуживает другие корутины
+  Task<HttpResponse> postJsonTask(std::string url, nlohmann::json payload, HttpRequestOptions options = {});
+
+  // Прервать запрос; колбэк получит исключение. Ничего не делает, если запрос уже завершён.
+  void cancel(RequestId id);
+
+ private:
+  struct HeaderListDeleter {
+    void operator()(curl_slist* list) const { curl_slist_free_all(list); }
+  };
+
+  struct Transfer {
+    RequestId id{0};
+    std::string url;
+    std::string body;
+    std::unique_ptr<curl_slist, HeaderListDeleter> headers;
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    std::string responseBody;
+    Completion onDone;
+    CURL* handle{nullptr};
+  };
+
+  HttpClientOptions options_;
+  CURLM* multi_{nullptr};
+
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<Transfer>> submitted_;
+  std::vector<RequestId> cancelled_;
+  RequestId nextId_{1};
+  bool stopping_{false};
+
+  // Доступно только потоку событий
+  std::unordered_map<RequestId, std::unique_ptr<Transfer>> active_;
+  std::vector<CURL*> idleHandles_;
+
+  std::thread loop_;
+
+  void run();
+  void start(std::unique_ptr<Transfer> transfer);
+  void finish(RequestId id, std::exception_ptr error);
+  void releaseHandle(CURL* handle);
+};
+
+}  // namespace auction::core
@@ -1,25 +1,46 @@
 #pragma once
 
+#include <future>
 #include <string>
 
 #include <nlohmann/json.hpp>
 
-#include "auction/core/http_client.h"
+#include "auction/core/async_http_client.h"
+#include "auction/core/executor.h"
+#include "auction/core/metrics.h"
+#include "auction/core/single_flight.h"
 #include "auction/core/token_cache.h"
 
 namespace auction::core {
 
 class AuthService {
  public:
-  explicit AuthService(TokenCache& cache);
+  AuthService(TokenCache& cache, AsyncHttpClient& httpClient);
 
   bool verifyToken(const std::string& token, const std::string& methodName);
+  // Не блокирует вызывающий поток на время запроса к платёжному сервису
+  std::shared_future<bool> verifyTokenAsync(const std::string& token, const std::string& methodName);
+  // Для корутин: ожидание ответа не занимает поток исполнителя
+  Task<bool> verifyTokenTask(std::string token, std::string methodName);
+  [[nodiscard]] TokenCacheStats cacheStats() const { return cache_.stats(); }
 
  private:
+  using VerifyFlight = SingleFlight<std::string, bool>;
+
   std::string verifyUrl_;
   std::string serviceName_;
   TokenCache& cache_;
-  HttpClient httpClient_;
+  AsyncHttpClient& httpClient_;
+  metrics::Histogram& paymentLatency_;
+  metrics::Counter& paymentTransportErrors_;
+  metrics::Counter& paymentStatusErrors_;
+  // Одновременные проверки одного token::method делят один запрос к платёжному сервису
+  VerifyFlight inflight_;
+
+  // Запрос к платёжному сервису от первого из одновременных проверяющих
+  void requestCheck(const std::string& token, const std::string& methodName, const std::string& cacheKey,
+                    const VerifyFlight::Done& done);
+  bool handleVerifyResponse(const std::string& cacheKey, const HttpResponse& response);
 
   static std::string resolveBaseUrl();
   static std::string resolveServiceName();
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "auction/core/task.h"
+
+namespace auction::core {
+
+// Очерёдность в очереди ограничителя: high обслуживается первой, low при перегрузке отклоняется сразу
+enum class Priority { high, normal, low };
+
+// Запрос отклонён ограничителем: БД перегружена. retryAfter — через сколько имеет смысл повторить
+class Overloaded : public std::runtime_error {
+ public:
+  Overloaded(const std::string& message, std::chrono::seconds retryAfter)
+      : std::runtime_error(message), retryAfter_(retryAfter) {}
+
+  [[nodiscard]] std::chrono::seconds retryAfter() const { return retryAfter_; }
+
+ private:
+  std::chrono::seconds retryAfter_;
+};
+
+struct LimiterOptions {
+  // Начальный лимит; 0 — минимальный. Database подставляет DB_POOL_MAX
+  std::size_t initialLimit{0};
+  std::size_t minLimit{1};
+  // 0 — Database подставляет DB_POOL_MAX. Разрешения сверх числа соединений ждали бы в общей FIFO-очереди
+  // пула, мимо приоритетов и CoDel, поэтому больший предел — только явным DB_LIMIT_MAX
+  std::size_t maxLimit{0};
+  // CoDel: если за interval задержка в очереди ни разу не опускалась ниже target, очередь стоячая —
+  // ждать в ней разрешается не дольше target, иначе не дольше interval
+  std::chrono::milliseconds queueTarget{10};
+  std::chrono::milliseconds queueInterval{100};
+  std::size_t maxQueue{1024};
+
+  // DB_LIMIT_MIN, DB_LIMIT_MAX, DB_QUEUE_TARGET_MS, DB_QUEUE_INTERVAL_MS, DB_QUEUE_MAX
+  static LimiterOptions fromEnvironment();
+};
+
+struct LimiterStats {
+  std::size_t limit{0};
+  std::size_t inFlight{0};
+  std::size_t queued{0};
+  bool overloaded{false};
+  std::uint64_t admitted{0};
+  std::uint64_t rejected{0};
+  std::chrono::microseconds shortLatency{0};
+  std::chrono::microseconds longLatency{0};
+};
+
+// Адаптивный ограничитель одновременных обращений к БД (градиентный, как Gradient2 у Netflix).
+// Лимит следует за задержкой: пока средняя задержка последнего окна близка к долгосрочной, он растёт
+// на sqrt(limit), когда задержка растёт (БД не справляется) — уменьшается пропорционально. Запросы сверх
+// лимита ждут в очереди по приоритетам; ждать дольше, чем позволяет CoDel, они не будут — получат Overloaded.
+class ConcurrencyLimiter {
+ private:
+  struct Waiter;
+
+ public:
+  // Разрешение на одно обращение; освобождается в деструкторе. Задержка учитывается в лимите,
+  // только если вызван succeeded(): ошибки не говорят о том, насколько загружена БД
+  class Permit {
+   public:
+    Permit() = default;
+    Permit(ConcurrencyLimiter* limiter, std::chrono::steady_clock::time_point start);
+    ~Permit();
+
+    Permit(const Permit&) = delete;
+    Permit& operator=(const Permit&) = delete;
+    Permit(Permit&& other) noexcept;
+    Permit& operator=(Permit&& other) noexcept;
+
+    void succeeded() { succeeded_ = true; }
+
+   private:
+    ConcurrencyLimiter* limiter_{nullptr};
+    std::chrono::steady_clock::time_point start_;
+    bool succeeded_{false};
+
+    void release();
+  };
+
+  explicit ConcurrencyLimiter(LimiterOptions options);
+
+  ConcurrencyLimiter(const ConcurrencyLimiter&) = delete;
+  ConcurrencyLimiter& operator=(const ConcurrencyLimiter&) = delete;
+  ConcurrencyLimiter(ConcurrencyLimiter&&) = delete;
+  ConcurrencyLimiter& operator=(ConcurrencyLimiter&&) = delete;
+
+  // Блокирует поток, пока не освободится место; Overloaded, если ждать нельзя или слишком долго
+  Permit acquire(Priority priority);
+  // Для корутин: ожидание не занимает поток исполнителя
+  Task<Permit> acquireTask(Priority priority);
+
+  [[nodiscard]] LimiterStats stats() const;
+
+ private:
+  enum class WaiterState { waiting, granted, rejected };
+
+  struct Waiter {
+    std::chrono::steady_clock::time_point enqueued;
+    WaiterState state{WaiterState::waiting};
+    // Только у корутин; потоки ждут на available_
+    std::function<void(std::exception_ptr, std::chrono::steady_clock::time_point)> resume;
+  };
+
+  using Clock = std::chrono::steady_clock;
+  using WakeList = std::vector<std::shared_ptr<Waiter>>;
+
+  LimiterOptions options_;
+  std::chrono::seconds retryAfter_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable available_;
+  double limit_{0};
+  std::size_t inFlight_{0};
+  std::array<std::deque<std::shared_ptr<Waiter>>, 3> queues_;
+  std::size_t queued_{0};
+  std::uint64_t admitted_{0};
+  std::uint64_t rejected_{0};
+
+  // Окно измерения задержки
+  Clock::time_point windowStart_;
+  Clock::duration windowSum_{0};
+  std::size_t windowSamples_{0};
+  std::size_t windowMaxInFlight_{0};
+  double shortLatency_{0};
+  double longLatency_{0};
+
+  // CoDel: минимальная задержка в очереди за текущий интервал
+  Clock::time_point intervalStart_;
+  Clock::duration intervalMinDelay_{Clock::duration::max()};
+  bool overloaded_{false};
+  Clock::time_point lastOverloadLog_;
+
+  [[nodiscard]] std::size_t currentLimitLocked() const;
+  [[nodiscard]] bool canAdmitLocked() const;
+  void admitLocked(Clock::time_point now);
+  [[nodiscard]] Clock::duration allowedDelayLocked() const;
+  // Встать в очередь; nullptr — в очередь не берут, запрос отклонён
+  std::shared_ptr<Waiter> enqueueLocked(Priority priority, Clock::time_point now);
+  void removeLocked(const std::shared_ptr<Waiter>& waiter);
+  // Ждущий не дождался места за отведённое время
+  void expireLocked(const std::shared_ptr<Waiter>& waiter, Clock::time_point now);
+  void recordDelayLocked(Clock::duration delay, Clock::time_point now);
+  void recordLatencyLocked(Clock::duration latency, Clock::time_point now);
+  // Раздать освободившиеся места ждущим; корутины, которых нужно возобновить, попадают в woken
+  void drainLocked(Clock::time_point now, WakeList& woken);
+  void wake(WakeList& woken, Clock::time_point now);
+  void waitAsync(Priority priority,
+                 std::function<void(std::exception_ptr, std::chrono::steady_clock::time_point)> resume);
+  void release(Clock::time_point start, bool succeeded);
+  [[nodiscard]] Overloaded overloaded() const;
+};
+
+}  // namespace auction::core
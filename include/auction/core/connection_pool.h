@@ -0,0 +1,154 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <libpq-fe.h>
+
+#include "auction/core/task.h"
+
+namespace auction::core {
+
+struct PoolOptions {
+  std::size_t minConnections{1};
+  std::size_t maxConnections{8};
+  std::chrono::milliseconds checkoutTimeout{5000};
+  std::chrono::seconds idleTimeout{300};
+  // Простаивающие дольше этого соединения проверяются фоном, а не перед каждым запросом
+  std::chrono::seconds healthCheckIdle{30};
+
+  // DB_POOL_MIN, DB_POOL_MAX, DB_POOL_CHECKOUT_TIMEOUT_MS, DB_POOL_IDLE_TIMEOUT_S, DB_POOL_HEALTHCHECK_IDLE_S
+  static PoolOptions fromEnvironment();
+};
+
+struct PoolStats {
+  std::size_t total{0};
+  std::size_t idle{0};
+  std::size_t inUse{0};
+  std::size_t waiters{0};
+  std::uint64_t checkouts{0};
+  std::uint64_t timeouts{0};
+  std::uint64_t brokenDetected{0};
+  std::chrono::microseconds totalWait{0};
+  std::chrono::microseconds maxWait{0};
+};
+
+class ConnectionPool {
+ private:
+  struct Connection {
+    PGconn* handle{nullptr};
+    std::unordered_set<std::string> prepared;
+    std::chrono::steady_clock::time_point lastUsed;
+    std::chrono::steady_clock::time_point lastChecked;
+
+    ~Connection();
+  };
+
+ public:
+  // Соединение, выданное из пула; возвращается в пул в деструкторе.
+  class Lease {
+   public:
+    Lease() = default;
+    Lease(ConnectionPool* pool, std::unique_ptr<Connection> connection);
+    ~Lease();
+
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+    Lease(Lease&& other) noexcept;
+    Lease& operator=(Lease&& other) noexcept;
+
+    [[nodiscard]] PGconn* get() const { return connection_->handle; }
+
+    [[nodiscard]] bool isPrepared(const std::string& name) const;
+    void markPrepared(const std::string& name);
+
+    // Закрыть текущее соединение и открыть новое (prepared statements сбрасываются)
+    void reconnect();
+    // То же для корутин: подключение и паузы между попытками не занимают поток исполнителя
+    Task<void> reconnectTask();
+    // Закрыть соединение; при возврате оно будет выброшено из пула
+    void discard();
+
+   private:
+    ConnectionPool* pool_{nullptr};
+    std::unique_ptr<Connection> connection_;
+
+    void release();
+  };
+
+  ConnectionPool(std::string connectionString, PoolOptions options);
+  ~ConnectionPool();
+
+  ConnectionPool(const ConnectionPool&) = delete;
+  ConnectionPool& operator=(const ConnectionPool&) = delete;
+  ConnectionPool(ConnectionPool&&) = delete;
+  ConnectionPool& operator=(ConnectionPool&&) = delete;
+
+  Lease acquire();
+  // Для корутин: пока свободных соединений нет, корутина ждёт возврата, не занимая поток исполнителя.
+  // Новое соединение, если пул не заполнен, открывается через PQconnectPoll по готовности сокета
+  Task<Lease> acquireTask();
+  [[nodiscard]] PoolStats stats() const;
+  [[nodiscard]] const PoolOptions& options() const { return options_; }
+  void recordBroken();
+
+ private:
+  std::string connectionString_;
+  PoolOptions options_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable available_;
+  std::vector<std::unique_ptr<Connection>> idle_;
+  std::size_t total_{0};
+  std::size_t waiters_{0};
+  std::uint64_t checkouts_{0};
+  std::uint64_t timeouts_{0};
+  std::uint64_t brokenDetected_{0};
+  std::chrono::microseconds totalWait_{0};
+  std::chrono::microseconds maxWait_{0};
+
+  // Корутина из acquireTask, ждущая соединение. resume получает соединение или nullptr, если
+  // соединение закрылось и освободилось место под новое
+  struct AsyncWaiter {
+    std::function<void(std::exception_ptr, std::unique_ptr<Connection>)> resume;
+    bool settled{false};
+  };
+  std::deque<std::shared_ptr<AsyncWaiter>> asyncWaiters_;
+  // Когда ждут и потоки, и корутины, возвращённые соединения достаются им по очереди
+  bool preferAsync_{false};
+
+  bool stopping_{false};
+  std::condition_variable maintenanceWakeup_;
+  std::thread maintenance_;
+
+  std::unique_ptr<Connection> open() const;
+  std::unique_ptr<Connection> openWithRetry() const;
+  // Неблокирующие варианты для потоков исполнителя
+  Task<std::unique_ptr<Connection>> openTask() const;
+  Task<std::unique_ptr<Connection>> openWithRetryTask() const;
+  // Проверяет, что подключение удалось; иначе бросает с текстом ошибки libpq
+  static std::unique_ptr<Connection> opened(std::unique_ptr<Connection> connection);
+  void giveBack(std::unique_ptr<Connection> connection);
+  // Следующая ждущая корутина, если освободившееся соединение или место положено ей; под mutex_
+  std::shared_ptr<AsyncWaiter> takeAsyncWaiterLocked();
+  void waitAsync(std::chrono::milliseconds timeout,
+                 std::function<void(std::exception_ptr, std::unique_ptr<Connection>)> resume);
+  void runMaintenance();
+  void reapIdleLocked(std::vector<std::unique_ptr<Connection>>& expired);
+  void checkIdleConnections(std::unique_lock<std::mutex>& lock);
+  void replenish(std::unique_lock<std::mutex>& lock);
+  void returnIdleLocked(std::unique_ptr<Connection> connection);
+};
+
+}  // namespace auction::core
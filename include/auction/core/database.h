@@ -1,18 +1,49 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <libpq-fe.h>
 
+#include "auction/core/concurrency_limiter.h"
+#include "auction/core/connection_pool.h"
+#include "auction/core/metrics.h"
+#include "auction/core/pg_listener.h"
+#include "auction/core/task.h"
+
 namespace auction::core {
 
+struct StatementOptions {
+  // Идемпотентные statements повторяются один раз на свежем соединении, если старое оказалось разорвано
+  bool idempotent{false};
+  // Запрашивать результаты в бинарном формате (resultFormat = 1), см. pg_binary.h
+  bool binaryResults{false};
+  // Очерёдность в ограничителе нагрузки: ставки — high, списки — low
+  Priority priority{Priority::normal};
+};
+
+// Первый шаг пакета DDL в ensureSchema репозиториев: транзакционная advisory-блокировка с общим ключом.
+// Рабочие процессы SERVER_PROCESSES создают схему по очереди, блокировка снимается с коммитом пакета
+inline constexpr const char* kSchemaLockSql = "SELECT pg_advisory_xact_lock(4207301)";
+
+// Шаг pipeline: prepared statement по имени или произвольный SQL
+struct PipelineStep {
+  std::string statement;
+  std::vector<std::optional<std::string>> params;
+  bool prepared{true};
+  // Для SQL-шагов; у prepared statements берётся из регистрации
+  bool idempotent{false};
+};
+
 class Database {
  public:
   using ResultPtr = std::unique_ptr<PGresult, decltype(&PQclear)>;
+  class RowStream;
 
   Database();
   ~Database();
@@ -22,24 +53,99 @@ class Database {
   Database(Database&&) = delete;
   Database& operator=(Database&&) = delete;
 
-  ResultPtr query(const std::string& sql, const std::vector<std::optional<std::string>>& params = {});
-  void prepare(const std::string& name, const std::string& sql);
+  ResultPtr query(const std::string& sql, const std::vector<std::optional<std::string>>& params = {},
+                  StatementOptions options = {});
+  // Регистрирует statement; на каждом соединении пула он подготавливается при первом использовании
+  void prepare(const std::string& name, const std::string& sql, StatementOptions options = {});
   ResultPtr executePrepared(const std::string& name, const std::vector<std::optional<std::string>>& params = {});
-  
-  // Проверить, был ли reconnect (prepared statements нужно пересоздать)
-  bool checkAndClearReconnectFlag();
+  // Для корутин: запрос уходит через PQsendQueryPrepared, ответ читается по готовности сокета, поток
+  // исполнителя в это время свободен. Повтор после разрыва — как у executePrepared
+  Task<ResultPtr> executePreparedTask(std::string name, std::vector<std::optional<std::string>> params = {});
+  // Отправляет все шаги одним пакетом в pipeline mode и возвращает результаты в том же порядке.
+  // Шаги выполняются в одной неявной транзакции: ошибка любого шага откатывает весь пакет.
+  std::vector<ResultPtr> executePipeline(const std::vector<PipelineStep>& steps);
+  // Построчная выдача результата (PQsetSingleRowMode), см. RowStream. Разрешение ограничителя и соединение
+  // берутся здесь, до ответа клиенту: отказ по перегрузке ещё можно вернуть кодом 503
+  Task<RowStream> openStreamTask(std::string name, std::vector<std::optional<std::string>> params = {});
+  // COPY ... FROM STDIN: data — строки в текстовом формате COPY. Не повторяется после разрыва соединения.
+  void copyIn(const std::string& copySql, const std::string& data);
+
+  // Подписка на NOTIFY канала по отдельному соединению с теми же параметрами, что у пула
+  std::unique_ptr<PgListener> listen(std::string channel, PgListener::NotifyHandler onNotify,
+                                     PgListener::StateHandler onState) const;
+
+  [[nodiscard]] PoolStats poolStats() const;
+  [[nodiscard]] LimiterStats limiterStats() const;
 
  private:
-  PGconn* connection_{nullptr};
-  std::mutex mutex_;
-  std::string connectionString_;
-  bool needReconnect_{false};
+  struct Statement {
+    std::string sql;
+    StatementOptions options;
+    metrics::Histogram* latency{nullptr};
+  };
+
+  std::unique_ptr<ConnectionPool> pool_;
+  // Перед пулом: лишние запросы ждут здесь по приоритетам или сразу получают Overloaded
+  std::unique_ptr<ConcurrencyLimiter> limiter_;
+  metrics::Histogram& queryLatency_;
+  metrics::Histogram& pipelineLatency_;
+  metrics::Histogram& copyLatency_;
+  mutable std::mutex statementsMutex_;
+  std::unordered_map<std::string, Statement> statements_;
 
   static ResultPtr makeResult(PGresult* result);
   static std::string buildConnectionString();
-  void ensureConnected();
-  void reconnect();
+  static void ensureConnected(ConnectionPool::Lease& connection);
+  static Task<void> ensureConnectedTask(ConnectionPool::Lease& connection);
+  static bool isConnectionFailure(PGconn* connection, PGresult* result);
+  Statement lookup(const std::string& name) const;
+  // nullptr при успехе, иначе результат с ошибкой PQprepare
+  static PGresult* ensurePrepared(ConnectionPool::Lease& connection, const std::string& name,
+                                  const Statement& statement);
+
+  // nullptr при успехе, иначе результат с первой ошибкой
+  static PGresult* runPipeline(ConnectionPool::Lease& connection, const std::vector<PipelineStep>& steps,
+                               const std::vector<std::optional<Statement>>& statements,
+                               std::vector<ResultPtr>& results);
+
+  // Результат попытки: успешный результат, исключение или пустой указатель — соединение разорвано,
+  // идемпотентный statement нужно повторить на переоткрытом соединении (reconnect/reconnectTask)
+  ResultPtr settle(const char* what, bool idempotent, int attempt, ConnectionPool::Lease& connection,
+                   PGresult* rawResult);
+  // Неблокирующий обмен из корутины: send отправляет запрос (PQsend*), затем ожидаются результаты.
+  // nullptr — ошибка отправки или соединения, текст в PQerrorMessage
+  static Task<PGresult*> exchange(ConnectionPool::Lease& connection, const std::function<int(PGconn*)>& send);
+  static Task<PGresult*> ensurePreparedTask(ConnectionPool::Lease& connection, const std::string& name,
+                                            const Statement& statement);
+
+  template <typename Exec>
+  ResultPtr run(const char* what, bool idempotent, Priority priority, Exec&& exec);
 };
 
-}  // namespace auction::core
+// Открытый потоковый запрос: держит разрешение ограничителя и соединение до конца чтения
+class Database::RowStream {
+ public:
+  RowStream(RowStream&&) noexcept = default;
+  RowStream& operator=(RowStream&&) noexcept = default;
+
+  // onRow получает результат ровно с одной строкой. Если onRow вернул false, запрос отменяется.
+  // Повтора после разрыва соединения нет; читать можно один раз
+  void read(const std::function<bool(const PGresult*)>& onRow);
+
+ private:
+  friend class Database;
+
+  RowStream(Database& database, std::string name, Statement statement,
+            std::vector<std::optional<std::string>> params, ConcurrencyLimiter::Permit permit,
+            ConnectionPool::Lease connection);
 
+  Database* database_;
+  std::string name_;
+  Statement statement_;
+  std::vector<std::optional<std::string>> params_;
+  ConcurrencyLimiter::Permit permit_;
+  ConnectionPool::Lease connection_;
+  bool consumed_{false};
+};
+
+}  // namespace auction::core
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+namespace auction::core {
+
+// Значение переменной окружения; пустая строка считается отсутствующей
+std::optional<std::string> readEnv(const char* key);
+
+// Неотрицательное целое из окружения; при отсутствии или ошибке разбора — fallback
+std::size_t envSize(const char* key, std::size_t fallback);
+
+}  // namespace auction::core
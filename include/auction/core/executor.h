@@ -0,0 +1,186 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "auction/core/task.h"
+
+namespace auction::core {
+
+struct ExecutorOptions {
+  // Потоки исполнителя; 0 — по числу ядер
+  std::size_t threads{0};
+
+  // EXECUTOR_THREADS
+  static ExecutorOptions fromEnvironment();
+};
+
+namespace detail {
+
+// Корневая корутина Executor::spawn: ей некого возобновлять, кадр освобождается сам по завершении
+struct Detached {
+  struct promise_type {
+    Detached get_return_object() noexcept {
+      return Detached{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    std::suspend_never final_suspend() const noexcept { return {}; }
+    void return_void() const noexcept {}
+    // Исключения перехватывает сама корутина (Executor::launch)
+    void unhandled_exception() const noexcept { std::terminate(); }
+  };
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+}  // namespace detail
+
+// Исполнитель корутин: по потоку на ядро, в каждом — свой epoll, очередь готовых корутин и таймеры.
+// Корутина, ждущая сокет (co_await readable/writable), таймер или колбэк (co_await callback),
+// не занимает поток: он в это время выполняет другие. Продолжается она в том же потоке, где уснула,
+// поэтому тысячи запросов, ждущих БД или платёжный сервис, обслуживаются несколькими потоками.
+// Внутри корутин нельзя блокироваться надолго — это останавливает все корутины потока.
+class Executor {
+ private:
+  class Thread;
+
+ public:
+  explicit Executor(ExecutorOptions options);
+  // Останавливает потоки; корутины, не успевшие завершиться, больше не возобновляются
+  ~Executor();
+
+  Executor(const Executor&) = delete;
+  Executor& operator=(const Executor&) = delete;
+  Executor(Executor&&) = delete;
+  Executor& operator=(Executor&&) = delete;
+
+  [[nodiscard]] std::size_t threads() const { return threads_.size(); }
+
+  // Запустить задачу в одном из потоков (по кругу). Исключение, вышедшее из задачи, пишется в лог
+  void spawn(Task<void> task);
+
+  // Запустить задачу и дождаться её результата. Для потоков вне исполнителя (пул httplib и т.п.):
+  // вызов из корутины заблокировал бы поток исполнителя
+  template <typename T>
+  T syncWait(Task<T> task);
+
+  // true, если вызывающий код выполняется в потоке какого-либо исполнителя
+  static bool inExecutorThread();
+
+  // co_await Executor::readable(fd): продолжить, когда fd станет доступен для чтения (или на нём ошибка)
+  class FdAwaiter {
+   public:
+    FdAwaiter(int fd, std::uint32_t events) : fd_(fd), events_(events) {}
+
+    [[nodiscard]] bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) const { watch(currentThread(), fd_, events_, handle); }
+    void await_resume() const noexcept {}
+
+   private:
+    int fd_;
+    std::uint32_t events_;
+  };
+
+  static FdAwaiter readable(int fd);
+  static FdAwaiter writable(int fd);
+  // Для PQflush: libpq просит ждать и чтения, и записи — сервер может ждать, пока мы прочитаем его ответ
+  static FdAwaiter readableOrWritable(int fd);
+
+  // Выполнить callback в текущем потоке исполнителя не раньше чем через delay. Отменить нельзя:
+  // callback сам проверяет, актуален ли он ещё
+  static void after(std::chrono::milliseconds delay, std::function<void()> callback);
+
+  // co_await Executor::callback<T>(start): start(done) запускает операцию с колбэком завершения,
+  // done(error, value) можно вызвать из любого потока, в том числе внутри start. Корутина продолжится
+  // в своём потоке исполнителя. start либо вызывает done ровно один раз, либо бросает исключение.
+  template <typename T, typename Start>
+  class CallbackAwaiter {
+   public:
+    explicit CallbackAwaiter(Start start) : start_(std::move(start)) {}
+
+    [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+      Thread& thread = currentThread();
+      start_([this, &thread, handle](std::exception_ptr error, T value) {
+        if (error) {
+          error_ = std::move(error);
+        } else {
+          value_.emplace(std::move(value));
+        }
+        resume(thread, handle);
+      });
+    }
+
+    T await_resume() {
+      if (error_) {
+        std::rethrow_exception(error_);
+      }
+      return std::move(*value_);
+    }
+
+   private:
+    Start start_;
+    std::exception_ptr error_;
+    std::optional<T> value_;
+  };
+
+  template <typename T, typename Start>
+  static CallbackAwaiter<T, Start> callback(Start start) {
+    return CallbackAwaiter<T, Start>{std::move(start)};
+  }
+
+ private:
+  std::vector<std::unique_ptr<Thread>> threads_;
+  std::atomic<std::size_t> next_{0};
+
+  static detail::Detached launch(Task<void> task);
+
+  // Поток исполнителя, в котором выполняется вызывающий код; logic_error вне исполнителя
+  static Thread& currentThread();
+  // Поставить корутину в очередь потока; можно вызывать из любого потока
+  static void resume(Thread& thread, std::coroutine_handle<> handle);
+  static void watch(Thread& thread, int fd, std::uint32_t events, std::coroutine_handle<> handle);
+
+  template <typename T>
+  static Task<void> settle(Task<T> task, std::promise<T> done);
+};
+
+template <typename T>
+Task<void> Executor::settle(Task<T> task, std::promise<T> done) {
+  try {
+    if constexpr (std::is_void_v<T>) {
+      co_await std::move(task);
+      done.set_value();
+    } else {
+      done.set_value(co_await std::move(task));
+    }
+  } catch (...) {
+    done.set_exception(std::current_exception());
+  }
+}
+
+template <typename T>
+T Executor::syncWait(Task<T> task) {
+  if (inExecutorThread()) {
+    throw std::logic_error("Executor::syncWait called from an executor thread");
+  }
+  std::promise<T> done;
+  auto result = done.get_future();
+  spawn(settle(std::move(task), std::move(done)));
+  return result.get();
+}
+
+}  // namespace auction::core
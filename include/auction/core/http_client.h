@@ -1,9 +1,8 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <string>
-#include <vector>
-
-#include <nlohmann/json.hpp>
 
 namespace auction::core {
 
@@ -12,11 +11,16 @@ struct HttpResponse {
   std::string body;
 };
 
-class HttpClient {
- public:
-  HttpResponse postJson(const std::string& url, const nlohmann::json& payload,
-                        const std::vector<std::string>& headers = {}) const;
+struct HttpClientOptions {
+  std::chrono::milliseconds connectTimeout{2000};
+  std::chrono::milliseconds totalTimeout{10000};
+  // Сколько простаивающих easy-хендлов держать для повторного использования
+  std::size_t maxIdleHandles{16};
+  // Разрешить HTTP/2 поверх TLS (согласуется через ALPN, иначе остаётся HTTP/1.1)
+  bool http2{true};
+
+  // HTTP_CONNECT_TIMEOUT_MS, HTTP_TIMEOUT_MS, HTTP_POOL_SIZE, HTTP_HTTP2=0|1
+  static HttpClientOptions fromEnvironment();
 };
 
 }  // namespace auction::core
-
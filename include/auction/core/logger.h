@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace auction::core {
+
+enum class LogLevel : int { Debug = 0, Info = 1, Warn = 2, Error = 3, Off = 4 };
+
+std::optional<LogLevel> parseLogLevel(std::string_view name);
+std::string_view logLevelName(LogLevel level);
+
+// Асинхронный логгер: каждая строка — JSON-объект.
+// Потоки складывают готовые строки в свои lock-free кольца (один писатель, один читатель),
+// фоновый поток забирает их пачками и пишет в stderr одним write.
+// При переполнении кольца запись отбрасывается, а не блокирует поток запроса.
+// Переживает fork: перед ним накопленное дописывается, в дочернем процессе фоновый поток запускается заново.
+class Logger {
+ public:
+  static Logger& instance();
+
+  Logger(const Logger&) = delete;
+  Logger& operator=(const Logger&) = delete;
+  Logger(Logger&&) = delete;
+  Logger& operator=(Logger&&) = delete;
+
+  [[nodiscard]] bool enabled(LogLevel level) const noexcept {
+    return static_cast<int>(level) >= level_.load(std::memory_order_relaxed);
+  }
+  [[nodiscard]] LogLevel level() const noexcept { return static_cast<LogLevel>(level_.load(std::memory_order_relaxed)); }
+  // Уровень можно менять на ходу; начальное значение берётся из LOG_LEVEL=debug|info|warn|error|off
+  void setLevel(LogLevel level) noexcept { level_.store(static_cast<int>(level), std::memory_order_relaxed); }
+
+  void submit(std::string line);
+  // Синхронно дописать всё накопленное (перед аварийным завершением)
+  void flush();
+  [[nodiscard]] std::uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Ring;
+
+  Logger();
+  ~Logger();
+
+  std::atomic<int> level_;
+  std::atomic<std::uint64_t> dropped_{0};
+
+  std::mutex ringsMutex_;
+  std::vector<std::shared_ptr<Ring>> rings_;
+
+  // Кольца читает только тот, кто держит drainMutex_
+  std::mutex drainMutex_;
+  std::uint64_t reportedDropped_{0};
+
+  std::mutex wakeupMutex_;
+  std::condition_variable wakeup_;
+  bool stopping_{false};
+  std::thread writer_;
+
+  Ring& localRing();
+  void run();
+  void drain();
+
+  // Обработчики pthread_atfork
+  static void prepareFork();
+  static void afterForkInParent();
+  static void afterForkInChild();
+};
+
+// Одна запись лога; отправляется в деструкторе. Создавать через макросы AUCTION_LOG_*,
+// тогда при выключенном уровне не вычисляются ни сообщение, ни поля.
+class LogRecord {
+ public:
+  LogRecord(LogLevel level, std::string_view message) : LogRecord(Logger::instance(), level, message) {}
+  LogRecord(Logger& logger, LogLevel level, std::string_view message);
+  ~LogRecord();
+
+  LogRecord(const LogRecord&) = delete;
+  LogRecord& operator=(const LogRecord&) = delete;
+  LogRecord(LogRecord&&) = delete;
+  LogRecord& operator=(LogRecord&&) = delete;
+
+  LogRecord& field(std::string_view key, std::string_view value);
+  LogRecord& field(std::string_view key, const char* value) { return field(key, std::string_view{value}); }
+  LogRecord& field(std::string_view key, const std::string& value) { return field(key, std::string_view{value}); }
+  LogRecord& field(std::string_view key, bool value);
+  LogRecord& field(std::string_view key, double value);
+  template <std::integral T>
+  LogRecord& field(std::string_view key, T value) {
+    appendKey(key);
+    line_ += std::to_string(value);
+    return *this;
+  }
+
+ private:
+  Logger& logger_;
+  std::string line_;
+
+  void appendKey(std::string_view key);
+};
+
+}  // namespace auction::core
+
+#define AUCTION_LOG(level, message)                          \
+  if (!::auction::core::Logger::instance().enabled(level)) { \
+  } else                                                     \
+    ::auction::core::LogRecord(level, message)
+
+#define AUCTION_LOG_DEBUG(message) AUCTION_LOG(::auction::core::LogLevel::Debug, message)
+#define AUCTION_LOG_INFO(message) AUCTION_LOG(::auction::core::LogLevel::Info, message)
+#define AUCTION_LOG_WARN(message) AUCTION_LOG(::auction::core::LogLevel::Warn, message)
+#define AUCTION_LOG_ERROR(message) AUCTION_LOG(::auction::core::LogLevel::Error, message)
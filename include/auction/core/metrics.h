@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace auction::core::metrics {
+
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+// Номер полосы для текущего потока: потоки пишут в разные кэш-линии и не толкаются на одном атомике
+std::size_t stripeIndex() noexcept;
+
+inline constexpr std::size_t kStripes = 16;
+
+struct alignas(64) StripedCell {
+  std::atomic<std::uint64_t> value{0};
+};
+
+class Counter {
+ public:
+  void inc(std::uint64_t amount = 1) noexcept {
+    cells_[stripeIndex()].value.fetch_add(amount, std::memory_order_relaxed);
+  }
+  [[nodiscard]] std::uint64_t value() const noexcept;
+
+ private:
+  std::array<StripedCell, kStripes> cells_;
+};
+
+class Gauge {
+ public:
+  void add(std::int64_t delta) noexcept {
+    cells_[stripeIndex()].value.fetch_add(static_cast<std::uint64_t>(delta), std::memory_order_relaxed);
+  }
+  [[nodiscard]] std::int64_t value() const noexcept;
+
+ private:
+  std::array<StripedCell, kStripes> cells_;
+};
+
+// Гистограмма длительностей в секундах; границы — верхние пределы корзин, +Inf добавляется сама
+class Histogram {
+ public:
+  struct Snapshot {
+    std::vector<std::uint64_t> cumulative;  // по границам, последним идёт +Inf
+    std::uint64_t count{0};
+    double sum{0.0};
+  };
+
+  explicit Histogram(std::vector<double> bounds);
+
+  void observe(double seconds) noexcept;
+  void observe(std::chrono::steady_clock::duration elapsed) noexcept {
+    observe(std::chrono::duration<double>(elapsed).count());
+  }
+  [[nodiscard]] const std::vector<double>& bounds() const noexcept { return bounds_; }
+  [[nodiscard]] Snapshot snapshot() const;
+
+ private:
+  std::vector<double> bounds_;
+  // Полоса: корзины (bounds + 1 для +Inf) и сумма в наносекундах, выровнено на кэш-линию
+  std::size_t stride_;
+  std::unique_ptr<StripedCell[]> cells_;
+};
+
+std::vector<double> defaultLatencyBuckets();
+
+// Наблюдает время жизни области в гистограмме
+class ScopedTimer {
+ public:
+  explicit ScopedTimer(Histogram& histogram) : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+  ~ScopedTimer() { histogram_.observe(std::chrono::steady_clock::now() - start_); }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+  ScopedTimer(ScopedTimer&&) = delete;
+  ScopedTimer& operator=(ScopedTimer&&) = delete;
+
+ private:
+  Histogram& histogram_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+// Реестр метрик процесса. Метрики создаются при старте (или при первой регистрации statement)
+// и живут до конца процесса; на горячем пути используются готовые ссылки, без поиска по имени.
+// render() собирает полосы всех метрик в текстовый формат Prometheus.
+class Registry {
+ public:
+  using Collector = std::function<void(std::string& out)>;
+
+  static Registry& instance();
+
+  Counter& counter(const std::string& name, const std::string& help, const Labels& labels = {});
+  Gauge& gauge(const std::string& name, const std::string& help, const Labels& labels = {});
+  Histogram& histogram(const std::string& name, const std::string& help, const Labels& labels = {},
+                       std::vector<double> bounds = defaultLatencyBuckets());
+  // Для значений, которые уже считаются в другом месте (статистика пула, кэша токенов)
+  void addCollector(Collector collector);
+  // Метки, которые render() добавляет к каждой серии, включая серии коллекторов. С SERVER_PROCESSES > 1
+  // это номер рабочего процесса: иначе при скрейпе через SO_REUSEPORT счётчики разных процессов слились бы
+  // в одну серию, прыгающую назад. Задаётся один раз до запуска потоков сервиса
+  void setConstantLabels(const Labels& labels);
+
+  [[nodiscard]] std::string render() const;
+
+ private:
+  enum class Type { Counter, Gauge, Histogram };
+
+  struct Series {
+    std::string labels;
+    std::unique_ptr<Counter> counter;
+    std::unique_ptr<Gauge> gauge;
+    std::unique_ptr<Histogram> histogram;
+  };
+
+  struct Family {
+    std::string help;
+    Type type;
+    std::vector<Series> series;
+  };
+
+  mutable std::mutex mutex_;
+  std::map<std::string, Family> families_;
+  std::vector<Collector> collectors_;
+
+  Series& series(const std::string& name, const std::string& help, Type type, const Labels& labels);
+};
+
+// Помощники для коллекторов
+void writeHeader(std::string& out, const std::string& name, const std::string& help, const char* type);
+void writeSample(std::string& out, const std::string& name, const Labels& labels, double value);
+
+}  // namespace auction::core::metrics
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace auction::core::pg {
+
+// Декодирование значений в бинарном формате протокола PostgreSQL (resultFormat = 1).
+// Все значения приходят в network byte order.
+
+using Timestamp = std::chrono::sys_time<std::chrono::microseconds>;
+
+std::int16_t readInt2(const char* data);
+std::int32_t readInt4(const char* data);
+std::int64_t readInt8(const char* data);
+
+// NUMERIC (ndigits, weight, sign, dscale и цифры по основанию 10000) как целое число единиц 10^-scale:
+// для NUMERIC(12,2) и scale = 2 — точная сумма в копейках. Лишние знаки округляются половиной от нуля.
+std::int64_t readNumericScaled(const char* data, int length, int scale);
+
+// TIMESTAMPTZ: микросекунды от 2000-01-01 00:00:00 UTC
+Timestamp readTimestamptz(const char* data);
+
+}  // namespace auction::core::pg
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <libpq-fe.h>
+
+namespace auction::core {
+
+// Отдельное соединение с PostgreSQL под LISTEN: в пул оно не входит, уведомления читает собственный поток.
+// Соединение держится всё время жизни объекта; при разрыве переподключается с растущей паузой.
+// Пока соединения нет, уведомления теряются — об этом сообщает onState(false), и подписчик должен
+// перестать доверять всему, что знал по уведомлениям. onState(true) приходит после каждого успешного LISTEN.
+// Колбэки вызываются в потоке слушателя и не должны блокироваться надолго.
+class PgListener {
+ public:
+  using NotifyHandler = std::function<void(const std::string& payload)>;
+  using StateHandler = std::function<void(bool listening)>;
+
+  PgListener(std::string connectionString, std::string channel, NotifyHandler onNotify, StateHandler onState);
+  ~PgListener();
+
+  PgListener(const PgListener&) = delete;
+  PgListener& operator=(const PgListener&) = delete;
+  PgListener(PgListener&&) = delete;
+  PgListener& operator=(PgListener&&) = delete;
+
+ private:
+  std::string connectionString_;
+  std::string channel_;
+  NotifyHandler onNotify_;
+  StateHandler onState_;
+
+  std::atomic<bool> stopping_{false};
+  // Будит poll при остановке
+  int wakeFd_{-1};
+  std::mutex mutex_;
+  std::condition_variable stopped_;
+  std::thread thread_;
+
+  void run();
+  // nullptr — подключиться или выполнить LISTEN не удалось
+  PGconn* connect();
+  // Читает уведомления, пока соединение живо; false — остановка
+  bool listen(PGconn* connection);
+  // Пауза перед переподключением; false — за время паузы пришла остановка
+  bool sleep(std::chrono::milliseconds delay);
+};
+
+}  // namespace auction::core
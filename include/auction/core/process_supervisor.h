@@ -0,0 +1,129 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace auction::core {
+
+struct SupervisorOptions {
+  // Число рабочих процессов; 0 и 1 — супервизора нет, сервис работает в одном процессе
+  std::size_t processes{0};
+  // Пауза перед перезапуском упавшего процесса; при падениях подряд удваивается, но не дольше минуты
+  std::chrono::milliseconds restartDelay{1000};
+  // Сколько при rolling restart ждать, пока новый процесс откроет порт
+  std::chrono::milliseconds readyTimeout{60000};
+  // Сколько ждать завершения процесса после SIGTERM, прежде чем послать SIGKILL
+  std::chrono::milliseconds shutdownTimeout{30000};
+
+  // SERVER_PROCESSES, SERVER_RESTART_DELAY_MS, SERVER_READY_TIMEOUT_MS, SERVER_SHUTDOWN_TIMEOUT_MS
+  static SupervisorOptions fromEnvironment();
+};
+
+// Что рабочий процесс знает о себе; передаётся в его точку входа
+class WorkerContext {
+ public:
+  WorkerContext(std::size_t slot, int readyFd) : slot_(slot), readyFd_(readyFd) {}
+
+  // Номер места, 0..processes-1; перезапущенный процесс получает место упавшего
+  [[nodiscard]] std::size_t slot() const { return slot_; }
+
+  // Порт открыт, процесс принимает соединения: при rolling restart старый процесс можно останавливать
+  void notifyReady();
+
+ private:
+  std::size_t slot_;
+  int readyFd_;
+};
+
+// Родительский процесс режима SERVER_PROCESSES > 1. Сам запросов не обслуживает: порождает fork'ом рабочие
+// процессы (каждый открывает порт с SO_REUSEPORT и строит свои пулы и кэши), перезапускает упавшие и
+// по SIGHUP по одному заменяет их новыми. SIGTERM и SIGINT пересылаются рабочим, после их выхода run()
+// возвращается. Потоков, кроме логгера, не создаёт: fork из многопоточного процесса небезопасен.
+class ProcessSupervisor {
+ public:
+  using WorkerEntry = std::function<int(WorkerContext&)>;
+  using Task = std::function<int()>;
+
+  explicit ProcessSupervisor(SupervisorOptions options);
+
+  ProcessSupervisor(const ProcessSupervisor&) = delete;
+  ProcessSupervisor& operator=(const ProcessSupervisor&) = delete;
+  ProcessSupervisor(ProcessSupervisor&&) = delete;
+  ProcessSupervisor& operator=(ProcessSupervisor&&) = delete;
+
+  // Сигналы, которые обрабатываются sigwait/signalfd, а не обработчиками. Блокировать в начале main,
+  // до первого потока: маска наследуется потоками и дочерними процессами
+  static void blockSignals();
+
+  // Разовая задача в отдельном процессе, запускается вместе с рабочими и не перезапускается
+  void addTask(std::string name, Task task);
+
+  // Блокирует до остановки всех процессов; возвращает код выхода родителя.
+  // В дочернем процессе entry вызывается с заблокированными SIGTERM и SIGINT, процесс завершается с её кодом
+  int run(const WorkerEntry& entry);
+
+ private:
+  struct Process {
+    pid_t pid{-1};
+    std::size_t slot{0};
+    // Для разовых задач
+    std::optional<std::size_t> task;
+    // Читающий конец канала готовности; -1 после сигнала готовности или выхода
+    int readyFd{-1};
+    bool ready{false};
+    // Получил SIGTERM: заменён при rolling restart или идёт остановка
+    bool retiring{false};
+    std::chrono::steady_clock::time_point startedAt;
+    std::chrono::steady_clock::time_point killAt;
+  };
+
+  struct Slot {
+    // Падения подряд, для удвоения паузы перед перезапуском
+    std::size_t failures{0};
+    std::optional<std::chrono::steady_clock::time_point> restartAt;
+  };
+
+  // Rolling restart: для места slot запущен replacement; старый процесс останавливается после его готовности
+  struct Rollout {
+    std::size_t slot{0};
+    pid_t replacement{-1};
+    pid_t retired{-1};
+    std::chrono::steady_clock::time_point readyDeadline;
+  };
+
+  SupervisorOptions options_;
+  int signalFd_{-1};
+  std::vector<std::pair<std::string, Task>> tasks_;
+  std::vector<Process> processes_;
+  std::vector<Slot> slots_;
+  std::optional<Rollout> rollout_;
+  // Места, ещё ожидающие замены в текущем rolling restart
+  std::vector<std::size_t> rolloutQueue_;
+  bool stopping_{false};
+
+  // Дочерний процесс: привязка к жизни родителя, закрытие чужих дескрипторов
+  void prepareChild(pid_t parent);
+  // -1, если fork не удался
+  pid_t spawn(std::size_t slot, const WorkerEntry& entry);
+  void spawnTask(std::size_t index);
+  [[nodiscard]] bool hasActive(std::size_t slot) const;
+  void terminate(Process& process);
+  void stop(int signal);
+  void readReady(Process& process, const WorkerEntry& entry);
+  void reap(const WorkerEntry& entry);
+  void startRollout(const WorkerEntry& entry);
+  void advanceRollout(const WorkerEntry& entry);
+  void abortRollout(const char* reason);
+  void onTimers(const WorkerEntry& entry);
+  // Таймаут poll до ближайшего срока: перезапуска, SIGKILL или готовности замены; -1 — сроков нет
+  [[nodiscard]] std::chrono::milliseconds nextTimeout() const;
+};
+
+}  // namespace auction::core
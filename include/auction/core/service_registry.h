@@ -1,9 +1,11 @@
 #pragma once
 
+#include <exception>
+#include <functional>
 #include <string>
 #include <vector>
 
-#include "auction/core/http_client.h"
+#include "auction/core/async_http_client.h"
 
 namespace auction::core {
 
@@ -23,14 +25,18 @@ struct ApiMethod {
 
 class ServiceRegistry {
  public:
-  ServiceRegistry();
+  explicit ServiceRegistry(AsyncHttpClient& httpClient);
 
-  void registerMethods(const std::vector<ApiMethod>& methods) const;
+  void registerMethods(const std::vector<ApiMethod>& methods);
+  // onDone вызывается из потока HTTP-клиента; error == nullptr при успехе
+  void registerMethodsAsync(const std::vector<ApiMethod>& methods, std::function<void(std::exception_ptr)> onDone);
 
  private:
   std::string registryUrl_;
   std::string serviceName_;
-  HttpClient httpClient_;
+  AsyncHttpClient& httpClient_;
+
+  nlohmann::json buildPayload(const std::vector<ApiMethod>& methods) const;
 
   static std::string resolveRegistryUrl();
   static std::string resolveServiceName();
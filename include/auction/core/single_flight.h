@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace auction::core {
+
+// Схлопывает одновременные вызовы с одинаковым ключом: функцию выполняет первый вызвавший,
+// остальные ждут и получают тот же результат или то же исключение.
+// Синхронный run и асинхронные runAsync делят одну таблицу, поэтому могут смешиваться для одного ключа.
+template <typename Key, typename Value>
+class SingleFlight {
+ public:
+  // Завершение работы первого вызвавшего; вызывается ровно один раз
+  using Done = std::function<void(std::exception_ptr error, Value value)>;
+  // Подписчик runAsync без future: вызывается в том потоке, где завершилась работа
+  using Subscriber = std::function<void(std::exception_ptr error, const Value& value)>;
+
+  template <typename Fn>
+  Value run(const Key& key, Fn&& fn) {
+    auto [flight, leader] = join(key, nullptr);
+    if (leader) {
+      try {
+        finish(key, *flight, nullptr, std::forward<Fn>(fn)());
+      } catch (...) {
+        finish(key, *flight, std::current_exception(), Value{});
+      }
+    }
+    return flight->result.get();
+  }
+
+  // launch(done) вызывается только у первого обратившегося и должен когда-нибудь вызвать
+  // done(error, value) — например, из колбэка асинхронного запроса. Остальные получают тот же future.
+  template <typename Launch>
+  std::shared_future<Value> runAsync(const Key& key, Launch&& launch) {
+    auto [flight, leader] = join(key, nullptr);
+    if (leader) {
+      start(key, flight, std::forward<Launch>(launch));
+    }
+    return flight->result;
+  }
+
+  // То же, но результат приходит в onDone, а не в future: ждущему не нужен поток, блокирующийся на get()
+  template <typename Launch>
+  void runAsync(const Key& key, Launch&& launch, Subscriber onDone) {
+    auto [flight, leader] = join(key, std::move(onDone));
+    if (leader) {
+      start(key, flight, std::forward<Launch>(launch));
+    }
+  }
+
+ private:
+  struct Flight {
+    std::promise<Value> promise;
+    std::shared_future<Value> result{promise.get_future().share()};
+    std::vector<Subscriber> subscribers;
+    std::atomic<bool> completed{false};
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<Key, std::shared_ptr<Flight>> inflight_;
+
+  // Присоединиться к выполняющемуся вызову или начать новый; second == true — вызывающий стал первым
+  std::pair<std::shared_ptr<Flight>, bool> join(const Key& key, Subscriber onDone) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto [it, inserted] = inflight_.try_emplace(key);
+    if (inserted) {
+      it->second = std::make_shared<Flight>();
+    }
+    if (onDone) {
+      it->second->subscribers.push_back(std::move(onDone));
+    }
+    return {it->second, inserted};
+  }
+
+  template <typename Launch>
+  void start(const Key& key, const std::shared_ptr<Flight>& flight, Launch&& launch) {
+    Done done = [this, key, flight](std::exception_ptr error, Value value) {
+      finish(key, *flight, std::move(error), std::move(value));
+    };
+    try {
+      std::forward<Launch>(launch)(done);
+    } catch (...) {
+      done(std::current_exception(), Value{});
+    }
+  }
+
+  void finish(const Key& key, Flight& flight, std::exception_ptr error, Value value) {
+    if (flight.completed.exchange(true)) {
+      return;
+    }
+
+    // После удаления из таблицы новых подписчиков у этого вызова не появится
+    std::vector<Subscriber> subscribers;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      inflight_.erase(key);
+      subscribers.swap(flight.subscribers);
+    }
+
+    if (error) {
+      flight.promise.set_exception(error);
+    } else {
+      flight.promise.set_value(value);
+    }
+    for (const auto& subscriber : subscribers) {
+      subscriber(error, value);
+    }
+  }
+};
+
+}  // namespace auction::core
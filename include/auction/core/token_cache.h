@@ -1,33 +1,73 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace auction::core {
 
+struct TokenCacheOptions {
+  std::size_t shards{16};
+  // Общая ёмкость по всем шардам; при переполнении шарда вытесняется давно не использованная запись (LRU)
+  std::size_t capacity{100000};
+  std::chrono::seconds positiveTtl{60};
+  // Отказы кэшируются короче, чтобы только что выданный токен быстрее начинал проходить
+  std::chrono::seconds negativeTtl{10};
+
+  // TOKEN_CACHE_SHARDS, TOKEN_CACHE_CAPACITY, TOKEN_CACHE_TTL_S, TOKEN_CACHE_NEGATIVE_TTL_S
+  static TokenCacheOptions fromEnvironment();
+};
+
+struct TokenCacheStats {
+  std::uint64_t hits{0};
+  std::uint64_t misses{0};
+  std::uint64_t evictions{0};
+  std::uint64_t expirations{0};
+  std::size_t size{0};
+};
+
 class TokenCache {
  public:
-  explicit TokenCache(std::chrono::seconds ttl = std::chrono::seconds{60});
+  explicit TokenCache(TokenCacheOptions options = {});
 
   std::optional<bool> get(const std::string& token);
   void put(const std::string& token, bool isValid);
   void clear();
 
+  [[nodiscard]] TokenCacheStats stats() const;
+
  private:
   struct Entry {
+    std::string key;
     bool valid;
     std::chrono::steady_clock::time_point expires_at;
   };
 
-  std::chrono::seconds ttl_;
-  std::unordered_map<std::string, Entry> cache_;
-  std::mutex mutex_;
+  // Срок жизни проверяется лениво при обращении к записи; полного обхода кэша нет.
+  // Счётчики лежат в шарде и меняются под его mutex: общий атомик на каждое обращение был бы одной
+  // кэш-линией на все потоки. Шард выровнен, чтобы соседние шарды не делили линию
+  struct alignas(64) Shard {
+    mutable std::mutex mutex;
+    std::list<Entry> lru;  // свежие в начале
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};
+    std::uint64_t evictions{0};
+    std::uint64_t expirations{0};
+  };
+
+  TokenCacheOptions options_;
+  std::size_t shardCapacity_;
+  std::vector<std::unique_ptr<Shard>> shards_;
 
-  void purgeExpiredLocked();
+  Shard& shardFor(const std::string& token);
 };
 
 }  // namespace auction::core
-
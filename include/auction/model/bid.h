@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <nlohmann/json.hpp>
+
+#include "auction/model/money.h"
+#include "auction/model/timestamp.h"
+
+namespace auction::model {
+
+struct Bid {
+  std::int64_t id{};
+  int lot_id{};
+  Money amount;
+  std::optional<std::string> bidder_id;
+  Timestamp created_at{};
+
+  [[nodiscard]] nlohmann::json toJson() const;
+};
+
+// Тело POST /lots/{id}/bid
+struct BidRequest {
+  Money amount;
+  std::optional<std::string> bidder_id;
+};
+
+// Бросает PayloadError с именем поля при ошибке валидации
+BidRequest bidRequestFromJson(std::string_view body);
+
+}  // namespace auction::model
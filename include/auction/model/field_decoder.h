@@ -0,0 +1,288 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include <nlohmann/json.hpp>
+
+#include "auction/model/money.h"
+#include "auction/model/timestamp.h"
+
+namespace auction::model {
+
+// Ошибка разбора тела запроса. field() пуст, если тело не является корректным JSON-объектом.
+class PayloadError : public std::invalid_argument {
+ public:
+  PayloadError(std::string field, const std::string& message)
+      : std::invalid_argument(message), field_(std::move(field)) {}
+
+  [[nodiscard]] const std::string& field() const noexcept { return field_; }
+
+ private:
+  std::string field_;
+};
+
+// Что делать с явным null в поле
+enum class OnNull {
+  Reject,  // ошибка: поле не допускает null
+  Skip,    // null равносилен отсутствию поля
+  Reset,   // сбросить std::optional в nullopt
+};
+
+template <typename Target>
+using FieldMember = std::variant<std::string Target::*, std::optional<std::string> Target::*, Money Target::*,
+                                 std::optional<Money> Target::*, std::optional<Timestamp> Target::*>;
+
+// Описание одного поля тела запроса; наборы полей задаются constexpr-таблицами рядом с моделью
+template <typename Target>
+struct FieldSpec {
+  std::string_view name;
+  FieldMember<Target> member;
+  bool required{false};
+  OnNull onNull{OnNull::Reject};
+};
+
+// Однопроходный декодер плоского JSON-объекта по таблице полей: SAX-разбор nlohmann без построения DOM,
+// каждое значение сразу пишется в целевую структуру. Незнакомые ключи (включая вложенные значения) пропускаются,
+// при повторе ключа побеждает последнее значение — как в nlohmann::json::parse.
+template <typename Target, std::size_t N>
+class FieldDecoder {
+  static_assert(N <= 32, "required fields are tracked in a 32-bit mask");
+
+ public:
+  using json = nlohmann::json;
+
+  FieldDecoder(const std::array<FieldSpec<Target>, N>& fields, Target& target) : fields_(fields), target_(target) {}
+
+  void decode(std::string_view body) {
+    if (!json::sax_parse(body.begin(), body.end(), this)) {
+      throw PayloadError("", "Invalid JSON payload");
+    }
+    for (std::size_t i = 0; i < N; ++i) {
+      if (fields_[i].required && (seen_ & (1U << i)) == 0) {
+        throw PayloadError(std::string{fields_[i].name},
+                           "Missing required field '" + std::string{fields_[i].name} + "'");
+      }
+    }
+  }
+
+  // Интерфейс SAX nlohmann
+  bool null() {
+    if (const auto* field = valueField()) {
+      if (field->onNull == OnNull::Reject) {
+        fail(*field, "must not be null");
+      }
+      if (field->onNull == OnNull::Reset) {
+        std::visit([this](auto member) { resetMember(member); }, field->member);
+      }
+      markSeen();
+    }
+    return true;
+  }
+
+  bool boolean(bool) {
+    if (const auto* field = valueField()) {
+      failType(*field);
+    }
+    return true;
+  }
+
+  bool number_integer(json::number_integer_t value) {
+    return number([value] { return Money::fromUnits(value); });
+  }
+
+  bool number_unsigned(json::number_unsigned_t value) {
+    return number([value]() -> std::optional<Money> {
+      if (value > static_cast<json::number_unsigned_t>(std::numeric_limits<std::int64_t>::max())) {
+        return std::nullopt;
+      }
+      return Money::fromUnits(static_cast<std::int64_t>(value));
+    });
+  }
+
+  // raw — лексема числа из тела: сумма разбирается из десятичной записи без округления через double
+  bool number_float(json::number_float_t, const json::string_t& raw) {
+    return number([&raw] { return Money::parse(raw); });
+  }
+
+  bool string(json::string_t& value) {
+    if (const auto* field = valueField()) {
+      std::visit(
+          [&](auto member) {
+            using Member = decltype(member);
+            if constexpr (isStringMember<Member>()) {
+              target_.*member = std::move(value);
+            } else if constexpr (isTimestampMember<Member>()) {
+              // Время разбирается сразу при чтении тела, дальше сервис работает с типизированным значением.
+              // Пустая строка, как и до типизации, означает отсутствие значения
+              if (value.empty()) {
+                target_.*member = std::nullopt;
+                return;
+              }
+              const auto parsed = parseTimestamp(value);
+              if (!parsed) {
+                failType(*field);
+              }
+              target_.*member = *parsed;
+            } else {
+              failType(*field);
+            }
+          },
+          field->member);
+      markSeen();
+    }
+    return true;
+  }
+
+  bool binary(json::binary_t&) { return true; }
+
+  bool start_object(std::size_t) {
+    if (depth_ == 0) {
+      ++depth_;
+      return true;
+    }
+    return startNested();
+  }
+
+  bool start_array(std::size_t) {
+    if (depth_ == 0) {
+      failNotObject();
+    }
+    return startNested();
+  }
+
+  bool end_object() { return endContainer(); }
+  bool end_array() { return endContainer(); }
+
+  bool key(json::string_t& name) {
+    current_ = kNoField;
+    if (depth_ != 1) {
+      return true;
+    }
+    for (std::size_t i = 0; i < N; ++i) {
+      if (fields_[i].name == name) {
+        current_ = i;
+        break;
+      }
+    }
+    return true;
+  }
+
+  bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) { return false; }
+
+ private:
+  static constexpr std::size_t kNoField = N;
+
+  const std::array<FieldSpec<Target>, N>& fields_;
+  Target& target_;
+  std::size_t depth_{0};
+  std::size_t current_{kNoField};
+  std::uint32_t seen_{0};
+
+  template <typename Member>
+  static constexpr bool isStringMember() {
+    return std::is_same_v<Member, std::string Target::*> || std::is_same_v<Member, std::optional<std::string> Target::*>;
+  }
+
+  template <typename Member>
+  static constexpr bool isTimestampMember() {
+    return std::is_same_v<Member, std::optional<Timestamp> Target::*>;
+  }
+
+  template <typename Member>
+  static constexpr bool isMoneyMember() {
+    return std::is_same_v<Member, Money Target::*> || std::is_same_v<Member, std::optional<Money> Target::*>;
+  }
+
+  template <typename Member>
+  static constexpr const char* expectation() {
+    if constexpr (isStringMember<Member>()) {
+      return "must be a string";
+    } else if constexpr (isTimestampMember<Member>()) {
+      return "must be an RFC 3339 timestamp";
+    } else {
+      return "must be a number";
+    }
+  }
+
+  // Поле, которому адресовано текущее скалярное значение, или nullptr, если значение пропускается
+  const FieldSpec<Target>* valueField() {
+    if (depth_ == 0) {
+      failNotObject();
+    }
+    return depth_ == 1 && current_ != kNoField ? &fields_[current_] : nullptr;
+  }
+
+  void markSeen() { seen_ |= 1U << current_; }
+
+  // Сумма строится только для денежного поля: значения пропускаемых ключей не разбираются
+  template <typename MakeMoney>
+  bool number(MakeMoney makeMoney) {
+    if (const auto* field = valueField()) {
+      std::visit(
+          [&](auto member) {
+            using Member = decltype(member);
+            if constexpr (isMoneyMember<Member>()) {
+              const std::optional<Money> value = makeMoney();
+              if (!value) {
+                fail(*field, "is out of range");
+              }
+              target_.*member = *value;
+            } else {
+              failType(*field);
+            }
+          },
+          field->member);
+      markSeen();
+    }
+    return true;
+  }
+
+  bool startNested() {
+    if (const auto* field = valueField()) {
+      failType(*field);
+    }
+    ++depth_;
+    return true;
+  }
+
+  bool endContainer() {
+    --depth_;
+    current_ = kNoField;
+    return true;
+  }
+
+  template <typename Member>
+  void resetMember(Member member) {
+    if constexpr (std::is_same_v<Member, std::optional<std::string> Target::*> ||
+                  std::is_same_v<Member, std::optional<Money> Target::*> || isTimestampMember<Member>()) {
+      target_.*member = std::nullopt;
+    }
+  }
+
+  [[noreturn]] static void failNotObject() { throw PayloadError("", "Request body must be a JSON object"); }
+
+  [[noreturn]] static void fail(const FieldSpec<Target>& field, const char* problem) {
+    throw PayloadError(std::string{field.name}, "Field '" + std::string{field.name} + "' " + problem);
+  }
+
+  [[noreturn]] static void failType(const FieldSpec<Target>& field) {
+    fail(field, std::visit([](auto member) { return expectation<decltype(member)>(); }, field.member));
+  }
+};
+
+template <typename Target, std::size_t N>
+void decodeFields(const std::array<FieldSpec<Target>, N>& fields, std::string_view body, Target& target) {
+  FieldDecoder<Target, N>(fields, target).decode(body);
+}
+
+}  // namespace auction::model
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "auction/model/bid.h"
+#include "auction/model/lot.h"
+
+// Сериализация моделей напрямую в строковый буфер, без промежуточного nlohmann::json.
+// Вывод побайтно совпадает с nlohmann::json::dump() для тех же значений: ключи в алфавитном
+// порядке, те же правила экранирования строк и форматирования чисел с плавающей точкой.
+namespace auction::model::json {
+
+// Строка в кавычках с экранированием как в nlohmann (ensure_ascii = false).
+// Бросает std::runtime_error на невалидном UTF-8 — nlohmann в этом случае тоже бросает.
+void appendString(std::string& out, std::string_view value);
+
+// Формат nlohmann: кратчайшее (Grisu2) представление, целые значения с ".0", NaN/inf — null
+void appendNumber(std::string& out, double value);
+
+template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+void appendNumber(std::string& out, Integer value) {
+  char buffer[24];
+  const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  out.append(buffer, result.ptr);
+}
+
+void appendLot(std::string& out, const Lot& lot);
+void appendBid(std::string& out, const Bid& bid);
+
+// JSON-массив из диапазона моделей, например appendArray(out, page.lots, appendLot)
+template <typename Range, typename Append>
+void appendArray(std::string& out, const Range& items, Append append) {
+  out.push_back('[');
+  bool first = true;
+  for (const auto& item : items) {
+    if (!first) {
+      out.push_back(',');
+    }
+    first = false;
+    append(out, item);
+  }
+  out.push_back(']');
+}
+
+}  // namespace auction::model::json
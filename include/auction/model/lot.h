@@ -2,25 +2,34 @@
 
 #include <optional>
 #include <string>
+#include <string_view>
 
 #include <nlohmann/json.hpp>
 
+#include "auction/model/money.h"
+#include "auction/model/timestamp.h"
+
 namespace auction::model {
 
 struct Lot {
   int id{};
   std::string name;
   std::optional<std::string> description;
-  double start_price{};
-  std::optional<double> current_price;
+  Money start_price;
+  std::optional<Money> current_price;
   std::optional<std::string> owner_id;
-  std::string created_at;
-  std::optional<std::string> auction_end_date;
+  // Задаётся базой при вставке
+  std::optional<Timestamp> created_at;
+  std::optional<Timestamp> auction_end_date;
 
   [[nodiscard]] nlohmann::json toJson() const;
 };
 
-Lot lotFromJson(const nlohmann::json& json);
+// Тело POST /lots; бросает PayloadError с именем поля при ошибке валидации
+Lot lotFromJson(std::string_view body);
+
+// Частичное обновление из тела PUT /lots/{id}: меняются только присутствующие поля
+void applyLotPatch(Lot& lot, std::string_view body);
 
 }  // namespace auction::model
 
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace auction::model {
+
+// Денежная сумма с фиксированной точкой: целое число сотых долей (копеек), как NUMERIC(12,2) в БД.
+// Сравнение — обычное целочисленное, без погрешностей double.
+class Money {
+ public:
+  static constexpr int kScale = 2;
+  static constexpr std::int64_t kMinorPerUnit = 100;
+
+  constexpr Money() = default;
+
+  static constexpr Money fromMinorUnits(std::int64_t minorUnits) { return Money{minorUnits}; }
+  // nullopt при переполнении
+  static std::optional<Money> fromUnits(std::int64_t units);
+  // Десятичная запись, в том числе с экспонентой ("310.25", "-1", "1.5e2"). Лишние знаки после
+  // второго округляются половиной от нуля, как при записи в NUMERIC(12,2). nullopt при ошибке или переполнении.
+  static std::optional<Money> parse(std::string_view text);
+
+  [[nodiscard]] constexpr std::int64_t minorUnits() const { return minorUnits_; }
+  [[nodiscard]] double toDouble() const { return static_cast<double>(minorUnits_) / kMinorPerUnit; }
+
+  // Кратчайшая десятичная запись, совпадающая с nlohmann::json::dump() для toDouble(): "150.0", "275.5", "310.25".
+  // Она же годится как текстовый параметр NUMERIC.
+  void appendDecimal(std::string& out) const;
+  [[nodiscard]] std::string toString() const;
+
+  friend constexpr auto operator<=>(Money, Money) = default;
+
+ private:
+  constexpr explicit Money(std::int64_t minorUnits) : minorUnits_(minorUnits) {}
+
+  std::int64_t minorUnits_{0};
+};
+
+}  // namespace auction::model
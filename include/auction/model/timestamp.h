@@ -0,0 +1,22 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace auction::model {
+
+// Точность TIMESTAMPTZ в PostgreSQL — микросекунды
+using Timestamp = std::chrono::sys_time<std::chrono::microseconds>;
+
+// RFC 3339 и формы, которые отдаёт PostgreSQL: "2025-12-31T18:00:00Z", "2025-12-31 18:00:00.5+00",
+// "2025-12-31 18:00+05:30", "2025-12-31". Без смещения время считается UTC; "infinity"/"-infinity" — max/min.
+// Не выделяет память; nullopt, если строка не разобрана целиком или год в UTC выходит за 0001-9999.
+std::optional<Timestamp> parseTimestamp(std::string_view value);
+
+// Вид PostgreSQL при TimeZone=UTC: "2025-01-02 03:04:05.123456+00", хвостовые нули дробной части отброшены
+void appendTimestamp(std::string& out, Timestamp value);
+std::string formatTimestamp(Timestamp value);
+
+}  // namespace auction::model
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "auction/core/database.h"
+#include "auction/core/task.h"
+#include "auction/model/bid.h"
+
+namespace auction::repository {
+
+struct BidPage {
+  std::vector<model::Bid> bids;
+  std::optional<std::string> nextCursor;
+};
+
+class BidRepository {
+ public:
+  explicit BidRepository(core::Database& database);
+
+  void ensureSchema();
+
+  // Пакетная вставка через COPY ... FROM STDIN
+  void insertBatch(const std::vector<model::Bid>& bids);
+  // История ставок лота, новые первыми; keyset-пагинация по (created_at DESC, id DESC)
+  core::Task<BidPage> listByLotTask(int lotId, std::size_t limit, std::optional<std::string> after);
+
+ private:
+  core::Database& database_;
+  std::once_flag statementsPrepared_;
+
+  struct PageQuery {
+    const char* statement;
+    std::vector<std::optional<std::string>> params;
+  };
+
+  static model::Bid mapBid(const PGresult* result, int row);
+  static PageQuery pageQuery(int lotId, std::size_t limit, const std::optional<std::string>& after);
+  static BidPage toPage(const PGresult* result, std::size_t limit);
+  void prepareStatements();
+  void registerStatements();
+};
+
+}  // namespace auction::repository
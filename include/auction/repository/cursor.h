@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace auction::repository {
+
+// Курсор keyset-пагинации по (created_at DESC, id DESC): "<created_at в микросекундах от Unix epoch>_<id>"
+struct Cursor {
+  std::int64_t createdAtMicros{0};
+  std::int64_t id{0};
+
+  [[nodiscard]] std::string encode() const;
+  // Бросает std::invalid_argument("Invalid cursor")
+  static Cursor decode(const std::string& cursor);
+};
+
+}  // namespace auction::repository
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "auction/model/lot.h"
+
+namespace auction::repository {
+
+struct LotCacheOptions {
+  // LOT_CACHE=0 — лоты всегда читаются из БД
+  bool enabled{true};
+  std::size_t shards{16};
+  // Общая ёмкость по всем шардам; при переполнении шарда вытесняется давно не читавшийся лот (LRU)
+  std::size_t capacity{10000};
+  // Срок жизни записи. Смена одной цены (ставка) уведомления не шлёт, поэтому цена, поднятая другим
+  // экземпляром, видна в кэше не позже чем через ttl
+  std::chrono::milliseconds ttl{1000};
+
+  // LOT_CACHE, LOT_CACHE_SHARDS, LOT_CACHE_CAPACITY, LOT_CACHE_TTL_MS
+  static LotCacheOptions fromEnvironment();
+};
+
+struct LotCacheStats {
+  std::uint64_t hits{0};
+  std::uint64_t misses{0};
+  std::uint64_t invalidations{0};
+  std::uint64_t evictions{0};
+  std::size_t size{0};
+  bool coherent{false};
+};
+
+// Кэш лотов по id за LotRepository. Записи версионированы колонкой lots.version, которую триггер
+// увеличивает при каждом UPDATE: более старая версия никогда не заменяет более новую.
+// Согласованность между экземплярами держится на NOTIFY того же триггера. Пока уведомления не
+// доходят (setCoherent(false)), кэш пуст и ничего не принимает. Ставки меняют только current_price и
+// не уведомляют: такие изменения с других экземпляров догоняет срок жизни записи (LotCacheOptions::ttl).
+// Запрос, начатый до изменения, не должен положить в кэш прочитанную до него версию: для этого
+// каждое изменение в шарде сдвигает его счётчик, а put сверяет счётчик с тикетом, взятым до запроса.
+class LotCache {
+ public:
+  // Снимок состояния до обращения к БД: если за время запроса кэш сбрасывался или в шарде что-то
+  // менялось, результат запроса мог устареть и в кэш не кладётся
+  struct Ticket {
+    std::uint64_t epoch{0};
+    std::uint64_t changes{0};
+  };
+
+  explicit LotCache(LotCacheOptions options = {});
+
+  std::optional<model::Lot> get(int id);
+  [[nodiscard]] Ticket ticket(int id);
+  // Положить лот, прочитанный или записанный в БД после ticket
+  void put(const Ticket& ticket, const model::Lot& lot, std::uint64_t version);
+  // Строка изменилась до версии version; запись этой версии или новее (своя запись) остаётся
+  void invalidate(int id, std::uint64_t version);
+  // Строка удалена или изменена без известной версии
+  void remove(int id);
+  // Изменилось неизвестно что: сбросить все записи, не трогая признак согласованности
+  void invalidateAll();
+  // Поступают ли уведомления. Любое переключение очищает кэш: пропущенные изменения не восстановить
+  void setCoherent(bool coherent);
+
+  [[nodiscard]] LotCacheStats stats() const;
+
+ private:
+  struct Entry {
+    model::Lot lot;
+    std::uint64_t version;
+    // Когда запись последний раз сверена с БД
+    std::chrono::steady_clock::time_point stored;
+  };
+
+  // Статистика — в шарде под его mutex, как у TokenCache: без общей кэш-линии на каждое обращение
+  struct alignas(64) Shard {
+    mutable std::mutex mutex;
+    std::list<Entry> lru;  // свежие в начале
+    std::unordered_map<int, std::list<Entry>::iterator> index;
+    // Изменения и вытеснения в шарде; сверяется с Ticket::changes
+    std::uint64_t changes{0};
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};
+    std::uint64_t invalidations{0};
+    std::uint64_t evictions{0};
+  };
+
+  LotCacheOptions options_;
+  std::size_t shardCapacity_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::atomic<bool> coherent_{false};
+  std::atomic<std::uint64_t> epoch_{0};
+
+  Shard& shardFor(int id);
+  // Удалить запись и отметить изменение; под mutex шарда
+  void dropLocked(Shard& shard, int id);
+  void clear();
+};
+
+}  // namespace auction::repository
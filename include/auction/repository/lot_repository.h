@@ -1,32 +1,142 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "auction/core/database.h"
+#include "auction/core/pg_listener.h"
+#include "auction/core/task.h"
 #include "auction/model/lot.h"
+#include "auction/repository/lot_cache.h"
 
 namespace auction::repository {
 
+struct LotPage {
+  std::vector<model::Lot> lots;
+  // Непрозрачный курсор для следующей страницы; отсутствует на последней странице
+  std::optional<std::string> nextCursor;
+};
+
+// Результат условной ставки (один UPDATE с проверкой цены и срока аукциона)
+struct BidResult {
+  enum class Status {
+    Accepted,
+    NotFound,
+    BidTooLow,
+    AuctionEnded,
+    // Проиграла гонку: конкурирующая ставка подняла цену между снимком и блокировкой строки
+    Outbid,
+  };
+
+  Status status{Status::NotFound};
+  // Обновлённый лот при Accepted, иначе текущее состояние лота (если он существует)
+  std::optional<model::Lot> lot;
+};
+
+// Лоты, чья строка не обновилась при записи цен движка ставок (LotRepository::persistCurrentPrices)
+struct PersistedPrices {
+  // Лот удалён
+  std::vector<int> missing;
+  // В БД уже цена выше
+  std::vector<int> outdated;
+};
+
 class LotRepository {
  public:
-  explicit LotRepository(core::Database& database);
+  class Stream;
+
+  // cache — необязательный кэш лотов по id; читают его findById/findByIdTask, записи обновляют его сразу
+  explicit LotRepository(core::Database& database, LotCache* cache = nullptr);
 
   void ensureSchema();
+  // Подписка на изменения lots из всех экземпляров сервиса (триггер из ensureSchema).
+  // Без кэша подписываться не на что — nullptr. Кэш работает, только пока подписка жива
+  std::unique_ptr<core::PgListener> listenForChanges();
+  std::optional<LotCacheStats> cacheStats() const;
+
+  // Пакетная запись цен из движка ставок; цена только растёт
+  PersistedPrices persistCurrentPrices(const std::vector<std::pair<int, model::Money>>& prices);
+
+  // Корутины: запрос к БД не блокирует поток исполнителя (Database::executePreparedTask).
+  // Keyset-пагинация по (created_at DESC, id DESC); after — курсор из предыдущей страницы
+  core::Task<LotPage> listPageTask(std::size_t limit, std::optional<std::string> after);
+  core::Task<std::optional<model::Lot>> findByIdTask(int id);
+  // В обход кэша: цена в кэше может отставать от ставок других экземпляров, ставкам нужна текущая
+  core::Task<std::optional<model::Lot>> findFreshByIdTask(int id);
+  core::Task<model::Lot> createTask(model::Lot lot);
+  core::Task<std::optional<model::Lot>> updateTask(int id, model::Lot lot);
+  core::Task<bool> removeTask(int id);
+  core::Task<BidResult> placeBidTask(int id, model::Money bidAmount);
+  // Потоковая выдача всех лотов без материализации. Ожидание ограничителя и соединения — здесь,
+  // сама выдача — в Stream::forEach
+  core::Task<Stream> openStreamTask();
 
-  std::vector<model::Lot> list();
-  std::optional<model::Lot> findById(int id);
-  model::Lot create(const model::Lot& lot);
-  std::optional<model::Lot> update(int id, const model::Lot& lot);
-  bool remove(int id);
-  std::optional<model::Lot> updateCurrentPrice(int id, double bidAmount);
+  // Номера колонок результата; определяются один раз на prepared statement.
+  // Вместе с mapLot открыты для бенчмарков на синтетических PGresult.
+  struct LotColumns {
+    int id;
+    int name;
+    int description;
+    int startPrice;
+    int currentPrice;
+    int ownerId;
+    int createdAt;
+    int auctionEndDate;
+
+    static LotColumns resolve(const PGresult* result);
+  };
+
+  // Строка результата в бинарном формате -> Lot
+  static model::Lot mapLot(const PGresult* result, int row, const LotColumns& columns);
 
  private:
+  struct PageQuery {
+    std::string statement;
+    std::vector<std::optional<std::string>> params;
+  };
+
   core::Database& database_;
-  bool statementsPrepared_{false};
+  LotCache* cache_;
+  std::once_flag statementsPrepared_;
+  std::mutex columnsMutex_;
+  std::unordered_map<std::string, LotColumns> columns_;
 
-  static model::Lot mapLot(PGresult* result, int row);
+  LotColumns columnsFor(const std::string& statement, const PGresult* result);
+  // Первая строка результата или nullopt, если строк нет
+  std::optional<model::Lot> firstLot(const std::string& statement, const PGresult* result);
+  // Тикет кэша, взятый до запроса к БД (см. LotCache::Ticket)
+  LotCache::Ticket cacheTicket(int id);
+  // firstLot, который заодно кладёт лот в кэш с версией строки
+  std::optional<model::Lot> cacheFirstLot(const LotCache::Ticket& ticket, const std::string& statement,
+                                          const PGresult* result);
+  // Payload уведомления: "id:version" после INSERT/UPDATE, "id" после DELETE
+  void applyChange(const std::string& payload);
+  static PageQuery pageQuery(std::size_t limit, const std::optional<std::string>& after);
+  LotPage toPage(const std::string& statement, const PGresult* result, std::size_t limit);
+  BidResult toBidResult(const LotCache::Ticket& ticket, const PGresult* result);
   void prepareStatements();
+  void registerStatements();
+};
+
+class LotRepository::Stream {
+ public:
+  // onLot возвращает false, чтобы прекратить выдачу. Читать можно один раз
+  void forEach(const std::function<bool(const model::Lot&)>& onLot);
+
+ private:
+  friend class LotRepository;
+
+  Stream(LotRepository& repository, core::Database::RowStream rows);
+
+  LotRepository* repository_;
+  core::Database::RowStream rows_;
 };
 
 }  // namespace auction::repository
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "auction/model/bid.h"
+#include "auction/repository/bid_repository.h"
+
+namespace auction::service {
+
+struct BidRecorderOptions {
+  std::size_t maxBatch{500};
+  std::chrono::milliseconds flushInterval{200};
+  // Сколько ставок держать в буфере, пока БД недоступна; сверх этого старые записи отбрасываются
+  std::size_t maxBuffered{50000};
+
+  // BID_HISTORY_BATCH, BID_HISTORY_FLUSH_MS, BID_HISTORY_MAX_BUFFERED
+  static BidRecorderOptions fromEnvironment();
+};
+
+// Буферизует историю ставок и пишет её пакетами через COPY по размеру или по таймеру,
+// чтобы запись истории не добавляла синхронный INSERT в обработку POST /lots/{id}/bid.
+class BidRecorder {
+ public:
+  BidRecorder(repository::BidRepository& repository, BidRecorderOptions options);
+  ~BidRecorder();
+
+  BidRecorder(const BidRecorder&) = delete;
+  BidRecorder& operator=(const BidRecorder&) = delete;
+  BidRecorder(BidRecorder&&) = delete;
+  BidRecorder& operator=(BidRecorder&&) = delete;
+
+  void record(model::Bid bid);
+
+ private:
+  repository::BidRepository& repository_;
+  BidRecorderOptions options_;
+
+  std::mutex mutex_;
+  std::condition_variable wakeup_;
+  // Старые записи вытесняются с начала за O(1)
+  std::deque<model::Bid> buffer_;
+  // Отброшено при переполнении с прошлого сброса; в лог попадает один раз за цикл сброса
+  std::size_t dropped_{0};
+  bool stopping_{false};
+  std::thread flusher_;
+
+  void run();
+};
+
+}  // namespace auction::service
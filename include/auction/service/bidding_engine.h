@@ -0,0 +1,132 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "auction/core/task.h"
+#include "auction/model/lot.h"
+#include "auction/repository/lot_repository.h"
+
+namespace auction::service {
+
+enum class DurabilityMode {
+  // Ставка подтверждается сразу после принятия в памяти; запись в БД догоняет асинхронно
+  Accepted,
+  // Ставка подтверждается после фиксации пакета write-behind в БД
+  Persisted,
+};
+
+struct BiddingEngineOptions {
+  std::size_t shards{0};  // 0 — по числу ядер
+  std::size_t maxBatch{256};
+  std::chrono::milliseconds flushInterval{5};
+  DurabilityMode durability{DurabilityMode::Persisted};
+
+  // BIDDING_ENGINE_SHARDS, BIDDING_ENGINE_BATCH, BIDDING_ENGINE_FLUSH_MS, BIDDING_ENGINE_DURABILITY=accepted|persisted
+  static BiddingEngineOptions fromEnvironment();
+};
+
+// Внутрипроцессный движок ставок: владеет текущей ценой активных лотов.
+// Лоты распределены по шардам, у каждого шарда один поток-писатель со своей очередью,
+// поэтому проверка и принятие ставки не требуют блокировок строки в БД.
+// Принятые цены пишутся в lots пакетами (write-behind) через pipeline, поэтому БД может отставать от шарда:
+// чтения и изменения лота идут через движок (overlayTask, updateTask), чтобы не потерять принятые ставки.
+// Поток шарда не ходит в БД: незнакомый лот загружает корутина ставки и повторяет её с загруженным лотом.
+// Рассчитан на один экземпляр сервиса, принимающий ставки.
+class BiddingEngine {
+ public:
+  BiddingEngine(repository::LotRepository& repository, BiddingEngineOptions options);
+  ~BiddingEngine();
+
+  BiddingEngine(const BiddingEngine&) = delete;
+  BiddingEngine& operator=(const BiddingEngine&) = delete;
+  BiddingEngine(BiddingEngine&&) = delete;
+  BiddingEngine& operator=(BiddingEngine&&) = delete;
+
+  // Бросает BidRejected при отказе по бизнес-правилам. Ответ шарда возобновляет корутину,
+  // поток исполнителя не ждёт
+  core::Task<model::Lot> placeBidTask(int id, model::Money bidAmount);
+  // Лот из БД с ценой из памяти шарда, если она выше: последние принятые ставки могут быть ещё не записаны
+  core::Task<model::Lot> overlayTask(model::Lot lot);
+  // Лот изменён в БД в обход движка: шард берёт новые поля, но не снижает принятую цену. Возвращает лот
+  // с актуальной ценой
+  core::Task<model::Lot> updateTask(model::Lot lot);
+  // Забыть состояние лота (после удаления или несостоявшейся записи); следующая ставка перечитает его из БД
+  void invalidate(int id);
+
+ private:
+  struct Outcome {
+    // nullopt — шард не знает лот: его нужно загрузить и повторить ставку
+    std::optional<model::Lot> lot;
+    // Поколение шарда на момент ответа; загрузку сверяют с ним (см. Shard::generation)
+    std::uint64_t generation{0};
+  };
+
+  // Ответ на команду; вызывается ровно один раз, в потоке шарда или писателя
+  using Reply = std::function<void(std::exception_ptr error, Outcome outcome)>;
+
+  struct Command {
+    enum class Kind { Bid, Overlay, Update, Invalidate };
+
+    Kind kind;
+    int id;
+    model::Money amount;
+    // Bid — лот, загруженный после ответа «не знаю лот»; Overlay и Update — лот из БД
+    std::optional<model::Lot> lot;
+    // Bid — поколение шарда, при котором началась загрузка lot
+    std::uint64_t generation{0};
+    Reply reply;
+  };
+
+  struct Shard {
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::deque<Command> queue;
+    bool stopping{false};
+    // Доступно только потоку шарда
+    std::unordered_map<int, model::Lot> lots;
+    // Растёт при каждом изменении лотов в обход ставок: загрузка, начатая раньше, могла прочитать
+    // старую строку, и такой лот в память не берётся
+    std::uint64_t generation{0};
+    std::thread worker;
+  };
+
+  struct PendingWrite {
+    int id;
+    model::Money amount;
+    model::Lot lot;
+    // Пустой, если ставка уже подтверждена (DurabilityMode::Accepted)
+    Reply reply;
+  };
+
+  repository::LotRepository& repository_;
+  BiddingEngineOptions options_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  std::mutex writeMutex_;
+  std::condition_variable writeWakeup_;
+  std::vector<PendingWrite> pendingWrites_;
+  bool writerStopping_{false};
+  std::thread writer_;
+
+  Shard& shardFor(int id);
+  void enqueue(Shard& shard, Command command);
+  void runShard(Shard& shard);
+  void handleCommand(Shard& shard, Command& command);
+  void handleBid(Shard& shard, Command& command);
+  void runWriter();
+  void flush(std::vector<PendingWrite>& batch);
+};
+
+}  // namespace auction::service
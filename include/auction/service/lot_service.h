@@ -1,26 +1,72 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "auction/core/task.h"
 #include "auction/model/lot.h"
+#include "auction/repository/bid_repository.h"
 #include "auction/repository/lot_repository.h"
+#include "auction/service/bid_recorder.h"
 
 namespace auction::service {
 
+// Ставка отклонена по бизнес-правилам; reason — машиночитаемый код ("bid_too_low", "auction_ended", "lot_not_found")
+class BidRejected : public std::runtime_error {
+ public:
+  BidRejected(std::string reason, const std::string& message)
+      : std::runtime_error(message), reason_(std::move(reason)) {}
+
+  [[nodiscard]] const std::string& reason() const { return reason_; }
+
+ private:
+  std::string reason_;
+};
+
+// Ставка не записана в БД по техническим причинам (не бизнес-правило): маршрут отвечает 5xx
+class BidNotPersisted : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+class BiddingEngine;
+
 class LotService {
  public:
-  explicit LotService(repository::LotRepository& repository);
+  // Если передан engine, ставки принимает внутрипроцессный движок, иначе — условный UPDATE в БД
+  LotService(repository::LotRepository& repository, repository::BidRepository& bidRepository, BidRecorder& bidRecorder,
+             BiddingEngine* engine = nullptr);
+
+  // nullopt — кэш лотов выключен (LOT_CACHE=0)
+  [[nodiscard]] std::optional<repository::LotCacheStats> lotCacheStats() const;
 
-  std::vector<model::Lot> listLots();
-  std::optional<model::Lot> getLot(int id);
-  model::Lot createLot(const model::Lot& lot);
-  std::optional<model::Lot> updateLot(int id, const model::Lot& lot);
-  bool deleteLot(int id);
-  model::Lot placeBid(int id, double bidAmount);
+  // Корутины: ожидание БД и движка ставок не занимает поток исполнителя
+  core::Task<repository::LotPage> listLotsPageTask(std::size_t limit, std::optional<std::string> after);
+  // Открывает потоковую выдачу всех лотов; строки читаются уже при отправке тела ответа
+  core::Task<repository::LotRepository::Stream> openLotStreamTask();
+  core::Task<std::optional<model::Lot>> getLotTask(int id);
+  core::Task<model::Lot> createLotTask(model::Lot lot);
+  core::Task<std::optional<model::Lot>> updateLotTask(int id, model::Lot lot);
+  core::Task<bool> deleteLotTask(int id);
+  core::Task<model::Lot> placeBidTask(int id, model::Money bidAmount, std::optional<std::string> bidderId);
+  // nullopt — лота нет: история ставок удалённого лота остаётся в bids, но не выдаётся
+  core::Task<std::optional<repository::BidPage>> listBidsTask(int lotId, std::size_t limit,
+                                                              std::optional<std::string> after);
 
  private:
   repository::LotRepository& repository_;
+  repository::BidRepository& bidRepository_;
+  BidRecorder& bidRecorder_;
+  BiddingEngine* engine_;
+
+  void recordBid(int id, model::Money bidAmount, const std::optional<std::string>& bidderId);
+  // Исход условного UPDATE: принятый лот или BidRejected
+  static model::Lot bidOutcome(repository::BidResult result);
 };
 
 }  // namespace auction::service
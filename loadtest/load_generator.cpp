@@ -0,0 +1,256 @@
+// Многопоточный генератор нагрузки для auction_service.
+//
+//   auction_loadgen --target http://127.0.0.1:8080 --threads 32 --duration 30
+//                   --mix list=10,get=40,create=5,bid=45 --lots 200 --hot-lots 1 --hot-share 0.8
+//
+// Перед замером создаёт --lots лотов. Доля --hot-share ставок уходит в первые --hot-lots лотов
+// (шторм ставок на горячий лот), остальные распределяются равномерно.
+// Печатает пропускную способность и p50/p99/p999 по каждому типу запроса.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <httplib.h>
+#include <nlohmann/json.hpp>
+
+#include "cli.h"
+
+namespace {
+
+enum Operation { kList, kGet, kCreate, kBid, kOperations };
+
+constexpr std::array<const char*, kOperations> kOperationNames = {"GET /lots", "GET /lots/{id}", "POST /lots",
+                                                                  "POST /lots/{id}/bid"};
+
+struct Mix {
+  std::array<double, kOperations> weights{10, 40, 5, 45};
+
+  static Mix parse(const std::string& text) {
+    Mix mix;
+    mix.weights.fill(0);
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+      const auto eq = item.find('=');
+      if (eq == std::string::npos) {
+        throw std::invalid_argument("Invalid mix item: " + item);
+      }
+      const auto name = item.substr(0, eq);
+      const double weight = std::stod(item.substr(eq + 1));
+      if (name == "list") {
+        mix.weights[kList] = weight;
+      } else if (name == "get") {
+        mix.weights[kGet] = weight;
+      } else if (name == "create") {
+        mix.weights[kCreate] = weight;
+      } else if (name == "bid") {
+        mix.weights[kBid] = weight;
+      } else {
+        throw std::invalid_argument("Unknown operation in mix: " + name);
+      }
+    }
+    return mix;
+  }
+};
+
+struct LotState {
+  explicit LotState(int lotId) : id(lotId) {}
+
+  int id;
+  // Ставки растут на 1 с каждой попыткой; гонка конкурентов даёт часть отказов bid_too_low
+  std::atomic<std::int64_t> nextBid{101};
+};
+
+struct OperationStats {
+  std::vector<std::uint32_t> latenciesUs;
+  std::uint64_t ok{0};
+  std::uint64_t rejected{0};
+  std::uint64_t errors{0};
+};
+
+struct WorkerStats {
+  std::array<OperationStats, kOperations> operations;
+};
+
+std::string lotPayload(int index) {
+  return nlohmann::json{{"name", "Load test lot " + std::to_string(index)},
+                        {"description", "Generated by auction_loadgen"},
+                        {"start_price", 100.0},
+                        {"owner_id", "loadtest"},
+                        {"auction_end_date", "2099-12-31 00:00:00+00"}}
+      .dump();
+}
+
+httplib::Headers authHeaders(const std::string& token) { return {{"Authorization", "Bearer " + token}}; }
+
+std::uint32_t percentile(const std::vector<std::uint32_t>& sorted, double fraction) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  const auto index = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1));
+  return sorted[index];
+}
+
+std::string formatMs(std::uint32_t micros) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(2) << static_cast<double>(micros) / 1000.0;
+  return out.str();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const auction::loadtest::Arguments args(argc, argv);
+  const std::string target = args.text("target", "http://127.0.0.1:8080");
+  const int threads = static_cast<int>(args.number("threads", 16));
+  const auto duration = std::chrono::duration<double>(args.number("duration", 30));
+  const int lotCount = std::max(1, static_cast<int>(args.number("lots", 200)));
+  const int hotLots = std::clamp(static_cast<int>(args.number("hot-lots", 1)), 0, lotCount);
+  const double hotShare = args.number("hot-share", 0.8);
+  const int tokens = std::max(1, static_cast<int>(args.number("tokens", 100)));
+  const Mix mix = Mix::parse(args.text("mix", "list=10,get=40,create=5,bid=45"));
+
+  // Подготовка: лоты, по которым пойдут чтения и ставки
+  std::vector<std::unique_ptr<LotState>> lots;
+  {
+    httplib::Client client(target);
+    for (int i = 0; i < lotCount; ++i) {
+      auto result = client.Post("/lots", authHeaders("loadtest-setup"), lotPayload(i), "application/json");
+      if (!result || result->status != 201) {
+        std::cerr << "Failed to create lot during setup: "
+                  << (result ? std::to_string(result->status) + " " + result->body : std::string{"no response"})
+                  << std::endl;
+        return 1;
+      }
+      const auto created = nlohmann::json::parse(result->body);
+      lots.push_back(std::make_unique<LotState>(created.at("id").get<int>()));
+    }
+  }
+  std::cout << "Created " << lots.size() << " lot(s); running " << threads << " thread(s) for " << duration.count()
+            << " s against " << target << std::endl;
+
+  std::vector<WorkerStats> stats(static_cast<std::size_t>(threads));
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> workers;
+  workers.reserve(static_cast<std::size_t>(threads));
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      auto& local = stats[static_cast<std::size_t>(t)];
+      std::mt19937_64 random(static_cast<std::uint64_t>(t) * 7919 + 17);
+      std::discrete_distribution<int> pickOperation(mix.weights.begin(), mix.weights.end());
+      std::uniform_int_distribution<int> pickLot(0, lotCount - 1);
+      std::uniform_int_distribution<int> pickHot(0, std::max(0, hotLots - 1));
+      std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+      httplib::Client client(target);
+      client.set_keep_alive(true);
+      client.set_read_timeout(30);
+      const auto headers = authHeaders("loadtest-token-" + std::to_string(t % tokens));
+      int created = 0;
+
+      while (!stop.load(std::memory_order_relaxed)) {
+        const auto operation = static_cast<Operation>(pickOperation(random));
+        auto& lot = *lots[static_cast<std::size_t>(operation == kBid && hotLots > 0 && unit(random) < hotShare
+                                                       ? pickHot(random)
+                                                       : pickLot(random))];
+
+        const auto requestStart = std::chrono::steady_clock::now();
+        httplib::Result result = [&] {
+          switch (operation) {
+            case kList:
+              return client.Get("/lots?limit=50", headers);
+            case kGet:
+              return client.Get("/lots/" + std::to_string(lot.id), headers);
+            case kCreate:
+              return client.Post("/lots", headers, lotPayload(t * 1000000 + created++), "application/json");
+            case kBid:
+            default: {
+              const auto amount = lot.nextBid.fetch_add(1, std::memory_order_relaxed);
+              return client.Post("/lots/" + std::to_string(lot.id) + "/bid", headers,
+                                 nlohmann::json{{"amount", amount}, {"bidder_id", "loadtest-" + std::to_string(t)}}
+                                     .dump(),
+                                 "application/json");
+            }
+          }
+        }();
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - requestStart);
+
+        auto& op = local.operations[operation];
+        op.latenciesUs.push_back(static_cast<std::uint32_t>(elapsed.count()));
+        if (!result) {
+          ++op.errors;
+        } else if (result->status >= 200 && result->status < 300) {
+          ++op.ok;
+        } else if (operation == kBid && result->status == 400) {
+          // bid_too_low / auction_ended — штатный отказ, а не ошибка сервиса
+          ++op.rejected;
+        } else {
+          ++op.errors;
+        }
+      }
+    });
+  }
+
+  std::this_thread::sleep_for(duration);
+  stop.store(true);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << std::left << std::setw(22) << "operation" << std::right << std::setw(10) << "count" << std::setw(11)
+            << "req/s" << std::setw(10) << "ok" << std::setw(10) << "rejected" << std::setw(9) << "errors"
+            << std::setw(10) << "p50 ms" << std::setw(10) << "p99 ms" << std::setw(10) << "p999 ms" << std::setw(10)
+            << "max ms" << '\n';
+
+  std::vector<std::uint32_t> all;
+  std::uint64_t totalErrors = 0;
+  for (int operation = 0; operation < kOperations; ++operation) {
+    OperationStats merged;
+    for (auto& worker : stats) {
+      auto& op = worker.operations[static_cast<std::size_t>(operation)];
+      merged.latenciesUs.insert(merged.latenciesUs.end(), op.latenciesUs.begin(), op.latenciesUs.end());
+      merged.ok += op.ok;
+      merged.rejected += op.rejected;
+      merged.errors += op.errors;
+    }
+    if (merged.latenciesUs.empty()) {
+      continue;
+    }
+    std::sort(merged.latenciesUs.begin(), merged.latenciesUs.end());
+    all.insert(all.end(), merged.latenciesUs.begin(), merged.latenciesUs.end());
+    totalErrors += merged.errors;
+
+    std::cout << std::left << std::setw(22) << kOperationNames[static_cast<std::size_t>(operation)] << std::right
+              << std::setw(10) << merged.latenciesUs.size() << std::setw(11) << std::fixed << std::setprecision(1)
+              << static_cast<double>(merged.latenciesUs.size()) / elapsed << std::setw(10) << merged.ok
+              << std::setw(10) << merged.rejected << std::setw(9) << merged.errors << std::setw(10)
+              << formatMs(percentile(merged.latenciesUs, 0.50)) << std::setw(10)
+              << formatMs(percentile(merged.latenciesUs, 0.99)) << std::setw(10)
+              << formatMs(percentile(merged.latenciesUs, 0.999)) << std::setw(10)
+              << formatMs(merged.latenciesUs.back()) << '\n';
+  }
+
+  std::sort(all.begin(), all.end());
+  std::cout << std::left << std::setw(22) << "total" << std::right << std::setw(10) << all.size() << std::setw(11)
+            << std::fixed << std::setprecision(1) << static_cast<double>(all.size()) / elapsed << std::setw(29)
+            << totalErrors << std::setw(10) << formatMs(percentile(all, 0.50)) << std::setw(10)
+            << formatMs(percentile(all, 0.99)) << std::setw(10) << formatMs(percentile(all, 0.999)) << std::setw(10)
+            << (all.empty() ? std::string{"-"} : formatMs(all.back())) << std::endl;
+
+  return totalErrors == 0 ? 0 : 3;
+}
@@ -0,0 +1,47 @@
+#!/usr/bin/env bash
+# Полный прогон: локальный PostgreSQL, заглушки платёжного сервиса и реестра, auction_service, генератор нагрузки.
+#
+#   cmake -S . -B build -DCMAKE_BUILD_TYPE=Release -DAUCTION_BUILD_LOADTEST=ON
+#   cmake --build build --target loadtest
+#   loadtest/scripts/run_loadtest.sh [аргументы auction_loadgen...]
+#
+# BUILD_DIR — каталог сборки (по умолчанию build). STUB_LATENCY_MS, STUB_JITTER_MS, STUB_ERROR_RATE
+# настраивают заглушку; остальные переменные окружения сервиса (DB_POOL_MAX, BIDDING_ENGINE, ...) передаются как есть.
+set -euo pipefail
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${BUILD_DIR:-$SCRIPT_DIR/../../build}"
+STUB_PORT="${STUB_PORT:-9100}"
+SERVICE_PORT="${SERVICE_PORT:-18080}"
+
+eval "$("$SCRIPT_DIR/start_postgres.sh")"
+
+pids=()
+cleanup() {
+  for pid in "${pids[@]}"; do
+    kill "$pid" 2>/dev/null || true
+  done
+  wait 2>/dev/null || true
+}
+trap cleanup EXIT
+
+"$BUILD_DIR/loadtest/auction_stub_services" --port "$STUB_PORT" \
+  --latency-ms "${STUB_LATENCY_MS:-5}" --jitter-ms "${STUB_JITTER_MS:-2}" --error-rate "${STUB_ERROR_RATE:-0}" &
+pids+=($!)
+
+PAYMENT_SERVICE_URL_OVERRIDE="http://127.0.0.1:$STUB_PORT" \
+SERVICE_REGISTRY_URL="http://127.0.0.1:$STUB_PORT" \
+SERVER_HOST=127.0.0.1 \
+SERVER_PORT="$SERVICE_PORT" \
+LOG_LEVEL="${LOG_LEVEL:-warn}" \
+  "$BUILD_DIR/auction_service" &
+pids+=($!)
+
+for _ in $(seq 1 60); do
+  if curl -sf "http://127.0.0.1:$SERVICE_PORT/health" >/dev/null; then
+    break
+  fi
+  sleep 0.5
+done
+
+"$BUILD_DIR/loadtest/auction_loadgen" --target "http://127.0.0.1:$SERVICE_PORT" "$@"
@@ -0,0 +1,57 @@
+#!/usr/bin/env bash
+# Поднимает локальный PostgreSQL для нагрузочного теста.
+# Через Docker, если он есть, иначе через initdb/pg_ctl из установленного PostgreSQL.
+# Печатает переменные окружения для auction_service: eval "$(loadtest/scripts/start_postgres.sh)"
+set -euo pipefail
+
+PG_PORT="${LOADTEST_PG_PORT:-55432}"
+PG_PASSWORD="${LOADTEST_PG_PASSWORD:-loadtest}"
+PG_CONTAINER="${LOADTEST_PG_CONTAINER:-auction-loadtest-pg}"
+PG_DATA="${LOADTEST_PG_DATA:-${TMPDIR:-/tmp}/auction-loadtest-pg}"
+PG_IMAGE="${LOADTEST_PG_IMAGE:-postgres:16}"
+# Настройки под нагрузочный тест, а не под сохранность данных
+PG_SETTINGS=(-c max_connections=200 -c shared_buffers=256MB -c synchronous_commit=off -c fsync=off)
+
+wait_ready() {
+  for _ in $(seq 1 60); do
+    if "$@" >/dev/null 2>&1; then
+      return 0
+    fi
+    sleep 0.5
+  done
+  echo "PostgreSQL did not become ready" >&2
+  return 1
+}
+
+if command -v docker >/dev/null 2>&1; then
+  if ! docker ps --format '{{.Names}}' | grep -qx "$PG_CONTAINER"; then
+    docker rm -f "$PG_CONTAINER" >/dev/null 2>&1 || true
+    docker run -d --name "$PG_CONTAINER" -e POSTGRES_PASSWORD="$PG_PASSWORD" -e POSTGRES_DB=auction \
+      -p "127.0.0.1:${PG_PORT}:5432" "$PG_IMAGE" "${PG_SETTINGS[@]}" >/dev/null
+  fi
+  wait_ready docker exec "$PG_CONTAINER" pg_isready -U postgres -d auction
+  PG_USER=postgres
+else
+  if ! command -v initdb >/dev/null 2>&1; then
+    echo "Neither docker nor initdb found; install PostgreSQL or Docker" >&2
+    exit 1
+  fi
+  PG_USER="$(id -un)"
+  if [[ ! -d "$PG_DATA" ]]; then
+    initdb -D "$PG_DATA" -U "$PG_USER" --auth=trust >/dev/null
+  fi
+  if ! pg_ctl -D "$PG_DATA" status >/dev/null 2>&1; then
+    pg_ctl -D "$PG_DATA" -l "$PG_DATA/server.log" -w \
+      -o "-p $PG_PORT -k $PG_DATA -h 127.0.0.1 ${PG_SETTINGS[*]}" start >/dev/null
+  fi
+  wait_ready pg_isready -h 127.0.0.1 -p "$PG_PORT"
+  createdb -h 127.0.0.1 -p "$PG_PORT" -U "$PG_USER" auction 2>/dev/null || true
+fi
+
+cat <<ENV
+export SUPABASE_HOST=127.0.0.1
+export SUPABASE_PORT=$PG_PORT
+export SUPABASE_DB=auction
+export SUPABASE_USER=$PG_USER
+export SUPABASE_PASSWORD=$PG_PASSWORD
+ENV
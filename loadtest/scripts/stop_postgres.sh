@@ -0,0 +1,15 @@
+#!/usr/bin/env bash
+# Останавливает PostgreSQL, поднятый start_postgres.sh. С --purge удаляет и данные.
+set -euo pipefail
+
+PG_CONTAINER="${LOADTEST_PG_CONTAINER:-auction-loadtest-pg}"
+PG_DATA="${LOADTEST_PG_DATA:-${TMPDIR:-/tmp}/auction-loadtest-pg}"
+
+if command -v docker >/dev/null 2>&1 && docker ps -a --format '{{.Names}}' | grep -qx "$PG_CONTAINER"; then
+  docker rm -f "$PG_CONTAINER" >/dev/null
+elif [[ -d "$PG_DATA" ]]; then
+  pg_ctl -D "$PG_DATA" -m fast stop >/dev/null 2>&1 || true
+  if [[ "${1:-}" == "--purge" ]]; then
+    rm -rf "$PG_DATA"
+  fi
+fi
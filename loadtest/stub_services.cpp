@@ -0,0 +1,113 @@
+// Заглушки платёжного сервиса (POST /token/check) и сервис-реестра (POST /service)
+// с настраиваемой задержкой и долей ошибок. Одна программа обслуживает оба пути.
+//
+//   auction_stub_services --port 9100 --latency-ms 5 --jitter-ms 2 --error-rate 0.01 --deny-rate 0
+//
+// error-rate — доля ответов 500, deny-rate — доля ответов {"allowed": false}.
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+
+#include <httplib.h>
+#include <nlohmann/json.hpp>
+
+#include "cli.h"
+
+namespace {
+
+struct StubOptions {
+  double latencyMs{5.0};
+  double jitterMs{0.0};
+  double errorRate{0.0};
+  double denyRate{0.0};
+};
+
+struct StubCounters {
+  std::atomic<std::uint64_t> tokenChecks{0};
+  std::atomic<std::uint64_t> errors{0};
+  std::atomic<std::uint64_t> denied{0};
+  std::atomic<std::uint64_t> registrations{0};
+};
+
+double uniform() {
+  thread_local std::mt19937_64 engine{std::random_device{}()};
+  return std::uniform_real_distribution<double>(0.0, 1.0)(engine);
+}
+
+void simulateLatency(const StubOptions& options) {
+  const double delay = options.latencyMs + (uniform() * 2.0 - 1.0) * options.jitterMs;
+  if (delay > 0) {
+    std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(delay));
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const auction::loadtest::Arguments args(argc, argv);
+  const std::string host = args.text("host", "127.0.0.1");
+  const int port = static_cast<int>(args.number("port", 9100));
+
+  StubOptions options;
+  options.latencyMs = args.number("latency-ms", options.latencyMs);
+  options.jitterMs = args.number("jitter-ms", options.jitterMs);
+  options.errorRate = args.number("error-rate", options.errorRate);
+  options.denyRate = args.number("deny-rate", options.denyRate);
+
+  StubCounters counters;
+  httplib::Server server;
+
+  server.Post("/token/check", [&](const httplib::Request& req, httplib::Response& res) {
+    ++counters.tokenChecks;
+    simulateLatency(options);
+
+    if (uniform() < options.errorRate) {
+      ++counters.errors;
+      res.status = 500;
+      res.set_content(R"({"error":"injected failure"})", "application/json");
+      return;
+    }
+
+    const auto body = nlohmann::json::parse(req.body, nullptr, false);
+    if (body.is_discarded() || !body.contains("token")) {
+      res.status = 400;
+      res.set_content(R"({"error":"bad request"})", "application/json");
+      return;
+    }
+
+    const bool allowed = uniform() >= options.denyRate;
+    if (!allowed) {
+      ++counters.denied;
+    }
+    res.status = 200;
+    res.set_content(nlohmann::json{{"allowed", allowed}}.dump(), "application/json");
+  });
+
+  server.Post("/service", [&](const httplib::Request&, httplib::Response& res) {
+    ++counters.registrations;
+    simulateLatency(options);
+    res.status = 200;
+    res.set_content("{}", "application/json");
+  });
+
+  server.Get("/stats", [&](const httplib::Request&, httplib::Response& res) {
+    res.set_content(nlohmann::json{{"token_checks", counters.tokenChecks.load()},
+                                   {"errors", counters.errors.load()},
+                                   {"denied", counters.denied.load()},
+                                   {"registrations", counters.registrations.load()}}
+                        .dump(),
+                    "application/json");
+  });
+
+  std::cout << "Stub payment service and registry listening on " << host << ":" << port << " (latency "
+            << options.latencyMs << "±" << options.jitterMs << " ms, errors " << options.errorRate * 100
+            << "%, denied " << options.denyRate * 100 << "%)" << std::endl;
+  if (!server.listen(host.c_str(), port)) {
+    std::cerr << "Failed to listen on " << host << ":" << port << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,1077 @@
+#include "auction/api/event_loop_server.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "auction/core/env.h"
+#include "auction/core/logger.h"
+#include "auction/core/metrics.h"
+
+namespace auction::api {
+
+namespace {
+
+constexpr std::uint64_t kListenToken = 0;
+constexpr std::uint64_t kWakeToken = 1;
+constexpr std::uint64_t kFirstConnectionId = 2;
+constexpr int kMaxEvents = 256;
+// Период проверки простоя; с той же задержкой циклы замечают stop()
+constexpr int kTickMs = 500;
+// Сколько соединений принимать за одно пробуждение, чтобы остальные циклы тоже получали свою долю
+constexpr int kMaxAcceptBatch = 64;
+constexpr std::size_t kReadChunk = 64 * 1024;
+constexpr std::size_t kMaxIovecs = 64;
+// Разобранные байты выбрасываются из входного буфера не на каждом чтении, а порциями
+constexpr std::size_t kCompactThreshold = 64 * 1024;
+
+const char* statusMessage(int status) {
+  switch (status) {
+    case 100: return "Continue";
+    case 200: return "OK";
+    case 201: return "Created";
+    case 204: return "No Content";
+    case 206: return "Partial Content";
+    case 301: return "Moved Permanently";
+    case 302: return "Found";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 408: return "Request Timeout";
+    case 409: return "Conflict";
+    case 413: return "Payload Too Large";
+    case 429: return "Too Many Requests";
+    case 431: return "Request Header Fields Too Large";
+    case 500: return "Internal Server Error";
+    case 501: return "Not Implemented";
+    case 502: return "Bad Gateway";
+    case 503: return "Service Unavailable";
+    case 504: return "Gateway Timeout";
+    case 505: return "HTTP Version Not Supported";
+    default: return "Unknown";
+  }
+}
+
+bool bodyForbidden(int status) { return (status >= 100 && status < 200) || status == 204 || status == 304; }
+
+// length — Content-Length; без него и без chunked тело идёт до закрытия соединения
+std::string serializeHead(const httplib::Response& res, std::optional<std::size_t> length, bool chunked, bool close) {
+  std::string head;
+  head.reserve(256);
+  head += "HTTP/1.1 ";
+  head += std::to_string(res.status);
+  head += ' ';
+  head += statusMessage(res.status);
+  head += "\r\n";
+  for (const auto& [name, value] : res.headers) {
+    head += name;
+    head += ": ";
+    head += value;
+    head += "\r\n";
+  }
+  if (!bodyForbidden(res.status)) {
+    if (chunked) {
+      head += "Transfer-Encoding: chunked\r\n";
+    } else if (length) {
+      head += "Content-Length: ";
+      head += std::to_string(*length);
+      head += "\r\n";
+    }
+  }
+  head += close ? "Connection: close\r\n\r\n" : "Connection: keep-alive\r\n\r\n";
+  return head;
+}
+
+std::string chunkFrame(const char* data, std::size_t length) {
+  char size[20];
+  char* end = std::to_chars(size, size + sizeof(size), length, 16).ptr;
+  std::string frame;
+  frame.reserve(static_cast<std::size_t>(end - size) + length + 4);
+  frame.append(size, end);
+  frame += "\r\n";
+  frame.append(data, length);
+  frame += "\r\n";
+  return frame;
+}
+
+std::string formatAddress(const sockaddr_storage& address) {
+  char buffer[INET6_ADDRSTRLEN] = {};
+  if (address.ss_family == AF_INET) {
+    inet_ntop(AF_INET, &reinterpret_cast<const sockaddr_in&>(address).sin_addr, buffer, sizeof(buffer));
+  } else if (address.ss_family == AF_INET6) {
+    inet_ntop(AF_INET6, &reinterpret_cast<const sockaddr_in6&>(address).sin6_addr, buffer, sizeof(buffer));
+  }
+  return buffer;
+}
+
+int openListener(const std::string& host, int port, bool reusePort) {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = AI_PASSIVE;
+  addrinfo* addresses = nullptr;
+  const std::string service = std::to_string(port);
+  if (getaddrinfo(host.empty() ? nullptr : host.c_str(), service.c_str(), &hints, &addresses) != 0) {
+    return -1;
+  }
+
+  int fd = -1;
+  for (const addrinfo* address = addresses; address != nullptr; address = address->ai_next) {
+    fd = ::socket(address->ai_family, address->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, address->ai_protocol);
+    if (fd < 0) {
+      continue;
+    }
+    const int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (reusePort) {
+      setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+    }
+    if (::bind(fd, address->ai_addr, address->ai_addrlen) == 0 && ::listen(fd, SOMAXCONN) == 0) {
+      break;
+    }
+    ::close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(addresses);
+  return fd;
+}
+
+// Обратное давление для потоковых ответов: обработчик в пуле ждёт, пока цикл не отправит
+// уже поставленные в очередь данные, и узнаёт о закрытии соединения
+class StreamChannel {
+ public:
+  explicit StreamChannel(std::size_t capacity) : capacity_(capacity) {}
+
+  // false — соединение закрыто, писать больше некуда
+  bool acquire(std::size_t bytes) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    drained_.wait(lock, [&] { return closed_ || queued_ == 0 || queued_ + bytes <= capacity_; });
+    if (closed_) {
+      return false;
+    }
+    queued_ += bytes;
+    return true;
+  }
+
+  void release(std::size_t bytes) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queued_ -= bytes;
+    }
+    drained_.notify_one();
+  }
+
+  void close() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+    }
+    drained_.notify_all();
+  }
+
+  bool isClosed() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return closed_;
+  }
+
+ private:
+  std::size_t capacity_;
+  std::mutex mutex_;
+  std::condition_variable drained_;
+  std::size_t queued_{0};
+  bool closed_{false};
+};
+
+// Порция ответа от обработчика циклу соединения
+struct Delivery {
+  std::uint64_t connection{0};
+  std::vector<std::string> pieces;
+  std::shared_ptr<StreamChannel> channel;
+  // Байты pieces учтены в channel и освобождаются по мере отправки
+  bool counted{false};
+  // Ответ на запрос передан целиком, можно браться за следующий
+  bool last{false};
+  bool close{false};
+};
+
+}  // namespace
+
+EventLoopServerOptions EventLoopServerOptions::fromEnvironment() {
+  EventLoopServerOptions options;
+  options.loops = core::envSize("HTTP_SERVER_LOOPS", options.loops);
+  options.workers = core::envSize("HTTP_SERVER_WORKERS", options.workers);
+  options.idleTimeout = std::chrono::milliseconds{
+      core::envSize("HTTP_SERVER_IDLE_TIMEOUT_MS", static_cast<std::size_t>(options.idleTimeout.count()))};
+  options.maxPipelined = std::max<std::size_t>(core::envSize("HTTP_SERVER_MAX_PIPELINED", options.maxPipelined), 1);
+  options.limits.maxBodyBytes = core::envSize("HTTP_SERVER_MAX_BODY_BYTES", options.limits.maxBodyBytes);
+  options.drainTimeout = std::chrono::milliseconds{
+      core::envSize("HTTP_SERVER_DRAIN_TIMEOUT_MS", static_cast<std::size_t>(options.drainTimeout.count()))};
+  return options;
+}
+
+class EventLoopServer::WorkerPool {
+ public:
+  explicit WorkerPool(std::size_t threads) {
+    threads_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+      threads_.emplace_back([this] { run(); });
+    }
+  }
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    wakeup_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+  WorkerPool(WorkerPool&&) = delete;
+  WorkerPool& operator=(WorkerPool&&) = delete;
+
+  void submit(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(std::move(task));
+    }
+    wakeup_.notify_one();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable wakeup_;
+  std::deque<std::function<void()>> tasks_;
+  bool stopping_{false};
+  std::vector<std::thread> threads_;
+
+  void run() {
+    for (;;) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wakeup_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+        // Оставшиеся задачи относятся к уже закрытым соединениям
+        if (stopping_) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+};
+
+class EventLoopServer::Loop {
+ public:
+  Loop(EventLoopServer& server, int listenFd)
+      : server_(server),
+        listenFd_(listenFd),
+        openConnections_(core::metrics::Registry::instance().gauge(
+            "auction_http_connections_open", "Client connections held by the event loop HTTP server")) {
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd_ < 0 || wakeFd_ < 0) {
+      const int error = errno;
+      closeDescriptors();
+      throw std::runtime_error(std::string{"Failed to create event loop: "} + std::strerror(error));
+    }
+
+    epoll_event wake{};
+    wake.events = EPOLLIN;
+    wake.data.u64 = kWakeToken;
+    // Слушающий сокет общий для всех циклов; EPOLLEXCLUSIVE будит на новое соединение один цикл, а не все
+    epoll_event accept{};
+    accept.events = EPOLLIN | EPOLLEXCLUSIVE;
+    accept.data.u64 = kListenToken;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &wake) != 0) {
+      failRegistration();
+    }
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd_, &accept) != 0) {
+      // Ядра до 4.5 не знают EPOLLEXCLUSIVE: тогда новое соединение будит все циклы, примет его один
+      accept.events = EPOLLIN;
+      if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd_, &accept) != 0) {
+        failRegistration();
+      }
+    }
+  }
+
+  ~Loop() {
+    for (auto& [id, connection] : connections_) {
+      if (connection->fd >= 0) {
+        closeConnection(*connection);
+      }
+    }
+    closeDescriptors();
+  }
+
+  Loop(const Loop&) = delete;
+  Loop& operator=(const Loop&) = delete;
+  Loop(Loop&&) = delete;
+  Loop& operator=(Loop&&) = delete;
+
+  void run() {
+    std::array<epoll_event, kMaxEvents> events{};
+    auto nextSweep = std::chrono::steady_clock::now() + std::chrono::milliseconds{kTickMs};
+    std::chrono::steady_clock::time_point drainDeadline;
+    for (;;) {
+      if (!shuttingDown_ && server_.stopping_.load(std::memory_order_acquire)) {
+        drainDeadline = std::chrono::steady_clock::now() + server_.options_.drainTimeout;
+        beginShutdown();
+      }
+      if (shuttingDown_ && (connections_.empty() || std::chrono::steady_clock::now() >= drainDeadline)) {
+        break;
+      }
+
+      const int count = epoll_wait(epollFd_, events.data(), kMaxEvents, kTickMs);
+      if (count < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        AUCTION_LOG_ERROR("Event loop wait failed").field("error", std::strerror(errno));
+        break;
+      }
+
+      for (int i = 0; i < count; ++i) {
+        const std::uint64_t token = events[static_cast<std::size_t>(i)].data.u64;
+        const std::uint32_t ready = events[static_cast<std::size_t>(i)].events;
+        if (token == kListenToken) {
+          acceptConnections();
+          continue;
+        }
+        if (token == kWakeToken) {
+          std::uint64_t value = 0;
+          [[maybe_unused]] const auto drained = ::read(wakeFd_, &value, sizeof(value));
+          drainMailbox();
+          continue;
+        }
+
+        // Соединение могло закрыться раньше в этой же пачке событий
+        auto it = connections_.find(token);
+        if (it == connections_.end() || it->second->fd < 0) {
+          continue;
+        }
+        Connection& connection = *it->second;
+        if ((ready & (EPOLLERR | EPOLLHUP)) != 0) {
+          closeConnection(connection);
+          continue;
+        }
+        if ((ready & EPOLLIN) != 0) {
+          onReadable(connection);
+        }
+        if ((ready & EPOLLOUT) != 0 && connection.fd >= 0) {
+          advance(connection);
+        }
+      }
+
+      const auto now = std::chrono::steady_clock::now();
+      if (now >= nextSweep) {
+        closeIdle(now);
+        nextSweep = now + std::chrono::milliseconds{kTickMs};
+      }
+      reap();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mailboxMutex_);
+      stopped_ = true;
+      for (auto& delivery : mailbox_) {
+        if (delivery.channel) {
+          delivery.channel->close();
+        }
+      }
+      mailbox_.clear();
+    }
+    for (auto& [id, connection] : connections_) {
+      if (connection->fd >= 0) {
+        closeConnection(*connection);
+      }
+    }
+    reap();
+  }
+
+  // Из любого потока. После остановки цикла потоковый обработчик сразу узнаёт, что писать некуда.
+  void deliver(Delivery delivery) {
+    bool wake = false;
+    {
+      std::lock_guard<std::mutex> lock(mailboxMutex_);
+      if (stopped_) {
+        if (delivery.channel) {
+          delivery.channel->close();
+        }
+        return;
+      }
+      // Непустой ящик значит, что пробуждение уже запрошено и цикл его ещё не обработал
+      wake = mailbox_.empty();
+      mailbox_.push_back(std::move(delivery));
+    }
+    if (wake) {
+      const std::uint64_t one = 1;
+      [[maybe_unused]] const auto written = ::write(wakeFd_, &one, sizeof(one));
+    }
+  }
+
+ private:
+  struct OutPiece {
+    std::string data;
+    // Канал, которому вернуть байты после отправки
+    std::shared_ptr<StreamChannel> credit;
+  };
+
+  struct Pending {
+    httplib::Request request;
+    bool keepAlive{false};
+    // Не 0 — запрос не разобран, ответить этим статусом и закрыть соединение
+    int errorStatus{0};
+  };
+
+  struct Connection {
+    Connection(int socket, std::uint64_t connectionId, std::string address, HttpLimits limits)
+        : fd(socket), id(connectionId), remoteAddr(std::move(address)), parser(limits) {}
+
+    int fd;
+    std::uint64_t id;
+    std::string remoteAddr;
+    HttpRequestParser parser;
+    std::string input;
+    std::size_t inputOffset{0};
+    // Разобранные запросы, ждущие очереди (pipelining)
+    std::deque<Pending> pending;
+    // Запрос в обработке у пула, включая передачу потокового ответа
+    bool busy{false};
+    // Клиент закрыл свою сторону: разбираем то, что уже пришло
+    bool peerClosed{false};
+    std::uint64_t requests{0};
+    // Новых запросов не принимаем: Connection: close, ошибка разбора или клиент ушёл
+    bool noMoreRequests{false};
+    bool closeAfterWrite{false};
+    std::deque<OutPiece> output;
+    std::size_t outputOffset{0};
+    std::shared_ptr<StreamChannel> stream;
+    std::chrono::steady_clock::time_point lastActivity;
+    std::uint32_t events{0};
+  };
+
+  EventLoopServer& server_;
+  int listenFd_;
+  int epollFd_{-1};
+  // Остановка: новые соединения не принимаются, начатые запросы дообслуживаются
+  bool shuttingDown_{false};
+  int wakeFd_{-1};
+  core::metrics::Gauge& openConnections_;
+
+  std::mutex mailboxMutex_;
+  std::vector<Delivery> mailbox_;
+  bool stopped_{false};
+
+  // Доступно только потоку цикла
+  std::unordered_map<std::uint64_t, std::unique_ptr<Connection>> connections_;
+  std::vector<std::uint64_t> closed_;
+  std::vector<Delivery> draining_;
+  std::array<char, kReadChunk> readBuffer_{};
+  std::uint64_t nextId_{kFirstConnectionId};
+
+  [[noreturn]] void failRegistration() {
+    const int error = errno;
+    closeDescriptors();
+    throw std::runtime_error(std::string{"Failed to register event loop descriptors: "} + std::strerror(error));
+  }
+
+  void closeDescriptors() {
+    if (epollFd_ >= 0) {
+      ::close(epollFd_);
+      epollFd_ = -1;
+    }
+    if (wakeFd_ >= 0) {
+      ::close(wakeFd_);
+      wakeFd_ = -1;
+    }
+  }
+
+  void acceptConnections() {
+    for (int accepted = 0; accepted < kMaxAcceptBatch; ++accepted) {
+      sockaddr_storage address{};
+      socklen_t length = sizeof(address);
+      const int fd =
+          accept4(listenFd_, reinterpret_cast<sockaddr*>(&address), &length, SOCK_NONBLOCK | SOCK_CLOEXEC);
+      if (fd < 0) {
+        if (errno == EINTR || errno == ECONNABORTED) {
+          continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+          AUCTION_LOG_WARN("Failed to accept connection").field("error", std::strerror(errno));
+        }
+        return;
+      }
+
+      // Ответ уходит одним sendmsg, так что Nagle только задерживал бы мелкие ответы
+      const int one = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+      const std::uint64_t id = nextId_++;
+      epoll_event event{};
+      event.events = EPOLLIN;
+      event.data.u64 = id;
+      if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+        ::close(fd);
+        continue;
+      }
+
+      auto connection = std::make_unique<Connection>(fd, id, formatAddress(address), server_.options_.limits);
+      connection->events = EPOLLIN;
+      connection->lastActivity = std::chrono::steady_clock::now();
+      connections_.emplace(id, std::move(connection));
+      openConnections_.add(1);
+    }
+  }
+
+  // Одно чтение на событие: level-triggered epoll вернёт остаток, а соседние соединения не ждут
+  void onReadable(Connection& connection) {
+    for (;;) {
+      const ssize_t received = ::recv(connection.fd, readBuffer_.data(), readBuffer_.size(), 0);
+      if (received > 0) {
+        connection.input.append(readBuffer_.data(), static_cast<std::size_t>(received));
+        break;
+      }
+      if (received == 0) {
+        connection.peerClosed = true;
+        break;
+      }
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        closeConnection(connection);
+      }
+      return;
+    }
+    connection.lastActivity = std::chrono::steady_clock::now();
+    advance(connection);
+  }
+
+  // Разобрать накопленный ввод, отдать следующий запрос пулу, отправить готовый вывод и обновить подписку
+  void advance(Connection& connection) {
+    parseInput(connection);
+    dispatchNext(connection);
+    flush(connection);
+    if (connection.fd < 0) {
+      return;
+    }
+    if (connection.output.empty() && !connection.busy && connection.pending.empty() &&
+        (connection.closeAfterWrite || connection.noMoreRequests || restingWhileShuttingDown(connection))) {
+      closeConnection(connection);
+      return;
+    }
+    updateInterest(connection);
+  }
+
+  // Соединение ждёт следующего запроса, не начав его: при остановке такое закрывается сразу.
+  // Новому соединению (ещё без запросов) даётся время прислать первый запрос — до idleTimeout
+  [[nodiscard]] bool restingWhileShuttingDown(const Connection& connection) const {
+    return shuttingDown_ && connection.requests > 0 && connection.inputOffset == connection.input.size();
+  }
+
+  void beginShutdown() {
+    shuttingDown_ = true;
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, listenFd_, nullptr);
+    // Последний цикл забирает то, что успело встать в очередь, и закрывает сокет: пока он открыт, SO_REUSEPORT
+    // продолжает направлять в него соединения, а при закрытии очередь сбрасывается
+    if (server_.activeListeners_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      acceptConnections();
+      server_.closeListener();
+    }
+    for (auto& [id, connection] : connections_) {
+      if (connection->fd >= 0) {
+        advance(*connection);
+      }
+    }
+    reap();
+  }
+
+  void parseInput(Connection& connection) {
+    const std::size_t maxPipelined = server_.options_.maxPipelined;
+    while (!connection.noMoreRequests && connection.pending.size() < maxPipelined) {
+      std::size_t consumed = 0;
+      const auto status =
+          connection.parser.parse(std::string_view{connection.input}.substr(connection.inputOffset), consumed);
+      connection.inputOffset += consumed;
+
+      if (status == HttpRequestParser::Status::NeedMore) {
+        if (connection.peerClosed) {
+          // Недописанный запрос уже не придёт
+          connection.noMoreRequests = true;
+        } else if (connection.parser.takeContinueRequest() && !connection.busy && connection.pending.empty()) {
+          // Иначе "100 Continue" обогнал бы ответы на предыдущие запросы; клиент отправит тело по своему таймауту
+          queue(connection, "HTTP/1.1 100 Continue\r\n\r\n", nullptr);
+        }
+        break;
+      }
+
+      if (status == HttpRequestParser::Status::Error) {
+        connection.pending.push_back(Pending{.request = {}, .keepAlive = false,
+                                             .errorStatus = connection.parser.errorStatus()});
+        connection.noMoreRequests = true;
+        break;
+      }
+
+      // При остановке запрос обслуживается последним на соединении
+      const bool keepAlive = connection.parser.keepAlive() && !shuttingDown_;
+      ++connection.requests;
+      Pending next{.request = connection.parser.take(), .keepAlive = keepAlive, .errorStatus = 0};
+      next.request.remote_addr = connection.remoteAddr;
+      connection.pending.push_back(std::move(next));
+      if (!keepAlive) {
+        connection.noMoreRequests = true;
+      }
+    }
+
+    if (connection.inputOffset == connection.input.size()) {
+      connection.input.clear();
+      connection.inputOffset = 0;
+    } else if (connection.inputOffset >= kCompactThreshold) {
+      connection.input.erase(0, connection.inputOffset);
+      connection.inputOffset = 0;
+    }
+  }
+
+  void dispatchNext(Connection& connection) {
+    if (connection.busy || connection.pending.empty()) {
+      return;
+    }
+    auto next = std::make_shared<Pending>(std::move(connection.pending.front()));
+    connection.pending.pop_front();
+
+    if (next->errorStatus != 0) {
+      httplib::Response response;
+      response.status = next->errorStatus;
+      queue(connection, serializeHead(response, 0, false, true), nullptr);
+      connection.closeAfterWrite = true;
+      connection.pending.clear();
+      return;
+    }
+
+    connection.busy = true;
+    // Маршрут выбирается здесь: корутины уходят в исполнитель, обычные обработчики — в пул
+    const Router::Route* route = server_.router_.match(next->request);
+    if (route && route->asyncHandler) {
+      server_.handleAsync(*this, connection.id, *route, std::shared_ptr<httplib::Request>(next, &next->request),
+                          next->keepAlive);
+      return;
+    }
+    server_.workers_->submit([this, id = connection.id, next, route] {
+      server_.handle(*this, id, route, next->request, next->keepAlive);
+    });
+  }
+
+  void queue(Connection& connection, std::string data, std::shared_ptr<StreamChannel> credit) {
+    if (!data.empty()) {
+      connection.output.push_back(OutPiece{std::move(data), std::move(credit)});
+    }
+  }
+
+  void drainMailbox() {
+    {
+      std::lock_guard<std::mutex> lock(mailboxMutex_);
+      draining_.swap(mailbox_);
+    }
+    for (auto& delivery : draining_) {
+      auto it = connections_.find(delivery.connection);
+      if (it == connections_.end() || it->second->fd < 0) {
+        if (delivery.channel) {
+          delivery.channel->close();
+        }
+        continue;
+      }
+
+      Connection& connection = *it->second;
+      if (delivery.channel) {
+        connection.stream = delivery.channel;
+      }
+      for (auto& piece : delivery.pieces) {
+        queue(connection, std::move(piece), delivery.counted ? delivery.channel : nullptr);
+      }
+      // Время на отправку ответа отсчитывается заново: медленный обработчик — не простой клиента
+      connection.lastActivity = std::chrono::steady_clock::now();
+      if (delivery.last) {
+        connection.busy = false;
+        connection.stream.reset();
+        if (delivery.close) {
+          connection.closeAfterWrite = true;
+          connection.noMoreRequests = true;
+          connection.pending.clear();
+        }
+      }
+      advance(connection);
+    }
+    draining_.clear();
+  }
+
+  void flush(Connection& connection) {
+    while (!connection.output.empty()) {
+      std::array<iovec, kMaxIovecs> iov{};
+      std::size_t count = 0;
+      std::size_t offset = connection.outputOffset;
+      for (auto it = connection.output.begin(); it != connection.output.end() && count < kMaxIovecs; ++it) {
+        iov[count].iov_base = it->data.data() + offset;
+        iov[count].iov_len = it->data.size() - offset;
+        offset = 0;
+        ++count;
+      }
+
+      // sendmsg — тот же writev, но MSG_NOSIGNAL не даёт SIGPIPE на закрытом клиентом сокете
+      msghdr message{};
+      message.msg_iov = iov.data();
+      message.msg_iovlen = count;
+      const ssize_t sent = ::sendmsg(connection.fd, &message, MSG_NOSIGNAL);
+      if (sent < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+          closeConnection(connection);
+        }
+        return;
+      }
+
+      connection.lastActivity = std::chrono::steady_clock::now();
+      auto remaining = static_cast<std::size_t>(sent);
+      while (remaining > 0) {
+        OutPiece& front = connection.output.front();
+        const std::size_t left = front.data.size() - connection.outputOffset;
+        if (remaining < left) {
+          connection.outputOffset += remaining;
+          break;
+        }
+        remaining -= left;
+        if (front.credit) {
+          front.credit->release(front.data.size());
+        }
+        connection.output.pop_front();
+        connection.outputOffset = 0;
+      }
+    }
+  }
+
+  void updateInterest(Connection& connection) {
+    const bool wantsRead = !connection.peerClosed && !connection.noMoreRequests &&
+                           connection.pending.size() < server_.options_.maxPipelined;
+    const std::uint32_t events = (wantsRead ? EPOLLIN : 0U) | (connection.output.empty() ? 0U : EPOLLOUT);
+    if (events == connection.events) {
+      return;
+    }
+    epoll_event event{};
+    event.events = events;
+    event.data.u64 = connection.id;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_MOD, connection.fd, &event) != 0) {
+      closeConnection(connection);
+      return;
+    }
+    connection.events = events;
+  }
+
+  // Само соединение удаляется в reap(): на него ещё могут ссылаться события текущей пачки
+  void closeConnection(Connection& connection) {
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, connection.fd, nullptr);
+    ::close(connection.fd);
+    connection.fd = -1;
+    if (connection.stream) {
+      connection.stream->close();
+    }
+    connection.output.clear();
+    connection.pending.clear();
+    closed_.push_back(connection.id);
+    openConnections_.add(-1);
+  }
+
+  void reap() {
+    for (const auto id : closed_) {
+      connections_.erase(id);
+    }
+    closed_.clear();
+  }
+
+  void closeIdle(std::chrono::steady_clock::time_point now) {
+    const auto timeout = server_.options_.idleTimeout;
+    for (auto& [id, connection] : connections_) {
+      if (connection->fd < 0) {
+        continue;
+      }
+      // Пока работает обработчик, соединение не простаивает — если только клиент не перестал забирать ответ
+      if (connection->busy && connection->output.empty()) {
+        continue;
+      }
+      if (now - connection->lastActivity >= timeout) {
+        closeConnection(*connection);
+      }
+    }
+  }
+};
+
+EventLoopServer::EventLoopServer(const Router& router, core::Executor& executor, EventLoopServerOptions options)
+    : router_(router), executor_(executor), options_(options) {
+  const std::size_t cores = std::max(1U, std::thread::hardware_concurrency());
+  if (options_.loops == 0) {
+    options_.loops = cores;
+  }
+  if (options_.workers == 0) {
+    options_.workers = std::max<std::size_t>(8, cores - 1);
+  }
+}
+
+EventLoopServer::~EventLoopServer() {
+  stop();
+  workers_.reset();
+  loops_.clear();
+  closeListener();
+}
+
+bool EventLoopServer::listen(const std::string& host, int port) { return bind(host, port) && listenAfterBind(); }
+
+bool EventLoopServer::bind(const std::string& host, int port) {
+  if (listenFd_ < 0) {
+    listenFd_ = openListener(host, port, options_.reusePort);
+  }
+  return listenFd_ >= 0;
+}
+
+bool EventLoopServer::listenAfterBind() {
+  if (listenFd_ < 0) {
+    return false;
+  }
+  const int listenFd = listenFd_;
+
+  try {
+    workers_ = std::make_unique<WorkerPool>(options_.workers);
+    loops_.reserve(options_.loops);
+    for (std::size_t i = 0; i < options_.loops; ++i) {
+      loops_.push_back(std::make_unique<Loop>(*this, listenFd));
+    }
+  } catch (const std::exception& ex) {
+    AUCTION_LOG_ERROR("Failed to start event loop HTTP server").field("error", ex.what());
+    workers_.reset();
+    loops_.clear();
+    closeListener();
+    return false;
+  }
+  activeListeners_.store(loops_.size(), std::memory_order_release);
+
+  AUCTION_LOG_INFO("Event loop HTTP server is listening")
+      .field("loops", options_.loops)
+      .field("workers", options_.workers);
+
+  // Первый цикл работает в вызывающем потоке, как и httplib::Server::listen
+  std::vector<std::thread> threads;
+  threads.reserve(loops_.size() - 1);
+  for (std::size_t i = 1; i < loops_.size(); ++i) {
+    threads.emplace_back([loop = loops_[i].get()] { loop->run(); });
+  }
+  loops_.front()->run();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Корутины обработчиков держат ссылки на циклы: разбирать их можно, только когда корутины завершились
+  {
+    std::unique_lock<std::mutex> lock(asyncMutex_);
+    asyncDone_.wait(lock, [this] { return asyncInFlight_ == 0; });
+  }
+
+  // Циклы закрыли соединения и каналы потоковых ответов, поэтому обработчики в пуле не повиснут
+  workers_.reset();
+  loops_.clear();
+  closeListener();
+  return true;
+}
+
+void EventLoopServer::closeListener() {
+  if (listenFd_ >= 0) {
+    ::close(std::exchange(listenFd_, -1));
+  }
+}
+
+void EventLoopServer::stop() { stopping_.store(true, std::memory_order_release); }
+
+void EventLoopServer::handle(Loop& loop, std::uint64_t connection, const Router::Route* route,
+                             httplib::Request& request, bool keepAlive) {
+  httplib::Response response;
+  try {
+    if (route) {
+      route->handler(request, response);
+    } else {
+      response.status = 404;
+    }
+  } catch (...) {
+    handlerFailed(request, response, std::current_exception());
+  }
+  respond(loop, connection, request, response, keepAlive);
+}
+
+void EventLoopServer::handleAsync(Loop& loop, std::uint64_t connection, const Router::Route& route,
+                                  std::shared_ptr<httplib::Request> request, bool keepAlive) {
+  {
+    std::lock_guard<std::mutex> lock(asyncMutex_);
+    ++asyncInFlight_;
+  }
+  executor_.spawn(runAsync(loop, connection, route, std::move(request), keepAlive));
+}
+
+core::Task<void> EventLoopServer::runAsync(Loop& loop, std::uint64_t connection, const Router::Route& route,
+                                           std::shared_ptr<httplib::Request> request, bool keepAlive) {
+  httplib::Response response;
+  try {
+    co_await route.asyncHandler(*request, response);
+  } catch (...) {
+    handlerFailed(*request, response, std::current_exception());
+  }
+
+  if (response.content_provider_) {
+    // Провайдер тела пишет синхронно и ждёт, пока клиент заберёт данные, — это работа для пула
+    workers_->submit([this, &loop, connection, request, keepAlive,
+                      body = std::make_shared<httplib::Response>(std::move(response))] {
+      respond(loop, connection, *request, *body, keepAlive);
+    });
+  } else {
+    respond(loop, connection, *request, response, keepAlive);
+  }
+
+  std::lock_guard<std::mutex> lock(asyncMutex_);
+  if (--asyncInFlight_ == 0) {
+    asyncDone_.notify_all();
+  }
+}
+
+void EventLoopServer::handlerFailed(const httplib::Request& request, httplib::Response& response,
+                                    const std::exception_ptr& error) {
+  try {
+    std::rethrow_exception(error);
+  } catch (const std::exception& ex) {
+    AUCTION_LOG_ERROR("Unhandled exception in HTTP handler").field("path", request.path).field("error", ex.what());
+  } catch (...) {
+    AUCTION_LOG_ERROR("Unhandled exception in HTTP handler").field("path", request.path);
+  }
+  response = httplib::Response{};
+  response.status = 500;
+}
+
+void EventLoopServer::respond(Loop& loop, std::uint64_t connection, const httplib::Request& request,
+                              httplib::Response& response, bool keepAlive) {
+  // Обработчик не выставил статус — как и httplib, считаем ответ успешным
+  if (response.status == -1) {
+    response.status = 200;
+  }
+
+  const bool close = !keepAlive || stopping_.load(std::memory_order_acquire);
+  const bool head = request.method == "HEAD";
+  if (response.content_provider_ && !head && !bodyForbidden(response.status)) {
+    stream(loop, connection, response, close);
+    return;
+  }
+
+  std::optional<std::size_t> length = response.body.size();
+  if (response.content_provider_) {
+    length = response.is_chunked_content_provider_ ? std::nullopt : std::optional{response.content_length_};
+  }
+  Delivery delivery{.connection = connection,
+                    .pieces = {serializeHead(response, length, response.is_chunked_content_provider_, close)},
+                    .channel = nullptr,
+                    .counted = false,
+                    .last = true,
+                    .close = close};
+  if (!head && !bodyForbidden(response.status)) {
+    delivery.pieces.push_back(std::move(response.body));
+  }
+  loop.deliver(std::move(delivery));
+}
+
+void EventLoopServer::stream(Loop& loop, std::uint64_t connection, httplib::Response& response, bool close) {
+  // Длина известна — тело идёт как есть; иначе chunked, а провайдер без длины пишет до закрытия соединения
+  const bool chunked = response.is_chunked_content_provider_;
+  const bool sized = !chunked && response.content_length_ > 0;
+  close = close || (!chunked && !sized);
+
+  auto channel = std::make_shared<StreamChannel>(options_.streamBufferBytes);
+  loop.deliver(Delivery{
+      .connection = connection,
+      .pieces = {serializeHead(response, sized ? std::optional{response.content_length_} : std::nullopt, chunked,
+                               close)},
+      .channel = channel,
+      .counted = false,
+      .last = false,
+      .close = false});
+
+  std::size_t offset = 0;
+  bool done = false;
+  httplib::DataSink sink;
+  sink.write = [&](const char* data, std::size_t length) {
+    if (length == 0) {
+      return true;
+    }
+    std::string piece = chunked ? chunkFrame(data, length) : std::string{data, length};
+    if (!channel->acquire(piece.size())) {
+      return false;
+    }
+    Delivery delivery{.connection = connection, .pieces = {}, .channel = channel, .counted = true, .last = false,
+                      .close = false};
+    delivery.pieces.push_back(std::move(piece));
+    loop.deliver(std::move(delivery));
+    offset += length;
+    return true;
+  };
+  sink.is_writable = [&channel] { return !channel->isClosed(); };
+  sink.done = [&done] { done = true; };
+
+  bool ok = true;
+  try {
+    while (ok && !done && !(sized && offset >= response.content_length_)) {
+      ok = response.content_provider_(offset, sized ? response.content_length_ - offset : 0, sink);
+    }
+  } catch (const std::exception& ex) {
+    AUCTION_LOG_ERROR("Streaming response failed").field("error", ex.what());
+    ok = false;
+  }
+
+  Delivery last{.connection = connection, .pieces = {}, .channel = channel, .counted = false, .last = true,
+                .close = close};
+  if (!ok || (sized && offset != response.content_length_)) {
+    // Заголовки уже ушли: обрываем соединение, клиент увидит незавершённое тело
+    last.close = true;
+  } else if (chunked) {
+    last.pieces.emplace_back("0\r\n\r\n");
+  }
+  loop.deliver(std::move(last));
+}
+
+}  // namespace auction::api
@@ -0,0 +1,300 @@
+#include "auction/api/http_parser.h"
+
+#include <algorithm>
+#include <charconv>
+#include <string>
+#include <utility>
+
+namespace auction::api {
+
+namespace {
+
+// Строка размера чанка с расширениями или строка trailer-заголовка
+constexpr std::size_t kMaxLineBytes = 4096;
+
+char toLowerAscii(char ch) { return ch >= 'A' && ch <= 'Z' ? static_cast<char>(ch - 'A' + 'a') : ch; }
+
+bool equalsIgnoreCase(std::string_view left, std::string_view right) {
+  if (left.size() != right.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < left.size(); ++i) {
+    if (toLowerAscii(left[i]) != toLowerAscii(right[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string_view trim(std::string_view value) {
+  while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+    value.remove_prefix(1);
+  }
+  while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+    value.remove_suffix(1);
+  }
+  return value;
+}
+
+// Есть ли token в списке через запятую ("keep-alive, Upgrade")
+bool hasToken(std::string_view list, std::string_view token) {
+  while (!list.empty()) {
+    const auto comma = list.find(',');
+    if (equalsIgnoreCase(trim(list.substr(0, comma)), token)) {
+      return true;
+    }
+    if (comma == std::string_view::npos) {
+      break;
+    }
+    list.remove_prefix(comma + 1);
+  }
+  return false;
+}
+
+bool isTokenChar(char ch) {
+  const auto byte = static_cast<unsigned char>(ch);
+  return byte > 0x20 && byte < 0x7F && ch != ':' && ch != '(' && ch != ')' && ch != '"' && ch != ',';
+}
+
+}  // namespace
+
+HttpRequestParser::HttpRequestParser(HttpLimits limits) : limits_(limits) {}
+
+HttpRequestParser::Status HttpRequestParser::parse(std::string_view input, std::size_t& consumed) {
+  consumed = 0;
+  for (;;) {
+    switch (stage_) {
+      case Stage::Head: {
+        // Пустые строки перед строкой запроса допускаются (RFC 9112, 2.2)
+        while (scanFrom_ == 0 && input.size() >= 2 && input[0] == '\r' && input[1] == '\n') {
+          input.remove_prefix(2);
+          consumed += 2;
+        }
+        const auto end = input.find("\r\n\r\n", scanFrom_);
+        if (end == std::string_view::npos) {
+          if (input.size() > limits_.maxHeaderBytes) {
+            return fail(431);
+          }
+          // Разделитель может оказаться на стыке с ещё не пришедшими байтами
+          scanFrom_ = input.size() >= 3 ? input.size() - 3 : 0;
+          return Status::NeedMore;
+        }
+        if (end + 4 > limits_.maxHeaderBytes) {
+          return fail(431);
+        }
+        scanFrom_ = 0;
+        if (!parseHead(input.substr(0, end + 2))) {
+          return Status::Error;
+        }
+        input.remove_prefix(end + 4);
+        consumed += end + 4;
+        break;
+      }
+
+      case Stage::Body:
+      case Stage::ChunkData: {
+        const std::size_t take = std::min(remaining_, input.size());
+        request_.body.append(input.data(), take);
+        input.remove_prefix(take);
+        consumed += take;
+        remaining_ -= take;
+        if (remaining_ != 0) {
+          return Status::NeedMore;
+        }
+        stage_ = stage_ == Stage::Body ? Stage::Done : Stage::ChunkDataEnd;
+        break;
+      }
+
+      case Stage::ChunkSize: {
+        const auto end = input.find("\r\n");
+        if (end == std::string_view::npos) {
+          return input.size() > kMaxLineBytes ? fail(400) : Status::NeedMore;
+        }
+        // Расширения чанка (";name=value") не поддерживаются и пропускаются
+        const std::string_view line = trim(input.substr(0, std::min(end, input.find(';'))));
+        std::size_t size = 0;
+        const auto [next, error] = std::from_chars(line.data(), line.data() + line.size(), size, 16);
+        if (line.empty() || error != std::errc{} || next != line.data() + line.size()) {
+          return fail(400);
+        }
+        if (size > limits_.maxBodyBytes - request_.body.size()) {
+          return fail(413);
+        }
+        input.remove_prefix(end + 2);
+        consumed += end + 2;
+        remaining_ = size;
+        stage_ = size == 0 ? Stage::Trailer : Stage::ChunkData;
+        break;
+      }
+
+      case Stage::ChunkDataEnd: {
+        if (input.size() < 2) {
+          return Status::NeedMore;
+        }
+        if (input[0] != '\r' || input[1] != '\n') {
+          return fail(400);
+        }
+        input.remove_prefix(2);
+        consumed += 2;
+        stage_ = Stage::ChunkSize;
+        break;
+      }
+
+      case Stage::Trailer: {
+        // Trailer-заголовки обработчикам не нужны: пропускаем до пустой строки
+        const auto end = input.find("\r\n");
+        if (end == std::string_view::npos) {
+          return input.size() > kMaxLineBytes ? fail(400) : Status::NeedMore;
+        }
+        input.remove_prefix(end + 2);
+        consumed += end + 2;
+        if (end == 0) {
+          stage_ = Stage::Done;
+        }
+        break;
+      }
+
+      case Stage::Done:
+        return Status::Complete;
+
+      case Stage::Failed:
+        return Status::Error;
+    }
+  }
+}
+
+httplib::Request HttpRequestParser::take() {
+  httplib::Request request = std::move(request_);
+  request_ = httplib::Request{};
+  stage_ = Stage::Head;
+  scanFrom_ = 0;
+  remaining_ = 0;
+  keepAlive_ = true;
+  expectContinue_ = false;
+  return request;
+}
+
+bool HttpRequestParser::takeContinueRequest() {
+  const bool waiting = expectContinue_ && request_.body.empty() &&
+                       (stage_ == Stage::Body || stage_ == Stage::ChunkSize);
+  expectContinue_ = false;
+  return waiting;
+}
+
+bool HttpRequestParser::parseHead(std::string_view head) {
+  // Строка запроса: METHOD SP target SP HTTP/1.x
+  const auto lineEnd = head.find("\r\n");
+  const std::string_view line = head.substr(0, lineEnd);
+  head.remove_prefix(lineEnd + 2);
+
+  const auto firstSpace = line.find(' ');
+  const auto secondSpace = line.find(' ', firstSpace + 1);
+  if (firstSpace == 0 || firstSpace == std::string_view::npos || secondSpace == std::string_view::npos ||
+      secondSpace == firstSpace + 1) {
+    fail(400);
+    return false;
+  }
+  const std::string_view method = line.substr(0, firstSpace);
+  const std::string_view target = line.substr(firstSpace + 1, secondSpace - firstSpace - 1);
+  const std::string_view version = line.substr(secondSpace + 1);
+  for (const char ch : method) {
+    if (!isTokenChar(ch)) {
+      fail(400);
+      return false;
+    }
+  }
+  if (version.size() != 8 || version.substr(0, 5) != "HTTP/") {
+    fail(400);
+    return false;
+  }
+  if (version.substr(5) != "1.1" && version.substr(5) != "1.0") {
+    fail(505);
+    return false;
+  }
+
+  request_.method = std::string{method};
+  request_.target = std::string{target};
+  request_.version = std::string{version};
+
+  // Путь и параметры запроса — так же, как их раскладывает httplib::Server
+  const auto query = target.find('?');
+  request_.path = httplib::detail::decode_url(std::string{target.substr(0, query)}, false);
+  if (query != std::string_view::npos) {
+    httplib::detail::parse_query_text(std::string{target.substr(query + 1)}, request_.params);
+  }
+
+  while (!head.empty()) {
+    const auto end = head.find("\r\n");
+    const std::string_view field = head.substr(0, end);
+    head.remove_prefix(end + 2);
+
+    // obs-fold (продолжение заголовка с пробела) запрещён RFC 9112
+    const auto colon = field.find(':');
+    if (colon == 0 || colon == std::string_view::npos) {
+      fail(400);
+      return false;
+    }
+    const std::string_view name = field.substr(0, colon);
+    for (const char ch : name) {
+      if (!isTokenChar(ch)) {
+        fail(400);
+        return false;
+      }
+    }
+    request_.headers.emplace(std::string{name}, std::string{trim(field.substr(colon + 1))});
+  }
+
+  const bool http11 = version == "HTTP/1.1";
+  const std::string connection = request_.get_header_value("Connection");
+  keepAlive_ = http11 ? !hasToken(connection, "close") : hasToken(connection, "keep-alive");
+  expectContinue_ = http11 && equalsIgnoreCase(request_.get_header_value("Expect"), "100-continue");
+
+  // Повторы Content-Length или Transfer-Encoding, как и оба заголовка сразу, — классический вектор request
+  // smuggling: прокси перед сервисом может взять другой из них и по-другому найти конец тела.
+  // Такой запрос отклоняется целиком, а после ответа 400 соединение закрывается (fail сбрасывает keepAlive)
+  const auto lengthHeaders = request_.headers.count("Content-Length");
+  const auto encodingHeaders = request_.headers.count("Transfer-Encoding");
+  if (lengthHeaders > 1 || encodingHeaders > 1 || (lengthHeaders != 0 && encodingHeaders != 0)) {
+    fail(400);
+    return false;
+  }
+
+  const bool hasLength = lengthHeaders != 0;
+  if (encodingHeaders != 0) {
+    // chunked обязан быть последним кодированием; другие (gzip и т. п.) не поддерживаются
+    const std::string encoding = request_.get_header_value("Transfer-Encoding");
+    if (!equalsIgnoreCase(trim(encoding), "chunked")) {
+      fail(501);
+      return false;
+    }
+    stage_ = Stage::ChunkSize;
+    return true;
+  }
+
+  std::size_t length = 0;
+  if (hasLength) {
+    const std::string value = request_.get_header_value("Content-Length");
+    const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), length);
+    if (value.empty() || error != std::errc{} || end != value.data() + value.size()) {
+      fail(400);
+      return false;
+    }
+    if (length > limits_.maxBodyBytes) {
+      fail(413);
+      return false;
+    }
+  }
+  request_.body.reserve(length);
+  remaining_ = length;
+  stage_ = length == 0 ? Stage::Done : Stage::Body;
+  return true;
+}
+
+HttpRequestParser::Status HttpRequestParser::fail(int status) {
+  stage_ = Stage::Failed;
+  errorStatus_ = status;
+  keepAlive_ = false;
+  return Status::Error;
+}
+
+}  // namespace auction::api
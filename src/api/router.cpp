@@ -0,0 +1,83 @@
+#include "auction/api/router.h"
+
+#include <string_view>
+#include <utility>
+
+namespace auction::api {
+
+Router& Router::get(const std::string& pattern, Handler handler) {
+  return add("GET", pattern, std::move(handler), nullptr);
+}
+
+Router& Router::post(const std::string& pattern, Handler handler) {
+  return add("POST", pattern, std::move(handler), nullptr);
+}
+
+Router& Router::put(const std::string& pattern, Handler handler) {
+  return add("PUT", pattern, std::move(handler), nullptr);
+}
+
+Router& Router::del(const std::string& pattern, Handler handler) {
+  return add("DELETE", pattern, std::move(handler), nullptr);
+}
+
+Router& Router::options(const std::string& pattern, Handler handler) {
+  return add("OPTIONS", pattern, std::move(handler), nullptr);
+}
+
+Router& Router::getAsync(const std::string& pattern, AsyncHandler handler) {
+  return add("GET", pattern, nullptr, std::move(handler));
+}
+
+Router& Router::postAsync(const std::string& pattern, AsyncHandler handler) {
+  return add("POST", pattern, nullptr, std::move(handler));
+}
+
+Router& Router::putAsync(const std::string& pattern, AsyncHandler handler) {
+  return add("PUT", pattern, nullptr, std::move(handler));
+}
+
+Router& Router::delAsync(const std::string& pattern, AsyncHandler handler) {
+  return add("DELETE", pattern, nullptr, std::move(handler));
+}
+
+Router& Router::add(const char* method, const std::string& pattern, Handler handler, AsyncHandler asyncHandler) {
+  routes_.push_back(Route{method, pattern, std::regex{pattern}, std::move(handler), std::move(asyncHandler)});
+  return *this;
+}
+
+void Router::mount(httplib::Server& server, core::Executor& executor) const {
+  for (const auto& route : routes_) {
+    Handler handler = route.handler;
+    if (route.asyncHandler) {
+      handler = [&executor, &route](const httplib::Request& req, httplib::Response& res) {
+        executor.syncWait(route.asyncHandler(req, res));
+      };
+    }
+
+    if (route.method == "GET") {
+      server.Get(route.pattern, std::move(handler));
+    } else if (route.method == "POST") {
+      server.Post(route.pattern, std::move(handler));
+    } else if (route.method == "PUT") {
+      server.Put(route.pattern, std::move(handler));
+    } else if (route.method == "DELETE") {
+      server.Delete(route.pattern, std::move(handler));
+    } else if (route.method == "OPTIONS") {
+      server.Options(route.pattern, std::move(handler));
+    }
+  }
+}
+
+const Router::Route* Router::match(httplib::Request& req) const {
+  const std::string_view method = req.method == "HEAD" ? std::string_view{"GET"} : std::string_view{req.method};
+  for (const auto& route : routes_) {
+    // matches ссылается на req.path, поэтому сопоставляем именно его, а не копию
+    if (route.method == method && std::regex_match(req.path, req.matches, route.regex)) {
+      return &route;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace auction::api
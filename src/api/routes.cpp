@@ -1,11 +1,22 @@
 #include "auction/api/routes.h"
 
-#include <iostream>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include <nlohmann/json.hpp>
 
+#include "auction/core/logger.h"
+#include "auction/core/metrics.h"
+#include "auction/model/bid.h"
+#include "auction/model/field_decoder.h"
+#include "auction/model/json_writer.h"
 #include "auction/model/lot.h"
 
 namespace auction::api {
@@ -16,52 +27,315 @@ void applyCorsHeaders(httplib::Response& res) {
   res.set_header("Access-Control-Allow-Origin", "*");
   res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
   res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
+  res.set_header("Access-Control-Expose-Headers", "X-Next-Cursor, Retry-After");
 }
 
-void respondJson(httplib::Response& res, int status, const nlohmann::json& body) {
+// Ориентир для reserve: типичный лот в JSON занимает 200–300 байт
+constexpr std::size_t kLotJsonSizeHint = 256;
+
+// content — уже сериализованное тело
+void respondJsonBody(httplib::Response& res, int status, std::string content) {
   res.status = status;
   applyCorsHeaders(res);
-  
-  std::string content;
+
   if (status == 204) {
-    content = "";
-  } else {
-    content = body.dump();
+    content.clear();
   }
-  
-  std::cerr << "=== HTTP Response ===" << std::endl;
-  std::cerr << "Status: " << status << std::endl;
-  std::cerr << "Body: " << (content.length() > 200 ? content.substr(0, 200) + "..." : content) << std::endl;
-  
-  res.set_content(content, "application/json");
+
+  AUCTION_LOG_DEBUG("HTTP response")
+      .field("status", status)
+      .field("body", std::string_view{content}.substr(0, 200))
+      .field("body_length", content.size());
+
+  res.set_content(std::move(content), "application/json");
+}
+
+void respondJson(httplib::Response& res, int status, const nlohmann::json& body) {
+  respondJsonBody(res, status, status == 204 ? std::string{} : body.dump());
 }
 
-bool requireAuth(const httplib::Request& req, httplib::Response& res, core::AuthService& authService,
-                 const std::string& methodName) {
+// Лоты пишутся напрямую, без промежуточного nlohmann::json; вывод совпадает с lot.toJson().dump()
+void respondLot(httplib::Response& res, int status, const model::Lot& lot) {
+  std::string content;
+  content.reserve(kLotJsonSizeHint);
+  model::json::appendLot(content, lot);
+  respondJsonBody(res, status, std::move(content));
+}
+
+void respondPayloadError(httplib::Response& res, const model::PayloadError& error) {
+  nlohmann::json body = {{"error", error.what()}};
+  if (!error.field().empty()) {
+    body["field"] = error.field();
+  }
+  respondJson(res, 400, body);
+}
+
+// Ограничитель нагрузки БД отказал: клиенту лучше повторить позже, чем ждать в растущей очереди
+void respondOverloaded(httplib::Response& res, const core::Overloaded& error) {
+  res.set_header("Retry-After", std::to_string(error.retryAfter().count()));
+  respondJson(res, 503, {{"error", error.what()}});
+}
+
+// Токен из заголовка Authorization; если заголовка нет или он не Bearer, отвечает 401
+std::optional<std::string> bearerToken(const httplib::Request& req, httplib::Response& res) {
   const auto& authHeader = req.get_header_value("Authorization");
   if (authHeader.empty()) {
     respondJson(res, 401, {{"error", "Missing Authorization header"}});
-    return false;
+    return std::nullopt;
   }
 
   constexpr std::string_view bearer = "Bearer ";
   if (authHeader.size() <= bearer.size() || authHeader.compare(0, bearer.size(), bearer) != 0) {
     respondJson(res, 401, {{"error", "Invalid Authorization header"}});
-    return false;
+    return std::nullopt;
+  }
+
+  return authHeader.substr(bearer.size());
+}
+
+void respondTokenRejected(const httplib::Request& req, httplib::Response& res, const std::string& methodName) {
+  AUCTION_LOG_INFO("Token rejected").field("method", methodName).field("path", req.path);
+  respondJson(res, 403, {{"error", "Invalid token"}});
+}
+
+void respondAuthFailed(httplib::Response& res, const std::string& methodName, const std::exception& ex) {
+  AUCTION_LOG_WARN("Token verification failed").field("method", methodName).field("error", ex.what());
+  respondJson(res, 502, {{"error", ex.what()}});
+}
+
+// Проверка токена в платёжном сервисе; ожидание ответа не занимает поток исполнителя
+core::Task<bool> requireAuthTask(const httplib::Request& req, httplib::Response& res,
+                                 core::AuthService& authService, std::string methodName) {
+  auto token = bearerToken(req, res);
+  if (!token) {
+    co_return false;
   }
 
-  const std::string token = authHeader.substr(bearer.size());
   try {
-    if (!authService.verifyToken(token, methodName)) {
-      respondJson(res, 403, {{"error", "Invalid token"}});
-      return false;
+    if (!co_await authService.verifyTokenTask(std::move(*token), methodName)) {
+      respondTokenRejected(req, res, methodName);
+      co_return false;
     }
   } catch (const std::exception& ex) {
-    respondJson(res, 502, {{"error", ex.what()}});
-    return false;
+    respondAuthFailed(res, methodName, ex);
+    co_return false;
+  }
+
+  co_return true;
+}
+
+// Коды, которые отдаёт сервис; остальные попадают в status="other"
+constexpr std::array<int, 10> kTrackedStatuses = {200, 201, 204, 400, 401, 403, 404, 500, 502, 503};
+
+struct RouteMetrics {
+  core::metrics::Histogram& latency;
+  core::metrics::Gauge& inFlight;
+  std::array<core::metrics::Counter*, kTrackedStatuses.size()> byStatus{};
+  core::metrics::Counter* otherStatus{nullptr};
+
+  explicit RouteMetrics(const std::string& route)
+      : latency(core::metrics::Registry::instance().histogram(
+            "auction_http_request_duration_seconds", "HTTP handler duration by route", {{"route", route}})),
+        inFlight(core::metrics::Registry::instance().gauge("auction_http_requests_in_flight",
+                                                           "HTTP requests being handled", {{"route", route}})) {
+    auto& registry = core::metrics::Registry::instance();
+    for (std::size_t i = 0; i < kTrackedStatuses.size(); ++i) {
+      byStatus[i] = &registry.counter("auction_http_requests_total", "HTTP requests by route and status",
+                                      {{"route", route}, {"status", std::to_string(kTrackedStatuses[i])}});
+    }
+    otherStatus = &registry.counter("auction_http_requests_total", "HTTP requests by route and status",
+                                    {{"route", route}, {"status", "other"}});
+  }
+
+  void finish(int status, std::chrono::steady_clock::time_point start) {
+    latency.observe(std::chrono::steady_clock::now() - start);
+    inFlight.add(-1);
+    for (std::size_t i = 0; i < kTrackedStatuses.size(); ++i) {
+      if (kTrackedStatuses[i] == status) {
+        byStatus[i]->inc();
+        return;
+      }
+    }
+    otherStatus->inc();
   }
+};
+
+// Для потоковых ответов время считается до отдачи заголовков: тело пишется уже после выхода из обработчика
+httplib::Server::Handler instrument(const std::string& route, httplib::Server::Handler handler) {
+  auto metrics = std::make_shared<RouteMetrics>(route);
+  return [metrics, handler = std::move(handler)](const httplib::Request& req, httplib::Response& res) {
+    metrics->inFlight.add(1);
+    const auto start = std::chrono::steady_clock::now();
+    try {
+      handler(req, res);
+    } catch (...) {
+      metrics->finish(500, start);
+      throw;
+    }
+    metrics->finish(res.status, start);
+  };
+}
 
-  return true;
+core::Task<void> observe(std::shared_ptr<RouteMetrics> metrics, const Router::AsyncHandler& handler,
+                         const httplib::Request& req, httplib::Response& res) {
+  metrics->inFlight.add(1);
+  const auto start = std::chrono::steady_clock::now();
+  try {
+    co_await handler(req, res);
+  } catch (...) {
+    metrics->finish(500, start);
+    throw;
+  }
+  metrics->finish(res.status, start);
+}
+
+// Время считается до завершения корутины, а не до первой приостановки. Обёртка и сам обработчик
+// хранятся в Router, поэтому ссылки на них действительны всё время выполнения корутины
+Router::AsyncHandler instrumentAsync(const std::string& route, Router::AsyncHandler handler) {
+  auto metrics = std::make_shared<RouteMetrics>(route);
+  return [metrics, handler = std::move(handler)](const httplib::Request& req, httplib::Response& res) {
+    return observe(metrics, handler, req, res);
+  };
+}
+
+void registerStatsCollectors(core::AuthService& authService, const core::Database& database,
+                             const service::LotService& lotService) {
+  using core::metrics::writeHeader;
+  using core::metrics::writeSample;
+
+  core::metrics::Registry::instance().addCollector([&authService, &database, &lotService](std::string& out) {
+    const auto tokens = authService.cacheStats();
+    writeHeader(out, "auction_token_cache_requests_total", "Token cache lookups by result", "counter");
+    writeSample(out, "auction_token_cache_requests_total", {{"result", "hit"}}, static_cast<double>(tokens.hits));
+    writeSample(out, "auction_token_cache_requests_total", {{"result", "miss"}}, static_cast<double>(tokens.misses));
+    writeHeader(out, "auction_token_cache_evictions_total", "Token cache entries removed", "counter");
+    writeSample(out, "auction_token_cache_evictions_total", {{"reason", "capacity"}},
+                static_cast<double>(tokens.evictions));
+    writeSample(out, "auction_token_cache_evictions_total", {{"reason", "expired"}},
+                static_cast<double>(tokens.expirations));
+    writeHeader(out, "auction_token_cache_entries", "Token cache size", "gauge");
+    writeSample(out, "auction_token_cache_entries", {}, static_cast<double>(tokens.size));
+
+    const auto pool = database.poolStats();
+    writeHeader(out, "auction_db_pool_connections", "Database pool connections by state", "gauge");
+    writeSample(out, "auction_db_pool_connections", {{"state", "idle"}}, static_cast<double>(pool.idle));
+    writeSample(out, "auction_db_pool_connections", {{"state", "in_use"}}, static_cast<double>(pool.inUse));
+    writeHeader(out, "auction_db_pool_waiters", "Callers waiting for a database connection", "gauge");
+    writeSample(out, "auction_db_pool_waiters", {}, static_cast<double>(pool.waiters));
+    writeHeader(out, "auction_db_pool_checkout_timeouts_total", "Database pool checkout timeouts", "counter");
+    writeSample(out, "auction_db_pool_checkout_timeouts_total", {}, static_cast<double>(pool.timeouts));
+    writeHeader(out, "auction_db_pool_wait_seconds_total", "Total time spent waiting for a connection", "counter");
+    writeSample(out, "auction_db_pool_wait_seconds_total", {},
+                std::chrono::duration<double>(pool.totalWait).count());
+
+    const auto limiter = database.limiterStats();
+    writeHeader(out, "auction_db_limiter_limit", "Adaptive limit of concurrent database calls", "gauge");
+    writeSample(out, "auction_db_limiter_limit", {}, static_cast<double>(limiter.limit));
+    writeHeader(out, "auction_db_limiter_in_flight", "Database calls admitted by the limiter", "gauge");
+    writeSample(out, "auction_db_limiter_in_flight", {}, static_cast<double>(limiter.inFlight));
+    writeHeader(out, "auction_db_limiter_queued", "Database calls waiting in the limiter queue", "gauge");
+    writeSample(out, "auction_db_limiter_queued", {}, static_cast<double>(limiter.queued));
+    writeHeader(out, "auction_db_limiter_overloaded", "1 while the limiter queue is standing and sheds load", "gauge");
+    writeSample(out, "auction_db_limiter_overloaded", {}, limiter.overloaded ? 1.0 : 0.0);
+    writeHeader(out, "auction_db_limiter_rejected_total", "Database calls rejected with 503", "counter");
+    writeSample(out, "auction_db_limiter_rejected_total", {}, static_cast<double>(limiter.rejected));
+
+    const auto lots = lotService.lotCacheStats();
+    if (!lots) {
+      return;
+    }
+    writeHeader(out, "auction_lot_cache_requests_total", "Lot cache lookups by result", "counter");
+    writeSample(out, "auction_lot_cache_requests_total", {{"result", "hit"}}, static_cast<double>(lots->hits));
+    writeSample(out, "auction_lot_cache_requests_total", {{"result", "miss"}}, static_cast<double>(lots->misses));
+    writeHeader(out, "auction_lot_cache_evictions_total", "Lot cache entries removed", "counter");
+    writeSample(out, "auction_lot_cache_evictions_total", {{"reason", "capacity"}},
+                static_cast<double>(lots->evictions));
+    writeSample(out, "auction_lot_cache_evictions_total", {{"reason", "changed"}},
+                static_cast<double>(lots->invalidations));
+    writeHeader(out, "auction_lot_cache_entries", "Lot cache size", "gauge");
+    writeSample(out, "auction_lot_cache_entries", {}, static_cast<double>(lots->size));
+    writeHeader(out, "auction_lot_cache_coherent", "1 while change notifications are received", "gauge");
+    writeSample(out, "auction_lot_cache_coherent", {}, lots->coherent ? 1.0 : 0.0);
+  });
+}
+
+constexpr std::size_t kDefaultPageSize = 50;
+
+std::size_t parsePageLimit(const httplib::Request& req) {
+  if (!req.has_param("limit")) {
+    return kDefaultPageSize;
+  }
+
+  const auto value = req.get_param_value("limit");
+  std::size_t limit = 0;
+  const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), limit);
+  if (error != std::errc{} || end != value.data() + value.size()) {
+    throw std::invalid_argument("Invalid limit");
+  }
+  return limit;
+}
+
+constexpr std::size_t kStreamChunkSize = 16 * 1024;
+
+// Без limit/after список отдаётся потоком: строки сериализуются в сокет по мере чтения из БД.
+// Разрешение ограничителя и соединение берутся до заголовков, чтобы отказ ушёл как 503, а не оборванный 200
+core::Task<void> streamLots(httplib::Response& res, service::LotService& lotService) {
+  std::shared_ptr<repository::LotRepository::Stream> stream;
+  try {
+    stream = std::make_shared<repository::LotRepository::Stream>(co_await lotService.openLotStreamTask());
+  } catch (const core::Overloaded& ex) {
+    respondOverloaded(res, ex);
+    co_return;
+  } catch (const std::exception& ex) {
+    respondJson(res, 500, {{"error", ex.what()}});
+    co_return;
+  }
+
+  res.status = 200;
+  applyCorsHeaders(res);
+  // Провайдер хранится в std::function и должен копироваться, поэтому поток — через shared_ptr.
+  // Если тело так и не запросят, соединение вернётся в пул вместе с ответом
+  res.set_chunked_content_provider("application/json", [stream](std::size_t, httplib::DataSink& sink) {
+    bool first = true;
+    bool clientGone = false;
+    auto write = [&](const std::string& chunk) {
+      if (!sink.write(chunk.data(), chunk.size())) {
+        clientGone = true;
+      }
+      return !clientGone;
+    };
+
+    // Строки копятся в одном буфере и уходят в сокет порциями, а не отдельным чанком на каждый лот
+    std::string chunk;
+    chunk.reserve(kStreamChunkSize + kLotJsonSizeHint);
+    chunk.push_back('[');
+    try {
+      stream->forEach([&](const model::Lot& lot) {
+        if (!first) {
+          chunk.push_back(',');
+        }
+        first = false;
+        model::json::appendLot(chunk, lot);
+        if (chunk.size() < kStreamChunkSize) {
+          return true;
+        }
+        const bool sent = write(chunk);
+        chunk.clear();
+        return sent;
+      });
+      chunk.push_back(']');
+      if (clientGone || !write(chunk)) {
+        return false;
+      }
+    } catch (const std::exception& ex) {
+      // Заголовки уже отправлены: обрываем ответ без завершающего чанка, клиент увидит ошибку
+      AUCTION_LOG_ERROR("GET /lots stream failed").field("error", ex.what());
+      return false;
+    }
+
+    sink.done();
+    return true;
+  });
 }
 
 }  // namespace
@@ -75,36 +349,12 @@ core::ApiArgument makeArgument(int number, std::string name, std::string type, b
   };
 }
 
-void applyLotPatch(model::Lot& lot, const nlohmann::json& body) {
-  if (body.contains("name") && !body.at("name").is_null()) {
-    lot.name = body.at("name").get<std::string>();
-  }
-  if (body.contains("description")) {
-    lot.description = body.at("description").is_null() ? std::optional<std::string>{}
-                                                      : std::optional<std::string>{body.at("description").get<std::string>()};
-  }
-  if (body.contains("owner_id")) {
-    lot.owner_id = body.at("owner_id").is_null() ? std::optional<std::string>{}
-                                                 : std::optional<std::string>{body.at("owner_id").get<std::string>()};
-  }
-  if (body.contains("auction_end_date")) {
-    lot.auction_end_date =
-        body.at("auction_end_date").is_null() ? std::optional<std::string>{}
-                                              : std::optional<std::string>{body.at("auction_end_date").get<std::string>()};
-  }
-  if (body.contains("start_price") && !body.at("start_price").is_null()) {
-    lot.start_price = body.at("start_price").get<double>();
-  }
-  if (body.contains("current_price")) {
-    lot.current_price = body.at("current_price").is_null() ? std::optional<double>{}
-                                                           : std::optional<double>{body.at("current_price").get<double>()};
-  }
-}
-
-std::vector<core::ApiMethod> registerRoutes(httplib::Server& server, service::LotService& lotService,
-                                            core::AuthService& authService) {
-  std::vector<core::ApiMethod> methods = {
-      {.methodName = "ListLots", .price = 0.0, .isPrivate = false, .arguments = {}},
+std::vector<core::ApiMethod> apiMethods() {
+  return {
+      {.methodName = "ListLots",
+       .price = 0.0,
+       .isPrivate = false,
+       .arguments = {makeArgument(1, "limit", "int", false), makeArgument(2, "after", "string", false)}},
       {.methodName = "GetLot",
        .price = 0.0,
        .isPrivate = false,
@@ -138,157 +388,274 @@ std::vector<core::ApiMethod> registerRoutes(httplib::Server& server, service::Lo
       {.methodName = "PlaceBid",
        .price = 0.0,
        .isPrivate = false,
-       .arguments = {makeArgument(1, "id", "int", true), makeArgument(2, "amount", "decimal", true)}},
+       .arguments = {makeArgument(1, "id", "int", true), makeArgument(2, "amount", "decimal", true),
+                     makeArgument(3, "bidder_id", "string", false)}},
+      {.methodName = "ListBids",
+       .price = 0.0,
+       .isPrivate = false,
+       .arguments = {makeArgument(1, "id", "int", true), makeArgument(2, "limit", "int", false),
+                     makeArgument(3, "after", "string", false)}},
       {.methodName = "Health", .price = 0.0, .isPrivate = false, .arguments = {}},
   };
+}
 
-  server.Get("/health", [](const httplib::Request&, httplib::Response& res) { respondJson(res, 200, {{"status", "ok"}}); });
+std::vector<core::ApiMethod> registerRoutes(Router& router, service::LotService& lotService,
+                                            core::AuthService& authService, const core::Database& database,
+                                            std::optional<std::size_t> worker) {
+  router.get("/health", instrument("GET /health",
+                                   [&database, &authService, &lotService, worker](const httplib::Request&,
+                                                                                  httplib::Response& res) {
+    const auto pool = database.poolStats();
+    const auto limiter = database.limiterStats();
+    const auto tokens = authService.cacheStats();
+    nlohmann::json lotCache = nullptr;
+    if (const auto lots = lotService.lotCacheStats()) {
+      lotCache = {{"coherent", lots->coherent},
+                  {"size", lots->size},
+                  {"hits", lots->hits},
+                  {"misses", lots->misses},
+                  {"invalidations", lots->invalidations},
+                  {"evictions", lots->evictions}};
+    }
+    respondJson(res, 200,
+                {{"status", "ok"},
+                 // Счётчики ниже — только этого процесса; null в режиме одного процесса
+                 {"worker", worker ? nlohmann::json(*worker) : nlohmann::json(nullptr)},
+                 {"database_pool",
+                  {{"total", pool.total},
+                   {"idle", pool.idle},
+                   {"in_use", pool.inUse},
+                   {"waiters", pool.waiters},
+                   {"checkouts", pool.checkouts},
+                   {"timeouts", pool.timeouts},
+                   {"wait_us_total", pool.totalWait.count()},
+                   {"wait_us_max", pool.maxWait.count()}}},
+                 {"database_limiter",
+                  {{"limit", limiter.limit},
+                   {"in_flight", limiter.inFlight},
+                   {"queued", limiter.queued},
+                   {"overloaded", limiter.overloaded},
+                   {"admitted", limiter.admitted},
+                   {"rejected", limiter.rejected},
+                   {"latency_us", limiter.shortLatency.count()},
+                   {"baseline_latency_us", limiter.longLatency.count()}}},
+                 {"token_cache",
+                  {{"size", tokens.size},
+                   {"hits", tokens.hits},
+                   {"misses", tokens.misses},
+                   {"evictions", tokens.evictions},
+                   {"expirations", tokens.expirations}}},
+                 {"lot_cache", lotCache}});
+  }));
+
+  // Без авторизации, как и /health: формат Prometheus text exposition
+  registerStatsCollectors(authService, database, lotService);
+  router.get("/metrics", [](const httplib::Request&, httplib::Response& res) {
+    res.status = 200;
+    res.set_content(core::metrics::Registry::instance().render(), "text/plain; version=0.0.4");
+  });
 
-  server.Options(".*", [](const httplib::Request&, httplib::Response& res) {
+  router.options(".*", [](const httplib::Request&, httplib::Response& res) {
     res.status = 204;
     applyCorsHeaders(res);
   });
 
-  server.Get("/lots", [&lotService, &authService](const httplib::Request& req, httplib::Response& res) {
-    std::cerr << "=== Incoming Request: GET /lots ===" << std::endl;
-    if (!requireAuth(req, res, authService, "ListLots")) {
-      std::cerr << "Auth FAILED for GET /lots" << std::endl;
-      return;
+  // Маршруты лотов — корутины: ожидая платёжный сервис и БД, запрос не держит поток
+  router.getAsync("/lots", instrumentAsync("GET /lots",
+                                           [&lotService, &authService](const httplib::Request& req,
+                                                                       httplib::Response& res) -> core::Task<void> {
+    if (!co_await requireAuthTask(req, res, authService, "ListLots")) {
+      co_return;
+    }
+
+    // Тело потокового ответа пишется уже после корутины, в пуле обработчиков или потоке httplib
+    if (!req.has_param("limit") && !req.has_param("after")) {
+      co_await streamLots(res, lotService);
+      co_return;
     }
-    std::cerr << "Auth PASSED for GET /lots" << std::endl;
 
     try {
-      const auto lots = lotService.listLots();
-      nlohmann::json body = nlohmann::json::array();
-      for (const auto& lot : lots) {
-        body.push_back(lot.toJson());
+      std::optional<std::string> after =
+          req.has_param("after") ? std::optional<std::string>{req.get_param_value("after")} : std::nullopt;
+      const auto page = co_await lotService.listLotsPageTask(parsePageLimit(req), std::move(after));
+      std::string body;
+      body.reserve(2 + page.lots.size() * (kLotJsonSizeHint + 1));
+      model::json::appendArray(body, page.lots, model::json::appendLot);
+      if (page.nextCursor) {
+        res.set_header("X-Next-Cursor", *page.nextCursor);
       }
-      respondJson(res, 200, body);
+      respondJsonBody(res, 200, std::move(body));
+    } catch (const core::Overloaded& ex) {
+      respondOverloaded(res, ex);
+    } catch (const std::invalid_argument& ex) {
+      respondJson(res, 400, {{"error", ex.what()}});
     } catch (const std::exception& ex) {
       respondJson(res, 500, {{"error", ex.what()}});
     }
-  });
+  }));
 
-  server.Get(R"(/lots/(\d+))",
-             [&lotService, &authService](const httplib::Request& req, httplib::Response& res) {
-               if (!requireAuth(req, res, authService, "GetLot")) {
-                 return;
-               }
-
-               try {
-                 const int id = std::stoi(req.matches[1]);
-                 auto lot = lotService.getLot(id);
-                 if (!lot.has_value()) {
-                   respondJson(res, 404, {{"error", "Lot not found"}});
-                   return;
-                 }
-                 respondJson(res, 200, lot->toJson());
-               } catch (const std::invalid_argument&) {
-                 respondJson(res, 400, {{"error", "Invalid id"}});
-               } catch (const std::exception& ex) {
-                 respondJson(res, 500, {{"error", ex.what()}});
-               }
-             });
-
-  server.Post("/lots", [&lotService, &authService](const httplib::Request& req, httplib::Response& res) {
-    std::cerr << "=== Incoming Request: POST /lots ===" << std::endl;
-    std::cerr << "Request body: " << req.body << std::endl;
-    if (!requireAuth(req, res, authService, "CreateLot")) {
-      std::cerr << "Auth FAILED for POST /lots" << std::endl;
-      return;
+  router.getAsync(R"(/lots/(\d+))", instrumentAsync("GET /lots/{id}",
+                  [&lotService, &authService](const httplib::Request& req,
+                                              httplib::Response& res) -> core::Task<void> {
+                    if (!co_await requireAuthTask(req, res, authService, "GetLot")) {
+                      co_return;
+                    }
+
+                    try {
+                      const int id = std::stoi(req.matches[1]);
+                      auto lot = co_await lotService.getLotTask(id);
+                      if (!lot.has_value()) {
+                        respondJson(res, 404, {{"error", "Lot not found"}});
+                        co_return;
+                      }
+                      respondLot(res, 200, *lot);
+                    } catch (const core::Overloaded& ex) {
+                      respondOverloaded(res, ex);
+                    } catch (const std::invalid_argument&) {
+                      respondJson(res, 400, {{"error", "Invalid id"}});
+                    } catch (const std::exception& ex) {
+                      respondJson(res, 500, {{"error", ex.what()}});
+                    }
+                  }));
+
+  router.postAsync("/lots", instrumentAsync("POST /lots",
+                                            [&lotService, &authService](const httplib::Request& req,
+                                                                        httplib::Response& res) -> core::Task<void> {
+    AUCTION_LOG_DEBUG("POST /lots").field("body", req.body);
+    if (!co_await requireAuthTask(req, res, authService, "CreateLot")) {
+      co_return;
     }
-    std::cerr << "Auth PASSED for POST /lots" << std::endl;
 
     try {
-      const auto body = nlohmann::json::parse(req.body);
-      auto lot = model::lotFromJson(body);
-      lot.created_at.clear();
-      auto created = lotService.createLot(lot);
-      respondJson(res, 201, created.toJson());
-    } catch (const nlohmann::json::exception&) {
-      respondJson(res, 400, {{"error", "Invalid JSON payload"}});
+      auto lot = model::lotFromJson(req.body);
+      lot.created_at.reset();
+      auto created = co_await lotService.createLotTask(std::move(lot));
+      respondLot(res, 201, created);
+    } catch (const core::Overloaded& ex) {
+      respondOverloaded(res, ex);
+    } catch (const model::PayloadError& ex) {
+      respondPayloadError(res, ex);
     } catch (const std::exception& ex) {
       respondJson(res, 400, {{"error", ex.what()}});
     }
-  });
+  }));
+
+  router.putAsync(R"(/lots/(\d+))", instrumentAsync("PUT /lots/{id}",
+                  [&lotService, &authService](const httplib::Request& req,
+                                              httplib::Response& res) -> core::Task<void> {
+                    if (!co_await requireAuthTask(req, res, authService, "UpdateLot")) {
+                      co_return;
+                    }
+
+                    try {
+                      const int id = std::stoi(req.matches[1]);
+                      auto lot = co_await lotService.getLotTask(id);
+                      if (!lot.has_value()) {
+                        respondJson(res, 404, {{"error", "Lot not found"}});
+                        co_return;
+                      }
+
+                      model::applyLotPatch(*lot, req.body);
+                      auto updated = co_await lotService.updateLotTask(id, std::move(*lot));
+                      if (!updated.has_value()) {
+                        respondJson(res, 500, {{"error", "Failed to update lot"}});
+                        co_return;
+                      }
+                      respondLot(res, 200, *updated);
+                    } catch (const core::Overloaded& ex) {
+                      respondOverloaded(res, ex);
+                    } catch (const model::PayloadError& ex) {
+                      respondPayloadError(res, ex);
+                    } catch (const std::invalid_argument&) {
+                      respondJson(res, 400, {{"error", "Invalid id"}});
+                    } catch (const std::exception& ex) {
+                      respondJson(res, 400, {{"error", ex.what()}});
+                    }
+                  }));
 
-  server.Put(R"(/lots/(\d+))",
-             [&lotService, &authService](const httplib::Request& req, httplib::Response& res) {
-               if (!requireAuth(req, res, authService, "UpdateLot")) {
-                 return;
-               }
-
-               try {
-                 const int id = std::stoi(req.matches[1]);
-                 auto lot = lotService.getLot(id);
-                 if (!lot.has_value()) {
-                   respondJson(res, 404, {{"error", "Lot not found"}});
-                   return;
-                 }
-
-                 const auto body = nlohmann::json::parse(req.body);
-                 applyLotPatch(*lot, body);
-                 auto updated = lotService.updateLot(id, *lot);
-                 if (!updated.has_value()) {
-                   respondJson(res, 500, {{"error", "Failed to update lot"}});
-                   return;
-                 }
-                 respondJson(res, 200, updated->toJson());
-               } catch (const nlohmann::json::exception&) {
-                 respondJson(res, 400, {{"error", "Invalid JSON payload"}});
-               } catch (const std::invalid_argument&) {
-                 respondJson(res, 400, {{"error", "Invalid id"}});
-               } catch (const std::exception& ex) {
-                 respondJson(res, 400, {{"error", ex.what()}});
-               }
-             });
-
-  server.Delete(R"(/lots/(\d+))",
-                [&lotService, &authService](const httplib::Request& req, httplib::Response& res) {
-                  if (!requireAuth(req, res, authService, "DeleteLot")) {
-                    return;
-                  }
-
-                  try {
-                    const int id = std::stoi(req.matches[1]);
-                    if (!lotService.deleteLot(id)) {
-                      respondJson(res, 404, {{"error", "Lot not found"}});
-                      return;
+  router.delAsync(R"(/lots/(\d+))", instrumentAsync("DELETE /lots/{id}",
+                  [&lotService, &authService](const httplib::Request& req,
+                                              httplib::Response& res) -> core::Task<void> {
+                    if (!co_await requireAuthTask(req, res, authService, "DeleteLot")) {
+                      co_return;
                     }
-                    respondJson(res, 204, nlohmann::json::object());
-                  } catch (const std::invalid_argument&) {
-                    respondJson(res, 400, {{"error", "Invalid id"}});
-                  } catch (const std::exception& ex) {
-                    respondJson(res, 400, {{"error", ex.what()}});
-                  }
-                });
-
-  server.Post(R"(/lots/(\d+)/bid)",
-              [&lotService, &authService](const httplib::Request& req, httplib::Response& res) {
-                if (!requireAuth(req, res, authService, "PlaceBid")) {
-                  return;
-                }
-
-                try {
-                  const int id = std::stoi(req.matches[1]);
-                  const auto body = nlohmann::json::parse(req.body);
-                  if (!body.contains("amount")) {
-                    respondJson(res, 400, {{"error", "Missing amount"}});
-                    return;
-                  }
-                  const double amount = body.at("amount").get<double>();
-                  auto lot = lotService.placeBid(id, amount);
-                  respondJson(res, 200, lot.toJson());
-                } catch (const nlohmann::json::exception&) {
-                  respondJson(res, 400, {{"error", "Invalid JSON payload"}});
-                } catch (const std::invalid_argument&) {
-                  respondJson(res, 400, {{"error", "Invalid id or amount"}});
-                } catch (const std::exception& ex) {
-                  respondJson(res, 400, {{"error", ex.what()}});
-                }
-              });
-
-  return methods;
+
+                    try {
+                      const int id = std::stoi(req.matches[1]);
+                      if (!co_await lotService.deleteLotTask(id)) {
+                        respondJson(res, 404, {{"error", "Lot not found"}});
+                        co_return;
+                      }
+                      respondJson(res, 204, nlohmann::json::object());
+                    } catch (const core::Overloaded& ex) {
+                      respondOverloaded(res, ex);
+                    } catch (const std::invalid_argument&) {
+                      respondJson(res, 400, {{"error", "Invalid id"}});
+                    } catch (const std::exception& ex) {
+                      respondJson(res, 400, {{"error", ex.what()}});
+                    }
+                  }));
+
+  router.postAsync(R"(/lots/(\d+)/bid)", instrumentAsync("POST /lots/{id}/bid",
+                   [&lotService, &authService](const httplib::Request& req,
+                                               httplib::Response& res) -> core::Task<void> {
+                     if (!co_await requireAuthTask(req, res, authService, "PlaceBid")) {
+                       co_return;
+                     }
+
+                     try {
+                       const int id = std::stoi(req.matches[1]);
+                       auto bid = model::bidRequestFromJson(req.body);
+                       auto lot = co_await lotService.placeBidTask(id, bid.amount, std::move(bid.bidder_id));
+                       respondLot(res, 200, lot);
+                     } catch (const core::Overloaded& ex) {
+                       respondOverloaded(res, ex);
+                     } catch (const service::BidRejected& ex) {
+                       respondJson(res, 400, {{"error", ex.what()}, {"reason", ex.reason()}});
+                     } catch (const model::PayloadError& ex) {
+                       respondPayloadError(res, ex);
+                     } catch (const std::invalid_argument&) {
+                       respondJson(res, 400, {{"error", "Invalid id or amount"}});
+                     } catch (const std::exception& ex) {
+                       // Сбой БД или записи движка ставок (BidNotPersisted) — не отказ в ставке: 400 спрятал бы
+                       // его среди обычных отказов в нагрузочном тесте
+                       respondJson(res, 500, {{"error", ex.what()}});
+                     }
+                   }));
+
+  router.getAsync(R"(/lots/(\d+)/bids)", instrumentAsync("GET /lots/{id}/bids",
+                  [&lotService, &authService](const httplib::Request& req,
+                                              httplib::Response& res) -> core::Task<void> {
+                    if (!co_await requireAuthTask(req, res, authService, "ListBids")) {
+                      co_return;
+                    }
+
+                    try {
+                      const int id = std::stoi(req.matches[1]);
+                      std::optional<std::string> after =
+                          req.has_param("after") ? std::optional<std::string>{req.get_param_value("after")}
+                                                 : std::nullopt;
+                      const auto page = co_await lotService.listBidsTask(id, parsePageLimit(req), std::move(after));
+                      if (!page) {
+                        respondJson(res, 404, {{"error", "Lot not found"}});
+                        co_return;
+                      }
+                      std::string body;
+                      model::json::appendArray(body, page->bids, model::json::appendBid);
+                      if (page->nextCursor) {
+                        res.set_header("X-Next-Cursor", *page->nextCursor);
+                      }
+                      respondJsonBody(res, 200, std::move(body));
+                    } catch (const core::Overloaded& ex) {
+                      respondOverloaded(res, ex);
+                    } catch (const std::invalid_argument& ex) {
+                      respondJson(res, 400, {{"error", ex.what()}});
+                    } catch (const std::exception& ex) {
+                      respondJson(res, 500, {{"error", ex.what()}});
+                    }
+                  }));
+
+  return apiMethods();
 }
 
 }  // namespace auction::api
@@ -0,0 +1,257 @@
+#include "auction/core/async_http_client.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include "auction/core/logger.h"
+
+namespace {
+
+size_t writeCallback(char* ptr, size_t size, size_t nmemb, void* userdata) {
+  auto* responseBody = static_cast<std::string*>(userdata);
+  responseBody->append(ptr, size * nmemb);
+  return size * nmemb;
+}
+
+constexpr int kPollTimeoutMs = 1000;
+
+}  // namespace
+
+namespace auction::core {
+
+AsyncHttpClient::AsyncHttpClient() : AsyncHttpClient(HttpClientOptions::fromEnvironment()) {}
+
+AsyncHttpClient::AsyncHttpClient(HttpClientOptions options) : options_(options), multi_(curl_multi_init()) {
+  if (!multi_) {
+    throw std::runtime_error("Failed to initialize CURL multi");
+  }
+  // Соединения и DNS-кэш у multi-хендла общие для всех передач; HTTP/2 мультиплексируется
+  curl_multi_setopt(multi_, CURLMOPT_PIPELINING, options_.http2 ? CURLPIPE_MULTIPLEX : CURLPIPE_NOTHING);
+  curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, static_cast<long>(options_.maxIdleHandles));
+
+  loop_ = std::thread([this] { run(); });
+}
+
+AsyncHttpClient::~AsyncHttpClient() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  curl_multi_wakeup(multi_);
+  if (loop_.joinable()) {
+    loop_.join();
+  }
+  curl_multi_cleanup(multi_);
+}
+
+AsyncHttpClient::RequestId AsyncHttpClient::postJson(const std::string& url, const nlohmann::json& payload,
+                                                     Completion onDone, HttpRequestOptions options) {
+  auto transfer = std::make_unique<Transfer>();
+  transfer->url = url;
+  transfer->body = payload.dump();
+  transfer->headers.reset(curl_slist_append(nullptr, "Content-Type: application/json"));
+  for (const auto& header : options.headers) {
+    transfer->headers.reset(curl_slist_append(transfer->headers.release(), header.c_str()));
+  }
+  transfer->deadline = options.deadline;
+  transfer->onDone = std::move(onDone);
+
+  RequestId id = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+      throw std::runtime_error("HTTP client is shutting down");
+    }
+    id = nextId_++;
+    transfer->id = id;
+    submitted_.push_back(std::move(transfer));
+  }
+  curl_multi_wakeup(multi_);
+  return id;
+}
+
+std::future<HttpResponse> AsyncHttpClient::postJson(const std::string& url, const nlohmann::json& payload,
+                                                    HttpRequestOptions options) {
+  auto promise = std::make_shared<std::promise<HttpResponse>>();
+  auto future = promise->get_future();
+  postJson(
+      url, payload,
+      [promise](std::exception_ptr error, HttpResponse response) {
+        if (error) {
+          promise->set_exception(error);
+        } else {
+          promise->set_value(std::move(response));
+        }
+      },
+      std::move(options));
+  return future;
+}
+
+Task<HttpResponse> AsyncHttpClient::postJsonTask(std::string url, nlohmann::json payload,
+                                                 HttpRequestOptions options) {
+  co_return co_await Executor::callback<HttpResponse>(
+      [&](auto resume) { postJson(url, payload, std::move(resume), std::move(options)); });
+}
+
+void AsyncHttpClient::cancel(RequestId id) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled_.push_back(id);
+  }
+  curl_multi_wakeup(multi_);
+}
+
+void AsyncHttpClient::start(std::unique_ptr<Transfer> transfer) {
+  auto timeout = options_.totalTimeout;
+  if (transfer->deadline) {
+    timeout = std::chrono::duration_cast<std::chrono::milliseconds>(*transfer->deadline -
+                                                                    std::chrono::steady_clock::now());
+    if (timeout.count() <= 0) {
+      const auto id = transfer->id;
+      active_.emplace(id, std::move(transfer));
+      finish(id, std::make_exception_ptr(std::runtime_error("HTTP request deadline exceeded")));
+      return;
+    }
+  }
+
+  CURL* curl = nullptr;
+  if (!idleHandles_.empty()) {
+    curl = idleHandles_.back();
+    idleHandles_.pop_back();
+  } else {
+    curl = curl_easy_init();
+  }
+  if (!curl) {
+    const auto id = transfer->id;
+    active_.emplace(id, std::move(transfer));
+    finish(id, std::make_exception_ptr(std::runtime_error("Failed to initialize CURL")));
+    return;
+  }
+
+  curl_easy_setopt(curl, CURLOPT_URL, transfer->url.c_str());
+  curl_easy_setopt(curl, CURLOPT_POSTFIELDS, transfer->body.c_str());
+  curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(transfer->body.size()));
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, transfer->headers.get());
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer->responseBody);
+  curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, static_cast<long>(options_.connectTimeout.count()));
+  curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, static_cast<long>(timeout.count()));
+  curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+  curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, options_.http2 ? CURL_HTTP_VERSION_2TLS : CURL_HTTP_VERSION_1_1);
+  // Дождаться уже открытого HTTP/2-соединения вместо открытия параллельного
+  curl_easy_setopt(curl, CURLOPT_PIPEWAIT, options_.http2 ? 1L : 0L);
+  curl_easy_setopt(curl, CURLOPT_PRIVATE, static_cast<void*>(transfer.get()));
+
+  transfer->handle = curl;
+  const auto id = transfer->id;
+  active_.emplace(id, std::move(transfer));
+  if (const CURLMcode code = curl_multi_add_handle(multi_, curl); code != CURLM_OK) {
+    finish(id, std::make_exception_ptr(std::runtime_error(std::string{"HTTP request failed: "} +
+                                                          curl_multi_strerror(code))));
+  }
+}
+
+void AsyncHttpClient::finish(RequestId id, std::exception_ptr error) {
+  auto it = active_.find(id);
+  if (it == active_.end()) {
+    return;
+  }
+  auto transfer = std::move(it->second);
+  active_.erase(it);
+
+  HttpResponse response;
+  if (transfer->handle) {
+    if (!error) {
+      curl_easy_getinfo(transfer->handle, CURLINFO_RESPONSE_CODE, &response.status);
+    }
+    curl_multi_remove_handle(multi_, transfer->handle);
+    releaseHandle(transfer->handle);
+    transfer->handle = nullptr;
+  }
+  response.body = std::move(transfer->responseBody);
+
+  try {
+    transfer->onDone(error, std::move(response));
+  } catch (const std::exception& ex) {
+    AUCTION_LOG_ERROR("HTTP completion callback threw").field("error", ex.what());
+  } catch (...) {
+    AUCTION_LOG_ERROR("HTTP completion callback threw");
+  }
+}
+
+void AsyncHttpClient::releaseHandle(CURL* handle) {
+  if (idleHandles_.size() < options_.maxIdleHandles) {
+    curl_easy_reset(handle);
+    idleHandles_.push_back(handle);
+  } else {
+    curl_easy_cleanup(handle);
+  }
+}
+
+void AsyncHttpClient::run() {
+  std::vector<std::unique_ptr<Transfer>> submitted;
+  std::vector<RequestId> cancelled;
+  bool stopping = false;
+
+  while (!stopping) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      submitted.swap(submitted_);
+      cancelled.swap(cancelled_);
+      stopping = stopping_;
+    }
+
+    for (auto& transfer : submitted) {
+      start(std::move(transfer));
+    }
+    submitted.clear();
+    for (const auto id : cancelled) {
+      finish(id, std::make_exception_ptr(std::runtime_error("HTTP request cancelled")));
+    }
+    cancelled.clear();
+    if (stopping) {
+      break;
+    }
+
+    int running = 0;
+    curl_multi_perform(multi_, &running);
+
+    int queued = 0;
+    while (CURLMsg* message = curl_multi_info_read(multi_, &queued)) {
+      if (message->msg != CURLMSG_DONE) {
+        continue;
+      }
+      void* priv = nullptr;
+      curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, &priv);
+      const auto* transfer = static_cast<Transfer*>(priv);
+      const CURLcode result = message->data.result;
+      std::exception_ptr error;
+      if (result == CURLE_OPERATION_TIMEDOUT && transfer->deadline) {
+        error = std::make_exception_ptr(std::runtime_error("HTTP request deadline exceeded"));
+      } else if (result != CURLE_OK) {
+        error = std::make_exception_ptr(std::runtime_error(std::string{"HTTP request failed: "} +
+                                                           curl_easy_strerror(result)));
+      }
+      finish(transfer->id, error);
+    }
+
+    curl_multi_poll(multi_, nullptr, 0, kPollTimeoutMs, nullptr);
+  }
+
+  // Остановка: незавершённые запросы получают ошибку, чтобы никто не ждал вечно
+  std::vector<RequestId> remaining;
+  remaining.reserve(active_.size());
+  for (const auto& [id, transfer] : active_) {
+    remaining.push_back(id);
+  }
+  for (const auto id : remaining) {
+    finish(id, std::make_exception_ptr(std::runtime_error("HTTP client is shutting down")));
+  }
+  for (CURL* handle : idleHandles_) {
+    curl_easy_cleanup(handle);
+  }
+  idleHandles_.clear();
+}
+
+}  // namespace auction::core
@@ -1,9 +1,11 @@
 #include "auction/core/auth_service.h"
 
-#include <algorithm>
 #include <cstdlib>
-#include <iostream>
 #include <stdexcept>
+#include <utility>
+
+#include "auction/core/env.h"
+#include "auction/core/logger.h"
 
 namespace auction::core {
 
@@ -25,9 +27,19 @@ std::string joinUrl(const std::string& base, const std::string& path) {
   return base + path;
 }
 
+std::shared_future<bool> readyResult(bool value) {
+  std::promise<bool> promise;
+  promise.set_value(value);
+  return promise.get_future().share();
+}
+
 }  // namespace
 
 std::string AuthService::resolveBaseUrl() {
+  // Для нагрузочных тестов и локального запуска с заглушкой платёжного сервиса
+  if (auto overrideUrl = readEnv("PAYMENT_SERVICE_URL_OVERRIDE")) {
+    return *overrideUrl;
+  }
   // Хардкод, т.к. переменные окружения не всегда применяются в Railway
   return "https://payment-service-15044579133.europe-central2.run.app";
 }
@@ -39,37 +51,94 @@ std::string AuthService::resolveServiceName() {
   return "AuctionService";
 }
 
-AuthService::AuthService(TokenCache& cache)
-    : verifyUrl_(joinUrl(resolveBaseUrl(), "/token/check")), serviceName_(resolveServiceName()), cache_(cache) {}
+AuthService::AuthService(TokenCache& cache, AsyncHttpClient& httpClient)
+    : verifyUrl_(joinUrl(resolveBaseUrl(), "/token/check")),
+      serviceName_(resolveServiceName()),
+      cache_(cache),
+      httpClient_(httpClient),
+      paymentLatency_(metrics::Registry::instance().histogram(
+          "auction_payment_request_duration_seconds", "Token check round trip to the payment service")),
+      paymentTransportErrors_(metrics::Registry::instance().counter(
+          "auction_payment_request_errors_total", "Failed token checks against the payment service",
+          {{"kind", "transport"}})),
+      paymentStatusErrors_(metrics::Registry::instance().counter(
+          "auction_payment_request_errors_total", "Failed token checks against the payment service",
+          {{"kind", "status"}})) {}
 
 bool AuthService::verifyToken(const std::string& token, const std::string& methodName) {
+  return verifyTokenAsync(token, methodName).get();
+}
+
+std::shared_future<bool> AuthService::verifyTokenAsync(const std::string& token, const std::string& methodName) {
   if (token.empty()) {
-    return false;
+    return readyResult(false);
   }
 
   const std::string cacheKey = token + "::" + methodName;
   if (auto cached = cache_.get(cacheKey)) {
-    return *cached;
+    return readyResult(*cached);
   }
 
-  std::cerr << "=== Token Verification ===" << std::endl;
-  std::cerr << "URL: " << verifyUrl_ << std::endl;
-  std::cerr << "Token length: " << token.length() << ", first 10 chars: " << token.substr(0, std::min(size_t(10), token.length())) << "..." << std::endl;
-  std::cerr << "ServiceName: " << serviceName_ << ", MethodName: " << methodName << std::endl;
-  
-  const nlohmann::json payload = {{"token", token}, {"serviceName", serviceName_}, {"methodName", methodName}};
-  std::cerr << "Request payload: " << payload.dump() << std::endl;
-  
-  HttpResponse response;
-  try {
-    response = httpClient_.postJson(verifyUrl_, payload);
-  } catch (const std::exception& ex) {
-    std::cerr << "Payment Service request failed: " << ex.what() << std::endl;
-    throw;
+  return inflight_.runAsync(cacheKey, [&](const VerifyFlight::Done& done) {
+    requestCheck(token, methodName, cacheKey, done);
+  });
+}
+
+Task<bool> AuthService::verifyTokenTask(std::string token, std::string methodName) {
+  if (token.empty()) {
+    co_return false;
   }
-  
-  std::cerr << "Payment Service response status: " << response.status << std::endl;
-  std::cerr << "Payment Service response body: " << response.body << std::endl;
+
+  const std::string cacheKey = token + "::" + methodName;
+  if (auto cached = cache_.get(cacheKey)) {
+    co_return *cached;
+  }
+
+  // Корутина спит до ответа платёжного сервиса и продолжается в своём потоке исполнителя
+  co_return co_await Executor::callback<bool>([&](auto resume) {
+    inflight_.runAsync(
+        cacheKey, [&](const VerifyFlight::Done& done) { requestCheck(token, methodName, cacheKey, done); },
+        [resume](std::exception_ptr error, bool allowed) { resume(std::move(error), allowed); });
+  });
+}
+
+void AuthService::requestCheck(const std::string& token, const std::string& methodName, const std::string& cacheKey,
+                               const VerifyFlight::Done& done) {
+  // Сам токен и его префикс в лог не попадают ни на каком уровне
+  AUCTION_LOG_DEBUG("Verifying token")
+      .field("url", verifyUrl_)
+      .field("service", serviceName_)
+      .field("method", methodName)
+      .field("token_length", token.length());
+
+  const nlohmann::json payload = {{"token", token}, {"serviceName", serviceName_}, {"methodName", methodName}};
+
+  const auto start = std::chrono::steady_clock::now();
+  httpClient_.postJson(verifyUrl_, payload, [this, cacheKey, done, start](std::exception_ptr error,
+                                                                        HttpResponse response) {
+    paymentLatency_.observe(std::chrono::steady_clock::now() - start);
+    bool allowed = false;
+    if (error) {
+      paymentTransportErrors_.inc();
+      try {
+        std::rethrow_exception(error);
+      } catch (const std::exception& ex) {
+        AUCTION_LOG_WARN("Payment service request failed").field("error", ex.what());
+      } catch (...) {
+      }
+    } else {
+      try {
+        allowed = handleVerifyResponse(cacheKey, response);
+      } catch (...) {
+        error = std::current_exception();
+      }
+    }
+    done(error, allowed);
+  });
+}
+
+bool AuthService::handleVerifyResponse(const std::string& cacheKey, const HttpResponse& response) {
+  AUCTION_LOG_DEBUG("Payment service response").field("status", response.status).field("body", response.body);
 
   if (response.status == 401 || response.status == 403) {
     cache_.put(cacheKey, false);
@@ -77,6 +146,7 @@ bool AuthService::verifyToken(const std::string& token, const std::string& metho
   }
 
   if (response.status != 200) {
+    paymentStatusErrors_.inc();
     throw std::runtime_error("Token verification service returned status " + std::to_string(response.status));
   }
 
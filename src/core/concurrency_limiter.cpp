@@ -0,0 +1,331 @@
+#include "auction/core/concurrency_limiter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <utility>
+
+#include "auction/core/env.h"
+#include "auction/core/executor.h"
+#include "auction/core/logger.h"
+
+namespace auction::core {
+
+namespace {
+
+// Окно, по которому считается средняя задержка: не короче kLatencyWindow и не меньше kMinWindowSamples вызовов
+constexpr std::chrono::milliseconds kLatencyWindow{100};
+constexpr std::size_t kMinWindowSamples = 10;
+// Долгосрочная задержка — EWMA по окнам; с окном 100 мс это порядка 10 секунд
+constexpr double kLongWindows = 100.0;
+// Во сколько раз задержка может превысить долгосрочную, прежде чем лимит начнёт снижаться
+constexpr double kTolerance = 1.5;
+// Доля нового значения лимита: сглаживает реакцию на одно шумное окно
+constexpr double kSmoothing = 0.2;
+constexpr std::chrono::seconds kLogEvery{10};
+
+std::size_t queueIndex(Priority priority) { return static_cast<std::size_t>(priority); }
+
+}  // namespace
+
+LimiterOptions LimiterOptions::fromEnvironment() {
+  LimiterOptions options;
+  options.minLimit = envSize("DB_LIMIT_MIN", options.minLimit);
+  options.maxLimit = envSize("DB_LIMIT_MAX", options.maxLimit);
+  options.queueTarget = std::chrono::milliseconds{
+      envSize("DB_QUEUE_TARGET_MS", static_cast<std::size_t>(options.queueTarget.count()))};
+  options.queueInterval = std::chrono::milliseconds{
+      envSize("DB_QUEUE_INTERVAL_MS", static_cast<std::size_t>(options.queueInterval.count()))};
+  options.maxQueue = envSize("DB_QUEUE_MAX", options.maxQueue);
+  return options;
+}
+
+ConcurrencyLimiter::Permit::Permit(ConcurrencyLimiter* limiter, std::chrono::steady_clock::time_point start)
+    : limiter_(limiter), start_(start) {}
+
+ConcurrencyLimiter::Permit::~Permit() { release(); }
+
+ConcurrencyLimiter::Permit::Permit(Permit&& other) noexcept
+    : limiter_(std::exchange(other.limiter_, nullptr)), start_(other.start_), succeeded_(other.succeeded_) {}
+
+ConcurrencyLimiter::Permit& ConcurrencyLimiter::Permit::operator=(Permit&& other) noexcept {
+  if (this != &other) {
+    release();
+    limiter_ = std::exchange(other.limiter_, nullptr);
+    start_ = other.start_;
+    succeeded_ = other.succeeded_;
+  }
+  return *this;
+}
+
+void ConcurrencyLimiter::Permit::release() {
+  if (limiter_) {
+    limiter_->release(start_, succeeded_);
+  }
+  limiter_ = nullptr;
+}
+
+ConcurrencyLimiter::ConcurrencyLimiter(LimiterOptions options)
+    : options_(options),
+      retryAfter_(std::max(std::chrono::seconds{1}, std::chrono::ceil<std::chrono::seconds>(options.queueInterval))),
+      windowStart_(Clock::now()),
+      intervalStart_(windowStart_),
+      lastOverloadLog_(windowStart_ - kLogEvery) {
+  options_.minLimit = std::max<std::size_t>(options_.minLimit, 1);
+  options_.maxLimit = std::max(options_.maxLimit, options_.minLimit);
+  options_.queueInterval = std::max(options_.queueInterval, options_.queueTarget);
+  limit_ = static_cast<double>(std::clamp(options_.initialLimit, options_.minLimit, options_.maxLimit));
+}
+
+std::size_t ConcurrencyLimiter::currentLimitLocked() const { return static_cast<std::size_t>(limit_); }
+
+bool ConcurrencyLimiter::canAdmitLocked() const {
+  // Пока кто-то ждёт, новые запросы встают за ним, даже если место только что освободилось
+  return queued_ == 0 && inFlight_ < currentLimitLocked();
+}
+
+void ConcurrencyLimiter::admitLocked(Clock::time_point now) {
+  ++inFlight_;
+  ++admitted_;
+  recordDelayLocked(Clock::duration::zero(), now);
+}
+
+ConcurrencyLimiter::Clock::duration ConcurrencyLimiter::allowedDelayLocked() const {
+  return overloaded_ ? options_.queueTarget : options_.queueInterval;
+}
+
+Overloaded ConcurrencyLimiter::overloaded() const {
+  return Overloaded("Database is overloaded, retry later", retryAfter_);
+}
+
+std::shared_ptr<ConcurrencyLimiter::Waiter> ConcurrencyLimiter::enqueueLocked(Priority priority,
+                                                                              Clock::time_point now) {
+  // Очередь уже стоячая: низкоприоритетному запросу быстрее и честнее сразу ответить 503
+  if (queued_ >= options_.maxQueue || (overloaded_ && priority == Priority::low)) {
+    ++rejected_;
+    return nullptr;
+  }
+  auto waiter = std::make_shared<Waiter>();
+  waiter->enqueued = now;
+  queues_[queueIndex(priority)].push_back(waiter);
+  ++queued_;
+  return waiter;
+}
+
+void ConcurrencyLimiter::removeLocked(const std::shared_ptr<Waiter>& waiter) {
+  for (auto& queue : queues_) {
+    if (auto it = std::find(queue.begin(), queue.end(), waiter); it != queue.end()) {
+      queue.erase(it);
+      --queued_;
+      return;
+    }
+  }
+}
+
+void ConcurrencyLimiter::expireLocked(const std::shared_ptr<Waiter>& waiter, Clock::time_point now) {
+  removeLocked(waiter);
+  waiter->state = WaiterState::rejected;
+  ++rejected_;
+  recordDelayLocked(now - waiter->enqueued, now);
+}
+
+void ConcurrencyLimiter::recordDelayLocked(Clock::duration delay, Clock::time_point now) {
+  intervalMinDelay_ = std::min(intervalMinDelay_, delay);
+  if (now - intervalStart_ < options_.queueInterval) {
+    return;
+  }
+
+  const bool wasOverloaded = overloaded_;
+  overloaded_ = intervalMinDelay_ > options_.queueTarget;
+  intervalMinDelay_ = Clock::duration::max();
+  intervalStart_ = now;
+  // Под долгой перегрузкой состояние переключается каждые несколько интервалов; в лог — не чаще kLogEvery
+  if (overloaded_ && !wasOverloaded && now - lastOverloadLog_ >= kLogEvery) {
+    lastOverloadLog_ = now;
+    AUCTION_LOG_WARN("Database queue is standing, shedding load")
+        .field("limit", currentLimitLocked())
+        .field("queued", queued_)
+        .field("rejected", rejected_);
+  }
+}
+
+void ConcurrencyLimiter::recordLatencyLocked(Clock::duration latency, Clock::time_point now) {
+  windowSum_ += latency;
+  ++windowSamples_;
+  windowMaxInFlight_ = std::max(windowMaxInFlight_, inFlight_);
+  if (windowSamples_ < kMinWindowSamples || now - windowStart_ < kLatencyWindow) {
+    return;
+  }
+
+  const double sample =
+      std::chrono::duration<double>(windowSum_).count() / static_cast<double>(windowSamples_);
+  const std::size_t maxInFlight = windowMaxInFlight_;
+  windowStart_ = now;
+  windowSum_ = Clock::duration::zero();
+  windowSamples_ = 0;
+  windowMaxInFlight_ = 0;
+  if (sample <= 0) {
+    return;
+  }
+
+  shortLatency_ = sample;
+  longLatency_ = longLatency_ == 0 ? sample : longLatency_ + (sample - longLatency_) / kLongWindows;
+  // Задержка резко упала — БД разгрузилась; долгосрочную подтягиваем быстрее, чем даёт EWMA
+  if (longLatency_ / sample > 2) {
+    longLatency_ *= 0.95;
+  }
+
+  // Лимит не выбирали и наполовину: задержка не говорит, выдержит ли БД больше
+  if (static_cast<double>(maxInFlight) < limit_ / 2) {
+    return;
+  }
+
+  const double gradient = std::clamp(kTolerance * longLatency_ / sample, 0.5, 1.0);
+  const double next = limit_ * gradient + std::sqrt(limit_);
+  limit_ = std::clamp(limit_ * (1 - kSmoothing) + next * kSmoothing, static_cast<double>(options_.minLimit),
+                      static_cast<double>(options_.maxLimit));
+}
+
+void ConcurrencyLimiter::drainLocked(Clock::time_point now, WakeList& woken) {
+  for (auto& queue : queues_) {
+    while (!queue.empty() && inFlight_ < currentLimitLocked()) {
+      auto waiter = std::move(queue.front());
+      queue.pop_front();
+      --queued_;
+
+      // Проверка при выдаче, как в CoDel: за время ожидания очередь могла стать стоячей
+      const auto delay = now - waiter->enqueued;
+      recordDelayLocked(delay, now);
+      if (delay > allowedDelayLocked()) {
+        waiter->state = WaiterState::rejected;
+        ++rejected_;
+      } else {
+        waiter->state = WaiterState::granted;
+        ++inFlight_;
+        ++admitted_;
+      }
+      woken.push_back(std::move(waiter));
+    }
+  }
+}
+
+void ConcurrencyLimiter::wake(WakeList& woken, Clock::time_point now) {
+  bool threads = false;
+  for (const auto& waiter : woken) {
+    if (!waiter->resume) {
+      threads = true;
+    } else if (waiter->state == WaiterState::granted) {
+      waiter->resume(nullptr, now);
+    } else {
+      waiter->resume(std::make_exception_ptr(overloaded()), now);
+    }
+  }
+  if (threads) {
+    available_.notify_all();
+  }
+}
+
+ConcurrencyLimiter::Permit ConcurrencyLimiter::acquire(Priority priority) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const auto now = Clock::now();
+  if (canAdmitLocked()) {
+    admitLocked(now);
+    return Permit(this, now);
+  }
+
+  auto waiter = enqueueLocked(priority, now);
+  if (!waiter) {
+    throw overloaded();
+  }
+  available_.wait_until(lock, now + allowedDelayLocked(),
+                        [&waiter] { return waiter->state != WaiterState::waiting; });
+  if (waiter->state == WaiterState::waiting) {
+    expireLocked(waiter, Clock::now());
+  }
+  if (waiter->state == WaiterState::rejected) {
+    throw overloaded();
+  }
+  return Permit(this, Clock::now());
+}
+
+Task<ConcurrencyLimiter::Permit> ConcurrencyLimiter::acquireTask(Priority priority) {
+  std::optional<Clock::time_point> admitted;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (canAdmitLocked()) {
+      admitted = Clock::now();
+      admitLocked(*admitted);
+    }
+  }
+  if (!admitted) {
+    admitted = co_await Executor::callback<Clock::time_point>(
+        [this, priority](auto resume) { waitAsync(priority, std::move(resume)); });
+  }
+  co_return Permit(this, *admitted);
+}
+
+void ConcurrencyLimiter::waitAsync(Priority priority,
+                                   std::function<void(std::exception_ptr, Clock::time_point)> resume) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  // Пока корутина засыпала, место могло освободиться
+  const auto now = Clock::now();
+  if (canAdmitLocked()) {
+    admitLocked(now);
+    lock.unlock();
+    resume(nullptr, now);
+    return;
+  }
+
+  auto waiter = enqueueLocked(priority, now);
+  if (!waiter) {
+    lock.unlock();
+    resume(std::make_exception_ptr(overloaded()), now);
+    return;
+  }
+  waiter->resume = std::move(resume);
+  const auto timeout = std::chrono::ceil<std::chrono::milliseconds>(allowedDelayLocked());
+  lock.unlock();
+
+  Executor::after(timeout, [this, waiter] {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (waiter->state != WaiterState::waiting) {
+        return;
+      }
+      expireLocked(waiter, Clock::now());
+    }
+    waiter->resume(std::make_exception_ptr(overloaded()), Clock::now());
+  });
+}
+
+void ConcurrencyLimiter::release(Clock::time_point start, bool succeeded) {
+  const auto now = Clock::now();
+  WakeList woken;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (succeeded) {
+      recordLatencyLocked(now - start, now);
+    }
+    --inFlight_;
+    drainLocked(now, woken);
+  }
+  wake(woken, now);
+}
+
+LimiterStats ConcurrencyLimiter::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LimiterStats stats;
+  stats.limit = currentLimitLocked();
+  stats.inFlight = inFlight_;
+  stats.queued = queued_;
+  stats.overloaded = overloaded_;
+  stats.admitted = admitted_;
+  stats.rejected = rejected_;
+  stats.shortLatency = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::duration<double>(shortLatency_));
+  stats.longLatency = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::duration<double>(longLatency_));
+  return stats;
+}
+
+}  // namespace auction::core
@@ -0,0 +1,526 @@
+#include "auction/core/connection_pool.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "auction/core/env.h"
+#include "auction/core/executor.h"
+#include "auction/core/logger.h"
+
+namespace auction::core {
+
+namespace {
+
+constexpr int kReconnectAttempts = 3;
+
+std::chrono::milliseconds reconnectDelay(int attempt) { return std::chrono::milliseconds{500 * attempt}; }
+
+// Пауза в корутине: поток исполнителя тем временем обслуживает другие
+Task<void> pause(std::chrono::milliseconds delay) {
+  co_await Executor::callback<bool>(
+      [delay](auto resume) { Executor::after(delay, [resume]() mutable { resume(nullptr, true); }); });
+}
+
+}  // namespace
+
+PoolOptions PoolOptions::fromEnvironment() {
+  PoolOptions options;
+  options.minConnections = envSize("DB_POOL_MIN", options.minConnections);
+  options.maxConnections = envSize("DB_POOL_MAX", options.maxConnections);
+  options.checkoutTimeout = std::chrono::milliseconds{
+      envSize("DB_POOL_CHECKOUT_TIMEOUT_MS", static_cast<std::size_t>(options.checkoutTimeout.count()))};
+  options.idleTimeout =
+      std::chrono::seconds{envSize("DB_POOL_IDLE_TIMEOUT_S", static_cast<std::size_t>(options.idleTimeout.count()))};
+  options.healthCheckIdle = std::chrono::seconds{
+      envSize("DB_POOL_HEALTHCHECK_IDLE_S", static_cast<std::size_t>(options.healthCheckIdle.count()))};
+
+  options.maxConnections = std::max<std::size_t>(options.maxConnections, 1);
+  options.minConnections = std::min(options.minConnections, options.maxConnections);
+  return options;
+}
+
+ConnectionPool::Connection::~Connection() {
+  if (handle) {
+    PQfinish(handle);
+    handle = nullptr;
+  }
+}
+
+ConnectionPool::Lease::Lease(ConnectionPool* pool, std::unique_ptr<Connection> connection)
+    : pool_(pool), connection_(std::move(connection)) {}
+
+ConnectionPool::Lease::~Lease() { release(); }
+
+ConnectionPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(std::exchange(other.pool_, nullptr)), connection_(std::move(other.connection_)) {}
+
+ConnectionPool::Lease& ConnectionPool::Lease::operator=(Lease&& other) noexcept {
+  if (this != &other) {
+    release();
+    pool_ = std::exchange(other.pool_, nullptr);
+    connection_ = std::move(other.connection_);
+  }
+  return *this;
+}
+
+bool ConnectionPool::Lease::isPrepared(const std::string& name) const {
+  return connection_->prepared.count(name) != 0;
+}
+
+void ConnectionPool::Lease::markPrepared(const std::string& name) { connection_->prepared.insert(name); }
+
+void ConnectionPool::Lease::reconnect() {
+  discard();
+  connection_->prepared.clear();
+
+  // Если переподключиться не удалось, соединение без handle будет выброшено из пула при возврате
+  auto fresh = pool_->openWithRetry();
+  std::swap(connection_->handle, fresh->handle);
+}
+
+Task<void> ConnectionPool::Lease::reconnectTask() {
+  discard();
+  connection_->prepared.clear();
+
+  auto fresh = co_await pool_->openWithRetryTask();
+  std::swap(connection_->handle, fresh->handle);
+}
+
+void ConnectionPool::Lease::discard() {
+  if (connection_ && connection_->handle) {
+    PQfinish(connection_->handle);
+    connection_->handle = nullptr;
+  }
+}
+
+void ConnectionPool::Lease::release() {
+  if (pool_ && connection_) {
+    pool_->giveBack(std::move(connection_));
+  }
+  pool_ = nullptr;
+}
+
+ConnectionPool::ConnectionPool(std::string connectionString, PoolOptions options)
+    : connectionString_(std::move(connectionString)), options_(options) {
+  // Первое соединение открываем сразу, чтобы ошибки конфигурации всплывали при старте
+  for (std::size_t i = 0; i < std::max<std::size_t>(options_.minConnections, 1); ++i) {
+    idle_.push_back(open());
+    ++total_;
+  }
+
+  maintenance_ = std::thread([this] { runMaintenance(); });
+}
+
+ConnectionPool::~ConnectionPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  maintenanceWakeup_.notify_all();
+  if (maintenance_.joinable()) {
+    maintenance_.join();
+  }
+}
+
+std::unique_ptr<ConnectionPool::Connection> ConnectionPool::opened(std::unique_ptr<Connection> connection) {
+  connection->lastUsed = std::chrono::steady_clock::now();
+  connection->lastChecked = connection->lastUsed;
+  if (!connection->handle || PQstatus(connection->handle) != CONNECTION_OK) {
+    throw std::runtime_error(std::string{"Failed to connect to database: "} +
+                             (connection->handle ? PQerrorMessage(connection->handle) : "null connection"));
+  }
+  return connection;
+}
+
+std::unique_ptr<ConnectionPool::Connection> ConnectionPool::open() const {
+  auto connection = std::make_unique<Connection>();
+  connection->handle = PQconnectdb(connectionString_.c_str());
+  return opened(std::move(connection));
+}
+
+Task<std::unique_ptr<ConnectionPool::Connection>> ConnectionPool::openTask() const {
+  // Рукопожатие, TLS и аутентификация идут по готовности сокета. Имя хоста libpq по-прежнему резолвит
+  // синхронно внутри PQconnectPoll; без этой задержки обходится только hostaddr
+  auto connection = std::make_unique<Connection>();
+  connection->handle = PQconnectStart(connectionString_.c_str());
+  if (connection->handle && PQstatus(connection->handle) != CONNECTION_BAD) {
+    for (auto status = PGRES_POLLING_WRITING; status != PGRES_POLLING_OK && status != PGRES_POLLING_FAILED;
+         status = PQconnectPoll(connection->handle)) {
+      // Сокет может смениться между попытками (несколько адресов хоста), поэтому берётся заново
+      if (status == PGRES_POLLING_READING) {
+        co_await Executor::readable(PQsocket(connection->handle));
+      } else {
+        co_await Executor::writable(PQsocket(connection->handle));
+      }
+    }
+  }
+  co_return opened(std::move(connection));
+}
+
+std::unique_ptr<ConnectionPool::Connection> ConnectionPool::openWithRetry() const {
+  for (int attempt = 1; attempt <= kReconnectAttempts; ++attempt) {
+    try {
+      auto connection = open();
+      AUCTION_LOG_INFO("Database reconnected").field("attempt", attempt);
+      return connection;
+    } catch (const std::exception& ex) {
+      AUCTION_LOG_WARN("Database reconnect failed").field("attempt", attempt).field("error", ex.what());
+    }
+
+    if (attempt < kReconnectAttempts) {
+      std::this_thread::sleep_for(reconnectDelay(attempt));
+    }
+  }
+
+  throw std::runtime_error("Failed to reconnect to database after 3 attempts");
+}
+
+Task<std::unique_ptr<ConnectionPool::Connection>> ConnectionPool::openWithRetryTask() const {
+  for (int attempt = 1; attempt <= kReconnectAttempts; ++attempt) {
+    try {
+      auto connection = co_await openTask();
+      AUCTION_LOG_INFO("Database reconnected").field("attempt", attempt);
+      co_return connection;
+    } catch (const std::exception& ex) {
+      AUCTION_LOG_WARN("Database reconnect failed").field("attempt", attempt).field("error", ex.what());
+    }
+
+    if (attempt < kReconnectAttempts) {
+      co_await pause(reconnectDelay(attempt));
+    }
+  }
+
+  throw std::runtime_error("Failed to reconnect to database after 3 attempts");
+}
+
+ConnectionPool::Lease ConnectionPool::acquire() {
+  const auto start = std::chrono::steady_clock::now();
+  const auto deadline = start + options_.checkoutTimeout;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  std::unique_ptr<Connection> connection;
+  bool waited = false;
+
+  while (!connection) {
+    if (!idle_.empty()) {
+      // LIFO: самое «тёплое» соединение, холодные дольше простаивают и раньше уходят в reaper
+      connection = std::move(idle_.back());
+      idle_.pop_back();
+      break;
+    }
+
+    if (total_ < options_.maxConnections) {
+      ++total_;
+      lock.unlock();
+      try {
+        connection = open();
+      } catch (...) {
+        lock.lock();
+        --total_;
+        available_.notify_one();
+        throw;
+      }
+      lock.lock();
+      break;
+    }
+
+    ++waiters_;
+    waited = true;
+    const auto status = available_.wait_until(lock, deadline);
+    --waiters_;
+    if (status == std::cv_status::timeout && idle_.empty() && total_ >= options_.maxConnections) {
+      ++timeouts_;
+      throw std::runtime_error("Database pool checkout timed out after " +
+                               std::to_string(options_.checkoutTimeout.count()) + " ms");
+    }
+  }
+
+  ++checkouts_;
+  if (waited) {
+    const auto wait = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    totalWait_ += wait;
+    maxWait_ = std::max(maxWait_, wait);
+  }
+
+  return Lease(this, std::move(connection));
+}
+
+Task<ConnectionPool::Lease> ConnectionPool::acquireTask() {
+  const auto start = std::chrono::steady_clock::now();
+  const auto deadline = start + options_.checkoutTimeout;
+  std::unique_ptr<Connection> connection;
+  bool waited = false;
+
+  while (!connection) {
+    bool reserved = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!idle_.empty()) {
+        connection = std::move(idle_.back());
+        idle_.pop_back();
+        break;
+      }
+      if (total_ < options_.maxConnections) {
+        ++total_;
+        reserved = true;
+      }
+    }
+
+    if (reserved) {
+      try {
+        connection = co_await openTask();
+      } catch (...) {
+        std::shared_ptr<AsyncWaiter> next;
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          --total_;
+          next = takeAsyncWaiterLocked();
+        }
+        if (next) {
+          next->resume(nullptr, nullptr);
+        } else {
+          available_.notify_one();
+        }
+        throw;
+      }
+      break;
+    }
+
+    const auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+    waited = true;
+    connection = co_await Executor::callback<std::unique_ptr<Connection>>(
+        [this, left](auto resume) { waitAsync(std::max(left, std::chrono::milliseconds{0}), std::move(resume)); });
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++checkouts_;
+    if (waited) {
+      const auto wait =
+          std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+      totalWait_ += wait;
+      maxWait_ = std::max(maxWait_, wait);
+    }
+  }
+  co_return Lease(this, std::move(connection));
+}
+
+void ConnectionPool::waitAsync(std::chrono::milliseconds timeout,
+                               std::function<void(std::exception_ptr, std::unique_ptr<Connection>)> resume) {
+  auto waiter = std::make_shared<AsyncWaiter>();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Пока корутина засыпала, соединение могли вернуть или закрыть — тогда ждать нечего
+    if (!idle_.empty()) {
+      auto connection = std::move(idle_.back());
+      idle_.pop_back();
+      resume(nullptr, std::move(connection));
+      return;
+    }
+    if (total_ < options_.maxConnections) {
+      resume(nullptr, nullptr);
+      return;
+    }
+    waiter->resume = std::move(resume);
+    asyncWaiters_.push_back(waiter);
+  }
+
+  Executor::after(timeout, [this, waiter] {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (waiter->settled) {
+        return;
+      }
+      waiter->settled = true;
+      asyncWaiters_.erase(std::find(asyncWaiters_.begin(), asyncWaiters_.end(), waiter));
+      ++timeouts_;
+    }
+    waiter->resume(std::make_exception_ptr(std::runtime_error("Database pool checkout timed out after " +
+                                                              std::to_string(options_.checkoutTimeout.count()) +
+                                                              " ms")),
+                   nullptr);
+  });
+}
+
+std::shared_ptr<ConnectionPool::AsyncWaiter> ConnectionPool::takeAsyncWaiterLocked() {
+  if (asyncWaiters_.empty()) {
+    return nullptr;
+  }
+  // Ждут и потоки: через раз будим поток, чтобы ни те ни другие не голодали
+  if (waiters_ > 0) {
+    preferAsync_ = !preferAsync_;
+    if (!preferAsync_) {
+      return nullptr;
+    }
+  }
+  auto waiter = std::move(asyncWaiters_.front());
+  asyncWaiters_.pop_front();
+  waiter->settled = true;
+  return waiter;
+}
+
+void ConnectionPool::giveBack(std::unique_ptr<Connection> connection) {
+  std::unique_ptr<Connection> broken;
+  std::shared_ptr<AsyncWaiter> waiter;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!connection->handle || PQstatus(connection->handle) != CONNECTION_OK) {
+      broken = std::move(connection);
+      --total_;
+    } else {
+      connection->lastUsed = std::chrono::steady_clock::now();
+      connection->lastChecked = connection->lastUsed;
+    }
+    waiter = takeAsyncWaiterLocked();
+    if (connection && !waiter) {
+      idle_.push_back(std::move(connection));
+    }
+  }
+  // Корутине соединение передаётся из рук в руки; после закрытия — место, чтобы она открыла новое
+  if (waiter) {
+    waiter->resume(nullptr, std::move(connection));
+  } else {
+    available_.notify_one();
+  }
+  // broken закрывается здесь, вне блокировки
+}
+
+void ConnectionPool::recordBroken() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++brokenDetected_;
+}
+
+PoolStats ConnectionPool::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  PoolStats stats;
+  stats.total = total_;
+  stats.idle = idle_.size();
+  stats.inUse = total_ - idle_.size();
+  stats.waiters = waiters_ + asyncWaiters_.size();
+  stats.checkouts = checkouts_;
+  stats.timeouts = timeouts_;
+  stats.brokenDetected = brokenDetected_;
+  stats.totalWait = totalWait_;
+  stats.maxWait = maxWait_;
+  return stats;
+}
+
+void ConnectionPool::reapIdleLocked(std::vector<std::unique_ptr<Connection>>& expired) {
+  const auto threshold = std::chrono::steady_clock::now() - options_.idleTimeout;
+  // idle_ упорядочен по времени возврата: самые старые в начале
+  auto it = idle_.begin();
+  while (it != idle_.end() && total_ > options_.minConnections && (*it)->lastUsed <= threshold) {
+    expired.push_back(std::move(*it));
+    ++it;
+    --total_;
+  }
+  idle_.erase(idle_.begin(), it);
+}
+
+void ConnectionPool::returnIdleLocked(std::unique_ptr<Connection> connection) {
+  // Сохраняем порядок idle_ по lastUsed, на нём держится reaper
+  auto position = std::upper_bound(idle_.begin(), idle_.end(), connection->lastUsed,
+                                   [](const auto& lastUsed, const auto& other) { return lastUsed < other->lastUsed; });
+  idle_.insert(position, std::move(connection));
+}
+
+void ConnectionPool::checkIdleConnections(std::unique_lock<std::mutex>& lock) {
+  const auto threshold = std::chrono::steady_clock::now() - options_.healthCheckIdle;
+
+  // Забираем давно простаивающие соединения из idle_, чтобы их не выдали во время проверки
+  std::vector<std::unique_ptr<Connection>> suspects;
+  for (auto it = idle_.begin(); it != idle_.end();) {
+    if ((*it)->lastChecked <= threshold) {
+      suspects.push_back(std::move(*it));
+      it = idle_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  if (suspects.empty()) {
+    return;
+  }
+
+  lock.unlock();
+  std::size_t broken = 0;
+  for (auto& connection : suspects) {
+    PGresult* result = PQexec(connection->handle, "SELECT 1");
+    const bool alive = result && PQresultStatus(result) == PGRES_TUPLES_OK;
+    if (result) {
+      PQclear(result);
+    }
+    if (alive) {
+      connection->lastChecked = std::chrono::steady_clock::now();
+    } else {
+      ++broken;
+      PQfinish(connection->handle);
+      connection->handle = nullptr;
+    }
+  }
+  if (broken > 0) {
+    AUCTION_LOG_WARN("Database health check dropped dead connections").field("count", broken);
+  }
+  lock.lock();
+
+  for (auto& connection : suspects) {
+    if (connection->handle) {
+      returnIdleLocked(std::move(connection));
+    } else {
+      --total_;
+      ++brokenDetected_;
+    }
+  }
+  available_.notify_all();
+}
+
+void ConnectionPool::replenish(std::unique_lock<std::mutex>& lock) {
+  while (!stopping_ && total_ < options_.minConnections) {
+    ++total_;
+    lock.unlock();
+    std::unique_ptr<Connection> connection;
+    try {
+      connection = open();
+    } catch (const std::exception& ex) {
+      AUCTION_LOG_WARN("Database pool failed to open connection").field("error", ex.what());
+    }
+    lock.lock();
+    if (!connection) {
+      --total_;
+      return;
+    }
+    idle_.push_back(std::move(connection));
+    available_.notify_one();
+  }
+}
+
+void ConnectionPool::runMaintenance() {
+  const auto interval = std::clamp<std::chrono::milliseconds>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::min<std::chrono::seconds>(options_.idleTimeout,
+                                                                                           options_.healthCheckIdle)) /
+          2,
+      std::chrono::milliseconds{1000}, std::chrono::milliseconds{30000});
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    maintenanceWakeup_.wait_for(lock, interval, [this] { return stopping_; });
+    if (stopping_) {
+      break;
+    }
+
+    std::vector<std::unique_ptr<Connection>> expired;
+    reapIdleLocked(expired);
+    if (!expired.empty()) {
+      lock.unlock();
+      AUCTION_LOG_DEBUG("Database pool reaped idle connections").field("count", expired.size());
+      expired.clear();
+      lock.lock();
+    }
+
+    checkIdleConnections(lock);
+    replenish(lock);
+  }
+}
+
+}  // namespace auction::core
@@ -1,12 +1,17 @@
 #include "auction/core/database.h"
 
+#include <algorithm>
+#include <array>
 #include <cstdlib>
-#include <iostream>
 #include <stdexcept>
 #include <string>
-#include <thread>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "auction/core/executor.h"
+#include "auction/core/logger.h"
+
 namespace {
 
 std::string requireEnv(const char* key) {
@@ -21,6 +26,44 @@ bool isSuccessExec(PGresult* result) {
   return status == PGRES_TUPLES_OK || status == PGRES_COMMAND_OK;
 }
 
+std::vector<const char*> toParamValues(const std::vector<std::optional<std::string>>& params) {
+  std::vector<const char*> values(params.size(), nullptr);
+  for (std::size_t i = 0; i < params.size(); ++i) {
+    if (params[i].has_value()) {
+      values[i] = params[i]->c_str();
+    }
+  }
+  return values;
+}
+
+// Неблокирующий режим libpq на время обмена из корутины; синхронные вызовы на том же соединении
+// (PQexec и pipeline в executePipeline) рассчитывают на блокирующий
+class NonBlockingScope {
+ public:
+  explicit NonBlockingScope(PGconn* connection)
+      : connection_(connection), ok_(PQsetnonblocking(connection, 1) == 0) {}
+  ~NonBlockingScope() {
+    if (ok_) {
+      PQsetnonblocking(connection_, 0);
+    }
+  }
+
+  NonBlockingScope(const NonBlockingScope&) = delete;
+  NonBlockingScope& operator=(const NonBlockingScope&) = delete;
+
+  explicit operator bool() const { return ok_; }
+
+ private:
+  PGconn* connection_;
+  bool ok_;
+};
+
+auction::core::metrics::Histogram& statementLatency(const std::string& statement) {
+  return auction::core::metrics::Registry::instance().histogram(
+      "auction_db_statement_duration_seconds",
+      "Database call duration including pool checkout, by prepared statement", {{"statement", statement}});
+}
+
 }  // namespace
 
 namespace auction::core {
@@ -43,149 +86,557 @@ std::string Database::buildConnectionString() {
   return connection;
 }
 
-Database::Database() {
-  connectionString_ = buildConnectionString();
-  connection_ = PQconnectdb(connectionString_.c_str());
-  if (!connection_ || PQstatus(connection_) != CONNECTION_OK) {
-    throw std::runtime_error(std::string{"Failed to connect to database: "} + PQerrorMessage(connection_));
+Database::Database()
+    : queryLatency_(statementLatency("(query)")),
+      pipelineLatency_(statementLatency("(pipeline)")),
+      copyLatency_(statementLatency("(copy)")) {
+  const auto options = PoolOptions::fromEnvironment();
+  pool_ = std::make_unique<ConnectionPool>(buildConnectionString(), options);
+
+  // Начинаем с размера пула: дальше лимит подстраивается под задержку БД, но по умолчанию не выше него
+  auto limiterOptions = LimiterOptions::fromEnvironment();
+  limiterOptions.initialLimit = options.maxConnections;
+  if (limiterOptions.maxLimit == 0) {
+    limiterOptions.maxLimit = options.maxConnections;
+  }
+  limiter_ = std::make_unique<ConcurrencyLimiter>(limiterOptions);
+  AUCTION_LOG_INFO("Database connected")
+      .field("pool_min", options.minConnections)
+      .field("pool_max", options.maxConnections)
+      .field("limit_max", limiterOptions.maxLimit);
+}
+
+Database::~Database() = default;
+
+PoolStats Database::poolStats() const {
+  return pool_->stats();
+}
+
+LimiterStats Database::limiterStats() const {
+  return limiter_->stats();
+}
+
+std::unique_ptr<PgListener> Database::listen(std::string channel, PgListener::NotifyHandler onNotify,
+                                             PgListener::StateHandler onState) const {
+  return std::make_unique<PgListener>(buildConnectionString(), std::move(channel), std::move(onNotify),
+                                      std::move(onState));
+}
+
+void Database::ensureConnected(ConnectionPool::Lease& connection) {
+  // Только локальная проверка статуса; живость простаивающих соединений проверяет пул в фоне
+  if (PQstatus(connection.get()) != CONNECTION_OK) {
+    AUCTION_LOG_WARN("Database connection lost, reconnecting");
+    connection.reconnect();
+  }
+}
+
+Task<void> Database::ensureConnectedTask(ConnectionPool::Lease& connection) {
+  if (PQstatus(connection.get()) != CONNECTION_OK) {
+    AUCTION_LOG_WARN("Database connection lost, reconnecting");
+    co_await connection.reconnectTask();
+  }
+}
+
+bool Database::isConnectionFailure(PGconn* connection, PGresult* result) {
+  if (PQstatus(connection) == CONNECTION_BAD) {
+    return true;
+  }
+  if (!result) {
+    return false;
+  }
+
+  // 08xxx — ошибки соединения, 57P01..57P03 — сервер (или pooler) закрывает сессию
+  const char* state = PQresultErrorField(result, PG_DIAG_SQLSTATE);
+  if (!state) {
+    return false;
   }
-  std::cerr << "Database connected successfully" << std::endl;
+  const std::string_view sqlState{state};
+  return sqlState.substr(0, 2) == "08" || sqlState == "57P01" || sqlState == "57P02" || sqlState == "57P03";
 }
 
-Database::~Database() {
-  if (connection_) {
-    PQfinish(connection_);
-    connection_ = nullptr;
+Database::Statement Database::lookup(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(statementsMutex_);
+  auto it = statements_.find(name);
+  if (it == statements_.end()) {
+    throw std::runtime_error("Unknown prepared statement: " + name);
   }
+  return it->second;
 }
 
-void Database::reconnect() {
-  std::cerr << "Attempting to reconnect to database..." << std::endl;
-  
-  if (connection_) {
-    PQfinish(connection_);
-    connection_ = nullptr;
+Database::ResultPtr Database::settle(const char* what, bool idempotent, int attempt,
+                                    ConnectionPool::Lease& connection, PGresult* rawResult) {
+  if (rawResult && isSuccessExec(rawResult)) {
+    return makeResult(rawResult);
+  }
+
+  std::string error = rawResult ? PQresultErrorMessage(rawResult) : PQerrorMessage(connection.get());
+  const bool broken = isConnectionFailure(connection.get(), rawResult);
+  if (rawResult) {
+    PQclear(rawResult);
+  }
+
+  if (!broken) {
+    throw std::runtime_error(std::string{what} + error);
+  }
+
+  pool_->recordBroken();
+  AUCTION_LOG_WARN("Database connection broken").field("error", error).field("idempotent", idempotent);
+  if (!idempotent || attempt > 0) {
+    connection.discard();
+    throw std::runtime_error(std::string{what} + error);
   }
-  
-  // Пробуем переподключиться до 3 раз
-  for (int attempt = 1; attempt <= 3; ++attempt) {
-    std::cerr << "Reconnect attempt " << attempt << "/3" << std::endl;
-    
-    connection_ = PQconnectdb(connectionString_.c_str());
-    if (connection_ && PQstatus(connection_) == CONNECTION_OK) {
-      std::cerr << "Database reconnected successfully" << std::endl;
-      needReconnect_ = true;  // Сигнал, что prepared statements нужно пересоздать
-      return;
+
+  // Statement идемпотентен — повторяем один раз на новом соединении; переоткрывает его вызывающий
+  return makeResult(nullptr);
+}
+
+template <typename Exec>
+Database::ResultPtr Database::run(const char* what, bool idempotent, Priority priority, Exec&& exec) {
+  auto permit = limiter_->acquire(priority);
+  auto connection = pool_->acquire();
+  ensureConnected(connection);
+
+  for (int attempt = 0;; ++attempt) {
+    if (auto result = settle(what, idempotent, attempt, connection, exec(connection))) {
+      permit.succeeded();
+      return result;
     }
-    
-    std::cerr << "Reconnect failed: " << (connection_ ? PQerrorMessage(connection_) : "null connection") << std::endl;
-    
-    if (attempt < 3) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(500 * attempt));
+    connection.reconnect();
+  }
+}
+
+PGresult* Database::ensurePrepared(ConnectionPool::Lease& connection, const std::string& name,
+                                   const Statement& statement) {
+  if (connection.isPrepared(name)) {
+    return nullptr;
+  }
+
+  PGresult* rawResult = PQprepare(connection.get(), name.c_str(), statement.sql.c_str(), 0, nullptr);
+  if (!rawResult) {
+    return PQmakeEmptyPGresult(connection.get(), PGRES_FATAL_ERROR);
+  }
+  if (PQresultStatus(rawResult) != PGRES_COMMAND_OK) {
+    return rawResult;
+  }
+
+  PQclear(rawResult);
+  connection.markPrepared(name);
+  return nullptr;
+}
+
+Database::ResultPtr Database::query(const std::string& sql, const std::vector<std::optional<std::string>>& params,
+                                    StatementOptions options) {
+  metrics::ScopedTimer timer(queryLatency_);
+  const auto values = toParamValues(params);
+  return run("Database query failed: ", options.idempotent, options.priority, [&](ConnectionPool::Lease& connection) {
+    return PQexecParams(connection.get(), sql.c_str(), static_cast<int>(values.size()), nullptr, values.data(),
+                        nullptr, nullptr, 0);
+  });
+}
+
+void Database::prepare(const std::string& name, const std::string& sql, StatementOptions options) {
+  const Statement statement{sql, options, &statementLatency(name)};
+  {
+    std::lock_guard<std::mutex> lock(statementsMutex_);
+    statements_[name] = statement;
+  }
+
+  // Сразу готовим на одном соединении, чтобы ошибки в SQL всплывали при старте
+  run("Database prepare failed: ", true, options.priority, [&](ConnectionPool::Lease& connection) -> PGresult* {
+    if (PGresult* failure = ensurePrepared(connection, name, statement)) {
+      return failure;
     }
+    return PQmakeEmptyPGresult(connection.get(), PGRES_COMMAND_OK);
+  });
+}
+
+Database::ResultPtr Database::executePrepared(const std::string& name,
+                                              const std::vector<std::optional<std::string>>& params) {
+  const auto statement = lookup(name);
+  metrics::ScopedTimer timer(*statement.latency);
+  const auto values = toParamValues(params);
+  return run("Database execute prepared failed: ", statement.options.idempotent, statement.options.priority,
+             [&](ConnectionPool::Lease& connection) -> PGresult* {
+               if (!connection.isPrepared(name)) {
+                 // Parse и Execute уходят одним пакетом — первое использование на соединении стоит один round trip
+                 std::vector<ResultPtr> results;
+                 if (PGresult* failure = runPipeline(connection, {PipelineStep{name, params}}, {statement}, results)) {
+                   return failure;
+                 }
+                 return results.front().release();
+               }
+               return PQexecPrepared(connection.get(), name.c_str(), static_cast<int>(values.size()), values.data(),
+                                     nullptr, nullptr, statement.options.binaryResults ? 1 : 0);
+             });
+}
+
+Task<Database::ResultPtr> Database::executePreparedTask(std::string name,
+                                                       std::vector<std::optional<std::string>> params) {
+  const auto statement = lookup(name);
+  metrics::ScopedTimer timer(*statement.latency);
+  const auto values = toParamValues(params);
+  auto permit = co_await limiter_->acquireTask(statement.options.priority);
+  auto connection = co_await pool_->acquireTask();
+  co_await ensureConnectedTask(connection);
+
+  for (int attempt = 0;; ++attempt) {
+    // Без pipeline: на новом соединении Parse и Execute идут двумя обменами, дальше — одним
+    PGresult* rawResult = co_await ensurePreparedTask(connection, name, statement);
+    if (!rawResult) {
+      rawResult = co_await exchange(connection, [&](PGconn* handle) {
+        return PQsendQueryPrepared(handle, name.c_str(), static_cast<int>(values.size()), values.data(), nullptr,
+                                   nullptr, statement.options.binaryResults ? 1 : 0);
+      });
+    }
+    if (auto result = settle("Database execute prepared failed: ", statement.options.idempotent, attempt,
+                             connection, rawResult)) {
+      permit.succeeded();
+      co_return result;
+    }
+    co_await connection.reconnectTask();
   }
-  
-  throw std::runtime_error("Failed to reconnect to database after 3 attempts");
 }
 
-bool Database::checkAndClearReconnectFlag() {
-  if (needReconnect_) {
-    needReconnect_ = false;
-    return true;
+Task<PGresult*> Database::ensurePreparedTask(ConnectionPool::Lease& connection, const std::string& name,
+                                             const Statement& statement) {
+  if (connection.isPrepared(name)) {
+    co_return nullptr;
+  }
+
+  PGresult* rawResult = co_await exchange(connection, [&](PGconn* handle) {
+    return PQsendPrepare(handle, name.c_str(), statement.sql.c_str(), 0, nullptr);
+  });
+  if (!rawResult) {
+    co_return PQmakeEmptyPGresult(connection.get(), PGRES_FATAL_ERROR);
   }
-  return false;
+  if (PQresultStatus(rawResult) != PGRES_COMMAND_OK) {
+    co_return rawResult;
+  }
+
+  PQclear(rawResult);
+  connection.markPrepared(name);
+  co_return nullptr;
 }
 
-void Database::ensureConnected() {
-  if (!connection_) {
-    reconnect();
-    return;
+Task<PGresult*> Database::exchange(ConnectionPool::Lease& connection, const std::function<int(PGconn*)>& send) {
+  PGconn* handle = connection.get();
+  const NonBlockingScope nonBlocking(handle);
+  if (!nonBlocking || send(handle) == 0) {
+    co_return nullptr;
   }
+  const int socket = PQsocket(handle);
 
-  // Проверяем статус соединения
-  if (PQstatus(connection_) != CONNECTION_OK) {
-    std::cerr << "Database connection lost, attempting reconnect..." << std::endl;
-    reconnect();
-    return;
+  // Запрос мог не уместиться в буфер сокета: дописываем по мере готовности, вычитывая входящее
+  for (int pending = PQflush(handle); pending != 0; pending = PQflush(handle)) {
+    if (pending < 0) {
+      co_return nullptr;
+    }
+    co_await Executor::readableOrWritable(socket);
+    if (PQconsumeInput(handle) == 0) {
+      co_return nullptr;
+    }
   }
-  
-  // Дополнительно делаем ping для проверки живости соединения
-  PGresult* result = PQexec(connection_, "SELECT 1");
-  if (!result || PQresultStatus(result) != PGRES_TUPLES_OK) {
-    if (result) PQclear(result);
-    std::cerr << "Database ping failed, attempting reconnect..." << std::endl;
-    reconnect();
-    return;
+
+  // Ответ на один запрос — один результат и завершающий nullptr; лишние результаты не ожидаются
+  PGresult* first = nullptr;
+  for (;;) {
+    while (PQisBusy(handle) != 0) {
+      co_await Executor::readable(socket);
+      if (PQconsumeInput(handle) == 0) {
+        PQclear(first);
+        co_return nullptr;
+      }
+    }
+    PGresult* next = PQgetResult(handle);
+    if (!next) {
+      break;
+    }
+    if (first) {
+      PQclear(next);
+    } else {
+      first = next;
+    }
   }
-  PQclear(result);
+  co_return first;
 }
 
-Database::ResultPtr Database::query(const std::string& sql, const std::vector<std::optional<std::string>>& params) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  ensureConnected();
+void Database::copyIn(const std::string& copySql, const std::string& data) {
+  metrics::ScopedTimer timer(copyLatency_);
+  // История ставок пишется фоном: уступая чтениям, она копилась бы в буфере BidRecorder
+  run("Database copy failed: ", false, Priority::high, [&](ConnectionPool::Lease& connection) -> PGresult* {
+    PGconn* conn = connection.get();
+    PGresult* start = PQexec(conn, copySql.c_str());
+    if (!start || PQresultStatus(start) != PGRES_COPY_IN) {
+      return start;
+    }
+    PQclear(start);
 
-  std::vector<const char*> values(params.size(), nullptr);
-  for (std::size_t i = 0; i < params.size(); ++i) {
-    if (params[i].has_value()) {
-      values[i] = params[i]->c_str();
+    auto abandon = [&connection]() {
+      // Соединение осталось в состоянии COPY — в пул его не возвращаем
+      PGresult* failure = PQmakeEmptyPGresult(connection.get(), PGRES_FATAL_ERROR);
+      connection.discard();
+      return failure;
+    };
+
+    // Отдаём данные кусками, чтобы не держать в libpq вторую копию большого пакета
+    constexpr std::size_t kChunk = 64 * 1024;
+    for (std::size_t offset = 0; offset < data.size(); offset += kChunk) {
+      const auto length = std::min(kChunk, data.size() - offset);
+      if (PQputCopyData(conn, data.data() + offset, static_cast<int>(length)) != 1) {
+        return abandon();
+      }
+    }
+    if (PQputCopyEnd(conn, nullptr) != 1) {
+      return abandon();
+    }
+
+    // Итог COPY, затем nullptr
+    PGresult* result = PQgetResult(conn);
+    while (PGresult* extra = PQgetResult(conn)) {
+      PQclear(extra);
+    }
+    return result;
+  });
+}
+
+Task<Database::RowStream> Database::openStreamTask(std::string name,
+                                                   std::vector<std::optional<std::string>> params) {
+  auto statement = lookup(name);
+  // Время потоковой выдачи зависит от скорости клиента, поэтому в оценку задержки БД оно не попадает
+  auto permit = co_await limiter_->acquireTask(statement.options.priority);
+  auto connection = co_await pool_->acquireTask();
+  co_await ensureConnectedTask(connection);
+
+  if (PGresult* failure = co_await ensurePreparedTask(connection, name, statement)) {
+    const std::string error = PQresultErrorMessage(failure);
+    if (isConnectionFailure(connection.get(), failure)) {
+      pool_->recordBroken();
+      connection.discard();
     }
+    PQclear(failure);
+    throw std::runtime_error("Database stream failed: " + error);
   }
 
-  PGresult* rawResult =
-      PQexecParams(connection_, sql.c_str(), static_cast<int>(values.size()), nullptr, values.data(), nullptr, nullptr, 0);
+  co_return RowStream(*this, std::move(name), std::move(statement), std::move(params), std::move(permit),
+                      std::move(connection));
+}
+
+Database::RowStream::RowStream(Database& database, std::string name, Statement statement,
+                               std::vector<std::optional<std::string>> params, ConcurrencyLimiter::Permit permit,
+                               ConnectionPool::Lease connection)
+    : database_(&database),
+      name_(std::move(name)),
+      statement_(std::move(statement)),
+      params_(std::move(params)),
+      permit_(std::move(permit)),
+      connection_(std::move(connection)) {}
+
+void Database::RowStream::read(const std::function<bool(const PGresult*)>& onRow) {
+  if (consumed_) {
+    throw std::logic_error("Database stream already read");
+  }
+  consumed_ = true;
 
-  if (!rawResult || !isSuccessExec(rawResult)) {
-    std::string error = rawResult ? PQresultErrorMessage(rawResult) : PQerrorMessage(connection_);
+  metrics::ScopedTimer timer(*statement_.latency);
+  const auto values = toParamValues(params_);
+
+  auto fail = [&](PGresult* rawResult) {
+    std::string error = rawResult ? PQresultErrorMessage(rawResult) : PQerrorMessage(connection_.get());
+    if (isConnectionFailure(connection_.get(), rawResult)) {
+      database_->pool_->recordBroken();
+      connection_.discard();
+    }
     if (rawResult) {
       PQclear(rawResult);
     }
-    throw std::runtime_error("Database query failed: " + error);
+    throw std::runtime_error("Database stream failed: " + error);
+  };
+
+  if (PQsendQueryPrepared(connection_.get(), name_.c_str(), static_cast<int>(values.size()), values.data(), nullptr,
+                          nullptr, statement_.options.binaryResults ? 1 : 0) != 1 ||
+      PQsetSingleRowMode(connection_.get()) != 1) {
+    fail(nullptr);
   }
 
-  return makeResult(rawResult);
+  bool cancelled = false;
+  PGresult* failure = nullptr;
+  while (PGresult* rawResult = PQgetResult(connection_.get())) {
+    const ExecStatusType status = PQresultStatus(rawResult);
+    if (status == PGRES_SINGLE_TUPLE && !cancelled && !failure) {
+      ResultPtr row = makeResult(rawResult);
+      bool keepGoing = false;
+      try {
+        keepGoing = onRow(row.get());
+      } catch (...) {
+        // Непрочитанный остаток результата не даёт вернуть соединение в пул
+        connection_.discard();
+        throw;
+      }
+      if (!keepGoing) {
+        // Клиент ушёл — просим сервер прекратить отдачу и дочитываем остаток
+        cancelled = true;
+        if (PGcancel* cancel = PQgetCancel(connection_.get())) {
+          std::array<char, 256> error{};
+          PQcancel(cancel, error.data(), static_cast<int>(error.size()));
+          PQfreeCancel(cancel);
+        }
+      }
+    } else if (status != PGRES_SINGLE_TUPLE && status != PGRES_TUPLES_OK && !cancelled && !failure) {
+      failure = rawResult;
+    } else {
+      PQclear(rawResult);
+    }
+  }
+
+  if (failure) {
+    fail(failure);
+  }
 }
 
-void Database::prepare(const std::string& name, const std::string& sql) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  ensureConnected();
+std::vector<Database::ResultPtr> Database::executePipeline(const std::vector<PipelineStep>& steps) {
+  if (steps.empty()) {
+    return {};
+  }
 
-  PGresult* rawResult = PQprepare(connection_, name.c_str(), sql.c_str(), 0, nullptr);
-  if (!rawResult || PQresultStatus(rawResult) != PGRES_COMMAND_OK) {
-    std::string error = rawResult ? PQresultErrorMessage(rawResult) : PQerrorMessage(connection_);
-    if (rawResult) {
-      PQclear(rawResult);
+  std::vector<std::optional<Statement>> statements;
+  statements.reserve(steps.size());
+  bool idempotent = true;
+  // Пакет идёт с приоритетом самого важного шага; SQL-шаги — обычные
+  Priority priority = Priority::low;
+  for (const auto& step : steps) {
+    if (step.prepared) {
+      statements.push_back(lookup(step.statement));
+      idempotent = idempotent && statements.back()->options.idempotent;
+      priority = std::min(priority, statements.back()->options.priority);
+    } else {
+      statements.emplace_back();
+      idempotent = idempotent && step.idempotent;
+      priority = std::min(priority, Priority::normal);
     }
-    throw std::runtime_error("Database prepare failed: " + error);
   }
 
-  PQclear(rawResult);
+  metrics::ScopedTimer timer(pipelineLatency_);
+  std::vector<ResultPtr> results;
+  run("Database pipeline failed: ", idempotent, priority, [&](ConnectionPool::Lease& connection) -> PGresult* {
+    results.clear();
+    if (PGresult* failure = runPipeline(connection, steps, statements, results)) {
+      return failure;
+    }
+    return PQmakeEmptyPGresult(connection.get(), PGRES_COMMAND_OK);
+  });
+  return results;
 }
 
-Database::ResultPtr Database::executePrepared(const std::string& name,
-                                              const std::vector<std::optional<std::string>>& params) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  ensureConnected();
+PGresult* Database::runPipeline(ConnectionPool::Lease& connection, const std::vector<PipelineStep>& steps,
+                                const std::vector<std::optional<Statement>>& statements,
+                                std::vector<ResultPtr>& results) {
+  PGconn* conn = connection.get();
 
-  std::vector<const char*> values(params.size(), nullptr);
-  for (std::size_t i = 0; i < params.size(); ++i) {
-    if (params[i].has_value()) {
-      values[i] = params[i]->c_str();
+  // Что ожидаем в ответ: Parse для ещё не подготовленных statements или сам шаг
+  struct Expected {
+    std::size_t step;
+    bool parse;
+  };
+  std::vector<Expected> expected;
+  expected.reserve(steps.size() * 2);
+
+  auto abandon = [&connection]() {
+    // Состояние протокола неизвестно — соединение в пул не возвращаем
+    PGresult* failure = PQmakeEmptyPGresult(connection.get(), PGRES_FATAL_ERROR);
+    connection.discard();
+    return failure;
+  };
+
+  if (PQenterPipelineMode(conn) != 1) {
+    return PQmakeEmptyPGresult(conn, PGRES_FATAL_ERROR);
+  }
+
+  // Пакет отправляется в блокирующем режиме, поэтому он рассчитан на небольшое число шагов:
+  // очень большой pipeline может упереться в заполненные сокетные буферы с обеих сторон.
+  std::vector<std::string> parsing;
+  for (std::size_t i = 0; i < steps.size(); ++i) {
+    const auto& step = steps[i];
+    const auto values = toParamValues(step.params);
+    const int count = static_cast<int>(values.size());
+
+    int sent = 0;
+    if (step.prepared) {
+      const bool alreadyParsing = std::find(parsing.begin(), parsing.end(), step.statement) != parsing.end();
+      if (!connection.isPrepared(step.statement) && !alreadyParsing) {
+        if (PQsendPrepare(conn, step.statement.c_str(), statements[i]->sql.c_str(), 0, nullptr) != 1) {
+          return abandon();
+        }
+        parsing.push_back(step.statement);
+        expected.push_back({i, true});
+      }
+      sent = PQsendQueryPrepared(conn, step.statement.c_str(), count, values.data(), nullptr, nullptr,
+                                 statements[i]->options.binaryResults ? 1 : 0);
+    } else {
+      sent = PQsendQueryParams(conn, step.statement.c_str(), count, nullptr, values.data(), nullptr, nullptr, 0);
     }
+    if (sent != 1) {
+      return abandon();
+    }
+    expected.push_back({i, false});
   }
 
-  PGresult* rawResult = PQexecPrepared(connection_, name.c_str(), static_cast<int>(values.size()), values.data(), nullptr,
-                                       nullptr, 0);
+  if (PQpipelineSync(conn) != 1) {
+    return abandon();
+  }
 
-  if (!rawResult || !isSuccessExec(rawResult)) {
-    std::string error = rawResult ? PQresultErrorMessage(rawResult) : PQerrorMessage(connection_);
-    if (rawResult) {
+  PGresult* failure = nullptr;
+  results.reserve(steps.size());
+  for (const auto& item : expected) {
+    PGresult* rawResult = PQgetResult(conn);
+    if (!rawResult) {
+      if (failure) {
+        PQclear(failure);
+      }
+      return abandon();
+    }
+
+    const ExecStatusType status = PQresultStatus(rawResult);
+    if (status == PGRES_PIPELINE_ABORTED) {
+      PQclear(rawResult);
+    } else if (!isSuccessExec(rawResult)) {
+      if (!failure) {
+        failure = rawResult;
+      } else {
+        PQclear(rawResult);
+      }
+    } else if (item.parse) {
+      connection.markPrepared(steps[item.step].statement);
       PQclear(rawResult);
+    } else {
+      results.push_back(makeResult(rawResult));
     }
-    throw std::runtime_error("Database execute prepared failed: " + error);
+
+    // После результатов каждой команды PQgetResult возвращает nullptr
+    if (PGresult* extra = PQgetResult(conn)) {
+      PQclear(extra);
+      if (failure) {
+        PQclear(failure);
+      }
+      return abandon();
+    }
+  }
+
+  PGresult* sync = PQgetResult(conn);
+  const bool synced = sync && PQresultStatus(sync) == PGRES_PIPELINE_SYNC;
+  if (sync) {
+    PQclear(sync);
+  }
+  if (!synced || PQexitPipelineMode(conn) != 1) {
+    if (failure) {
+      PQclear(failure);
+    }
+    return abandon();
   }
 
-  return makeResult(rawResult);
+  if (failure) {
+    results.clear();
+  }
+  return failure;
 }
 
 }  // namespace auction::core
-
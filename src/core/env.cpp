@@ -0,0 +1,28 @@
+#include "auction/core/env.h"
+
+#include <cstdlib>
+#include <stdexcept>
+
+#include "auction/core/logger.h"
+
+namespace auction::core {
+
+std::optional<std::string> readEnv(const char* key) {
+  if (const char* value = std::getenv(key); value != nullptr && *value != '\0') {
+    return std::string{value};
+  }
+  return std::nullopt;
+}
+
+std::size_t envSize(const char* key, std::size_t fallback) {
+  if (auto value = readEnv(key)) {
+    try {
+      return static_cast<std::size_t>(std::stoul(*value));
+    } catch (const std::exception&) {
+      AUCTION_LOG_WARN("Ignoring invalid environment value").field("key", key).field("value", *value);
+    }
+  }
+  return fallback;
+}
+
+}  // namespace auction::core
@@ -0,0 +1,286 @@
+#include "auction/core/executor.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <queue>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "auction/core/env.h"
+#include "auction/core/logger.h"
+
+namespace auction::core {
+
+namespace {
+
+constexpr int kMaxEvents = 256;
+
+}  // namespace
+
+ExecutorOptions ExecutorOptions::fromEnvironment() {
+  ExecutorOptions options;
+  options.threads = envSize("EXECUTOR_THREADS", options.threads);
+  return options;
+}
+
+class Executor::Thread {
+ public:
+  Thread() {
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd_ < 0 || wakeFd_ < 0) {
+      closeFds();
+      throw std::system_error(errno, std::generic_category(), "Failed to create executor epoll");
+    }
+    epoll_event wake{};
+    wake.events = EPOLLIN;
+    wake.data.fd = wakeFd_;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &wake) != 0) {
+      const int error = errno;
+      closeFds();
+      throw std::system_error(error, std::generic_category(), "Failed to watch executor eventfd");
+    }
+    thread_ = std::thread([this] { run(); });
+  }
+
+  ~Thread() {
+    stop();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    closeFds();
+  }
+
+  Thread(const Thread&) = delete;
+  Thread& operator=(const Thread&) = delete;
+  Thread(Thread&&) = delete;
+  Thread& operator=(Thread&&) = delete;
+
+  static Thread* current() { return current_; }
+
+  void stop() {
+    stopping_.store(true, std::memory_order_release);
+    wake();
+  }
+
+  void post(std::coroutine_handle<> handle) {
+    // Свой поток кладёт в очередь без блокировки: до неё дойдёт очередь на этом же витке
+    if (current_ == this) {
+      ready_.push_back(handle);
+      return;
+    }
+    bool wasEmpty = false;
+    {
+      std::lock_guard<std::mutex> lock(inboxMutex_);
+      wasEmpty = inbox_.empty();
+      inbox_.push_back(handle);
+    }
+    // Поток забирает весь inbox_ за раз: будить его нужно, только если очередь была пуста
+    if (wasEmpty) {
+      wake();
+    }
+  }
+
+  void watch(int fd, std::uint32_t events, std::coroutine_handle<> handle) {
+    epoll_event event{};
+    event.events = events | EPOLLONESHOT;
+    event.data.fd = fd;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+      throw std::system_error(errno, std::generic_category(), "Failed to watch descriptor");
+    }
+    watches_[fd] = handle;
+  }
+
+  void after(std::chrono::milliseconds delay, std::function<void()> callback) {
+    timers_.push(Timer{std::chrono::steady_clock::now() + delay, nextTimer_++, std::move(callback)});
+  }
+
+ private:
+  struct Timer {
+    std::chrono::steady_clock::time_point deadline;
+    // Таймеры с одинаковым сроком срабатывают в порядке постановки
+    std::uint64_t sequence;
+    std::function<void()> callback;
+
+    bool operator>(const Timer& other) const {
+      return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence;
+    }
+  };
+
+  static thread_local Thread* current_;
+
+  std::atomic<bool> stopping_{false};
+  int epollFd_{-1};
+  int wakeFd_{-1};
+  std::mutex inboxMutex_;
+  std::vector<std::coroutine_handle<>> inbox_;
+
+  // Доступно только своему потоку
+  std::vector<std::coroutine_handle<>> ready_;
+  std::vector<std::coroutine_handle<>> running_;
+  std::unordered_map<int, std::coroutine_handle<>> watches_;
+  std::priority_queue<Timer, std::vector<Timer>, std::greater<>> timers_;
+  std::uint64_t nextTimer_{0};
+
+  std::thread thread_;
+
+  void wake() {
+    const std::uint64_t one = 1;
+    [[maybe_unused]] const auto written = ::write(wakeFd_, &one, sizeof(one));
+  }
+
+  void closeFds() {
+    if (wakeFd_ >= 0) {
+      ::close(wakeFd_);
+      wakeFd_ = -1;
+    }
+    if (epollFd_ >= 0) {
+      ::close(epollFd_);
+      epollFd_ = -1;
+    }
+  }
+
+  void run() {
+    current_ = this;
+    std::array<epoll_event, kMaxEvents> events{};
+    while (!stopping_.load(std::memory_order_acquire)) {
+      {
+        std::lock_guard<std::mutex> lock(inboxMutex_);
+        ready_.insert(ready_.end(), inbox_.begin(), inbox_.end());
+        inbox_.clear();
+      }
+      fireTimers();
+      runReady();
+
+      const int count = epoll_wait(epollFd_, events.data(), kMaxEvents, ready_.empty() ? nextTimeout() : 0);
+      if (count < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        AUCTION_LOG_ERROR("Executor epoll_wait failed").field("error", std::strerror(errno));
+        break;
+      }
+
+      for (int i = 0; i < count; ++i) {
+        const int fd = events[i].data.fd;
+        if (fd == wakeFd_) {
+          std::uint64_t value = 0;
+          [[maybe_unused]] const auto drained = ::read(wakeFd_, &value, sizeof(value));
+          continue;
+        }
+        // EPOLLONESHOT уже снял интерес; убираем fd, чтобы его можно было ждать в другом потоке
+        epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+        if (auto it = watches_.find(fd); it != watches_.end()) {
+          ready_.push_back(it->second);
+          watches_.erase(it);
+        }
+      }
+    }
+    current_ = nullptr;
+  }
+
+  void runReady() {
+    // Возобновлённые корутины могут ставить в ready_ новые — они выполнятся на следующем витке,
+    // после проверки сокетов, чтобы одна цепочка не могла занять поток навсегда
+    running_.swap(ready_);
+    for (auto handle : running_) {
+      handle.resume();
+    }
+    running_.clear();
+  }
+
+  void fireTimers() {
+    const auto now = std::chrono::steady_clock::now();
+    while (!timers_.empty() && timers_.top().deadline <= now) {
+      auto callback = std::move(const_cast<Timer&>(timers_.top()).callback);
+      timers_.pop();
+      try {
+        callback();
+      } catch (const std::exception& ex) {
+        AUCTION_LOG_ERROR("Executor timer callback failed").field("error", ex.what());
+      }
+    }
+  }
+
+  [[nodiscard]] int nextTimeout() const {
+    if (timers_.empty()) {
+      return -1;
+    }
+    const auto left = timers_.top().deadline - std::chrono::steady_clock::now();
+    // Округляем вверх: проснуться раньше срока — лишний виток цикла
+    return static_cast<int>(std::max<std::int64_t>(
+        std::chrono::ceil<std::chrono::milliseconds>(left).count(), 0));
+  }
+};
+
+thread_local Executor::Thread* Executor::Thread::current_ = nullptr;
+
+Executor::Executor(ExecutorOptions options) {
+  const std::size_t count =
+      options.threads > 0 ? options.threads : std::max(1U, std::thread::hardware_concurrency());
+  threads_.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    threads_.push_back(std::make_unique<Thread>());
+  }
+  AUCTION_LOG_INFO("Coroutine executor started").field("threads", count);
+}
+
+Executor::~Executor() {
+  // Сначала просим остановиться все потоки, потом ждём: так остановка не растягивается на N витков
+  for (auto& thread : threads_) {
+    thread->stop();
+  }
+  threads_.clear();
+}
+
+void Executor::spawn(Task<void> task) {
+  auto root = launch(std::move(task));
+  threads_[next_.fetch_add(1, std::memory_order_relaxed) % threads_.size()]->post(root.handle);
+}
+
+detail::Detached Executor::launch(Task<void> task) {
+  try {
+    co_await std::move(task);
+  } catch (const std::exception& ex) {
+    AUCTION_LOG_ERROR("Unhandled exception in coroutine").field("error", ex.what());
+  } catch (...) {
+    AUCTION_LOG_ERROR("Unhandled exception in coroutine");
+  }
+}
+
+bool Executor::inExecutorThread() { return Thread::current() != nullptr; }
+
+Executor::Thread& Executor::currentThread() {
+  Thread* thread = Thread::current();
+  if (!thread) {
+    throw std::logic_error("Awaiting outside of an executor thread");
+  }
+  return *thread;
+}
+
+void Executor::resume(Thread& thread, std::coroutine_handle<> handle) { thread.post(handle); }
+
+void Executor::watch(Thread& thread, int fd, std::uint32_t events, std::coroutine_handle<> handle) {
+  thread.watch(fd, events, handle);
+}
+
+Executor::FdAwaiter Executor::readable(int fd) { return FdAwaiter{fd, EPOLLIN}; }
+
+Executor::FdAwaiter Executor::writable(int fd) { return FdAwaiter{fd, EPOLLOUT}; }
+
+Executor::FdAwaiter Executor::readableOrWritable(int fd) { return FdAwaiter{fd, EPOLLIN | EPOLLOUT}; }
+
+void Executor::after(std::chrono::milliseconds delay, std::function<void()> callback) {
+  currentThread().after(delay, std::move(callback));
+}
+
+}  // namespace auction::core
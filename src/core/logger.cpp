@@ -0,0 +1,360 @@
+#include "auction/core/logger.h"
+
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "auction/core/env.h"
+
+namespace auction::core {
+
+namespace {
+
+constexpr std::size_t kRingCapacity = 4096;
+constexpr auto kFlushInterval = std::chrono::milliseconds{20};
+
+void appendEscaped(std::string& out, std::string_view value) {
+  for (const char ch : value) {
+    switch (ch) {
+      case '"':
+        out += "\\\"";
+        break;
+      case '\\':
+        out += "\\\\";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      case '\r':
+        out += "\\r";
+        break;
+      case '\t':
+        out += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(ch) < 0x20) {
+          char buffer[8];
+          std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(ch));
+          out += buffer;
+        } else {
+          out += ch;
+        }
+    }
+  }
+}
+
+void appendTimestamp(std::string& out) {
+  const auto now = std::chrono::system_clock::now();
+  const auto seconds = std::chrono::system_clock::to_time_t(now);
+  const auto millis =
+      std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+  std::tm utc{};
+  gmtime_r(&seconds, &utc);
+  char buffer[32];
+  const int length = std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ", utc.tm_year + 1900,
+                                   utc.tm_mon + 1, utc.tm_mday, utc.tm_hour, utc.tm_min, utc.tm_sec,
+                                   static_cast<int>(millis));
+  out.append(buffer, static_cast<std::size_t>(length));
+}
+
+void writeAll(const std::string& data) {
+  const char* cursor = data.data();
+  std::size_t left = data.size();
+  while (left > 0) {
+    const ssize_t written = ::write(STDERR_FILENO, cursor, left);
+    if (written <= 0) {
+      return;
+    }
+    cursor += written;
+    left -= static_cast<std::size_t>(written);
+  }
+}
+
+}  // namespace
+
+std::optional<LogLevel> parseLogLevel(std::string_view name) {
+  if (name == "debug") {
+    return LogLevel::Debug;
+  }
+  if (name == "info") {
+    return LogLevel::Info;
+  }
+  if (name == "warn" || name == "warning") {
+    return LogLevel::Warn;
+  }
+  if (name == "error") {
+    return LogLevel::Error;
+  }
+  if (name == "off") {
+    return LogLevel::Off;
+  }
+  return std::nullopt;
+}
+
+std::string_view logLevelName(LogLevel level) {
+  switch (level) {
+    case LogLevel::Debug:
+      return "debug";
+    case LogLevel::Info:
+      return "info";
+    case LogLevel::Warn:
+      return "warn";
+    case LogLevel::Error:
+      return "error";
+    case LogLevel::Off:
+      break;
+  }
+  return "off";
+}
+
+// Кольцо одного потока: пишет только владелец, читает только держатель drainMutex_
+struct Logger::Ring {
+  std::array<std::string, kRingCapacity> slots;
+  std::atomic<std::size_t> head{0};
+  std::atomic<std::size_t> tail{0};
+  // Поток-владелец завершился; кольцо удаляется после опустошения
+  std::atomic<bool> orphaned{false};
+
+  bool push(std::string& line) {
+    const auto tailValue = tail.load(std::memory_order_relaxed);
+    if (tailValue - head.load(std::memory_order_acquire) == kRingCapacity) {
+      return false;
+    }
+    slots[tailValue % kRingCapacity] = std::move(line);
+    tail.store(tailValue + 1, std::memory_order_release);
+    return true;
+  }
+
+  [[nodiscard]] std::size_t size() const {
+    return tail.load(std::memory_order_acquire) - head.load(std::memory_order_relaxed);
+  }
+
+  void drainTo(std::string& out) {
+    auto headValue = head.load(std::memory_order_relaxed);
+    const auto tailValue = tail.load(std::memory_order_acquire);
+    for (; headValue != tailValue; ++headValue) {
+      auto& slot = slots[headValue % kRingCapacity];
+      out += slot;
+      out += '\n';
+      slot = std::string{};
+    }
+    head.store(headValue, std::memory_order_release);
+  }
+
+  void discard() {
+    auto headValue = head.load(std::memory_order_relaxed);
+    const auto tailValue = tail.load(std::memory_order_acquire);
+    for (; headValue != tailValue; ++headValue) {
+      slots[headValue % kRingCapacity] = std::string{};
+    }
+    head.store(headValue, std::memory_order_release);
+  }
+};
+
+Logger& Logger::instance() {
+  static Logger logger;
+  return logger;
+}
+
+Logger::Logger() : level_(static_cast<int>(LogLevel::Info)) {
+  std::optional<std::string> invalidLevel;
+  if (auto name = readEnv("LOG_LEVEL")) {
+    if (auto parsed = parseLogLevel(*name)) {
+      setLevel(*parsed);
+    } else {
+      invalidLevel = std::move(name);
+    }
+  }
+
+  writer_ = std::thread([this] { run(); });
+  pthread_atfork(&Logger::prepareFork, &Logger::afterForkInParent, &Logger::afterForkInChild);
+
+  if (invalidLevel) {
+    LogRecord(*this, LogLevel::Warn, "Ignoring invalid LOG_LEVEL").field("value", *invalidLevel);
+  }
+}
+
+Logger::~Logger() {
+  {
+    std::lock_guard<std::mutex> lock(wakeupMutex_);
+    stopping_ = true;
+  }
+  wakeup_.notify_all();
+  if (writer_.joinable()) {
+    writer_.join();
+  }
+}
+
+Logger::Ring& Logger::localRing() {
+  struct Holder {
+    std::shared_ptr<Ring> ring;
+    ~Holder() {
+      if (ring) {
+        ring->orphaned.store(true, std::memory_order_release);
+      }
+    }
+  };
+  thread_local Holder holder;
+
+  if (!holder.ring) {
+    holder.ring = std::make_shared<Ring>();
+    std::lock_guard<std::mutex> lock(ringsMutex_);
+    rings_.push_back(holder.ring);
+  }
+  return *holder.ring;
+}
+
+void Logger::submit(std::string line) {
+  auto& ring = localRing();
+  if (!ring.push(line)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  // Будим писателя заранее, пока кольцо не переполнилось
+  if (ring.size() == kRingCapacity / 2) {
+    wakeup_.notify_one();
+  }
+}
+
+void Logger::flush() { drain(); }
+
+void Logger::drain() {
+  std::lock_guard<std::mutex> drainLock(drainMutex_);
+
+  std::vector<std::shared_ptr<Ring>> rings;
+  {
+    std::lock_guard<std::mutex> lock(ringsMutex_);
+    rings = rings_;
+  }
+
+  std::string batch;
+  for (const auto& ring : rings) {
+    ring->drainTo(batch);
+  }
+
+  const auto dropped = dropped_.load(std::memory_order_relaxed);
+  if (dropped != reportedDropped_) {
+    LogRecord(*this, LogLevel::Warn, "Log records dropped, ring buffer full").field("count", dropped - reportedDropped_);
+    reportedDropped_ = dropped;
+  }
+
+  if (!batch.empty()) {
+    writeAll(batch);
+  }
+
+  // Кольца завершившихся потоков убираем, когда в них ничего не осталось
+  std::lock_guard<std::mutex> lock(ringsMutex_);
+  std::erase_if(rings_, [](const std::shared_ptr<Ring>& ring) {
+    return ring->orphaned.load(std::memory_order_acquire) && ring->size() == 0;
+  });
+}
+
+void Logger::prepareFork() {
+  auto& logger = instance();
+  // Иначе накопленные строки достались бы и дочернему процессу и были бы записаны дважды
+  logger.drain();
+  logger.drainMutex_.lock();
+  logger.ringsMutex_.lock();
+  logger.wakeupMutex_.lock();
+}
+
+void Logger::afterForkInParent() {
+  auto& logger = instance();
+  logger.wakeupMutex_.unlock();
+  logger.ringsMutex_.unlock();
+  logger.drainMutex_.unlock();
+}
+
+void Logger::afterForkInChild() {
+  auto& logger = instance();
+  logger.wakeupMutex_.unlock();
+  logger.ringsMutex_.unlock();
+  logger.drainMutex_.unlock();
+
+  // В дочернем процессе есть только поток, вызвавший fork. Строки, попавшие в кольца после prepareFork,
+  // допишет родитель; кольца остальных потоков больше некому пополнять
+  Ring& own = logger.localRing();
+  for (const auto& ring : logger.rings_) {
+    ring->discard();
+    if (ring.get() != &own) {
+      ring->orphaned.store(true, std::memory_order_release);
+    }
+  }
+  std::erase_if(logger.rings_, [](const std::shared_ptr<Ring>& ring) {
+    return ring->orphaned.load(std::memory_order_acquire);
+  });
+
+  // Поток писателя и его ожидание на wakeup_ остались в родителе: объекты создаются заново поверх старых,
+  // без деструкторов — ~thread для joinable-потока вызвал бы std::terminate
+  std::construct_at(&logger.wakeup_);
+  std::construct_at(&logger.writer_, [&logger] { logger.run(); });
+}
+
+void Logger::run() {
+  std::unique_lock<std::mutex> lock(wakeupMutex_);
+  while (!stopping_) {
+    wakeup_.wait_for(lock, kFlushInterval, [this] { return stopping_; });
+    lock.unlock();
+    drain();
+    lock.lock();
+  }
+  lock.unlock();
+  drain();
+}
+
+LogRecord::LogRecord(Logger& logger, LogLevel level, std::string_view message) : logger_(logger) {
+  line_.reserve(128 + message.size());
+  line_ += "{\"ts\":\"";
+  appendTimestamp(line_);
+  line_ += "\",\"level\":\"";
+  line_ += logLevelName(level);
+  line_ += "\",\"msg\":\"";
+  appendEscaped(line_, message);
+  line_ += '"';
+}
+
+LogRecord::~LogRecord() {
+  line_ += '}';
+  logger_.submit(std::move(line_));
+}
+
+void LogRecord::appendKey(std::string_view key) {
+  line_ += ",\"";
+  appendEscaped(line_, key);
+  line_ += "\":";
+}
+
+LogRecord& LogRecord::field(std::string_view key, std::string_view value) {
+  appendKey(key);
+  line_ += '"';
+  appendEscaped(line_, value);
+  line_ += '"';
+  return *this;
+}
+
+LogRecord& LogRecord::field(std::string_view key, bool value) {
+  appendKey(key);
+  line_ += value ? "true" : "false";
+  return *this;
+}
+
+LogRecord& LogRecord::field(std::string_view key, double value) {
+  appendKey(key);
+  if (!std::isfinite(value)) {
+    line_ += "null";
+    return *this;
+  }
+  char buffer[32];
+  const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  line_.append(buffer, result.ptr);
+  return *this;
+}
+
+}  // namespace auction::core
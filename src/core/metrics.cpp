@@ -0,0 +1,258 @@
+#include "auction/core/metrics.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+namespace auction::core::metrics {
+
+namespace {
+
+std::string formatValue(double value) {
+  if (std::isinf(value)) {
+    return value > 0 ? "+Inf" : "-Inf";
+  }
+  if (std::isnan(value)) {
+    return "NaN";
+  }
+  char buffer[32];
+  const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  return std::string(buffer, result.ptr);
+}
+
+void appendEscapedLabel(std::string& out, const std::string& value) {
+  for (const char ch : value) {
+    if (ch == '\\' || ch == '"') {
+      out += '\\';
+      out += ch;
+    } else if (ch == '\n') {
+      out += "\\n";
+    } else {
+      out += ch;
+    }
+  }
+}
+
+std::string renderLabels(const Labels& labels) {
+  std::string out;
+  for (const auto& [key, value] : labels) {
+    out += out.empty() ? "" : ",";
+    out += key;
+    out += "=\"";
+    appendEscapedLabel(out, value);
+    out += '"';
+  }
+  return out;
+}
+
+// Registry::setConstantLabels, уже в текстовом виде
+std::string& constantLabels() {
+  static std::string labels;
+  return labels;
+}
+
+void appendSample(std::string& out, const std::string& name, const std::string& labels, const std::string& value) {
+  out += name;
+  const auto& constant = constantLabels();
+  if (!labels.empty() || !constant.empty()) {
+    out += '{';
+    out += constant;
+    out += !constant.empty() && !labels.empty() ? "," : "";
+    out += labels;
+    out += '}';
+  }
+  out += ' ';
+  out += value;
+  out += '\n';
+}
+
+std::string withLabel(const std::string& labels, const std::string& key, const std::string& value) {
+  std::string out = labels;
+  out += out.empty() ? "" : ",";
+  out += key;
+  out += "=\"";
+  out += value;
+  out += '"';
+  return out;
+}
+
+}  // namespace
+
+std::size_t stripeIndex() noexcept {
+  static std::atomic<std::size_t> nextThread{0};
+  thread_local const std::size_t index = nextThread.fetch_add(1, std::memory_order_relaxed) % kStripes;
+  return index;
+}
+
+std::uint64_t Counter::value() const noexcept {
+  std::uint64_t total = 0;
+  for (const auto& cell : cells_) {
+    total += cell.value.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+std::int64_t Gauge::value() const noexcept {
+  // Полосы хранят дополнительный код, сумма по модулю 2^64 даёт верное знаковое значение
+  std::uint64_t total = 0;
+  for (const auto& cell : cells_) {
+    total += cell.value.load(std::memory_order_relaxed);
+  }
+  return static_cast<std::int64_t>(total);
+}
+
+Histogram::Histogram(std::vector<double> bounds) : bounds_(std::move(bounds)) {
+  if (!std::is_sorted(bounds_.begin(), bounds_.end())) {
+    throw std::invalid_argument("Histogram bounds must be sorted");
+  }
+  // bounds + +Inf + сумма
+  stride_ = bounds_.size() + 2;
+  cells_ = std::make_unique<StripedCell[]>(stride_ * kStripes);
+}
+
+void Histogram::observe(double seconds) noexcept {
+  const auto bucket =
+      static_cast<std::size_t>(std::lower_bound(bounds_.begin(), bounds_.end(), seconds) - bounds_.begin());
+  StripedCell* stripe = cells_.get() + stripeIndex() * stride_;
+  stripe[bucket].value.fetch_add(1, std::memory_order_relaxed);
+  const auto nanos = seconds > 0 ? static_cast<std::uint64_t>(seconds * 1e9) : 0;
+  stripe[bounds_.size() + 1].value.fetch_add(nanos, std::memory_order_relaxed);
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+  Snapshot snapshot;
+  snapshot.cumulative.assign(bounds_.size() + 1, 0);
+  std::uint64_t sumNanos = 0;
+  for (std::size_t stripe = 0; stripe < kStripes; ++stripe) {
+    const StripedCell* cells = cells_.get() + stripe * stride_;
+    for (std::size_t bucket = 0; bucket <= bounds_.size(); ++bucket) {
+      snapshot.cumulative[bucket] += cells[bucket].value.load(std::memory_order_relaxed);
+    }
+    sumNanos += cells[bounds_.size() + 1].value.load(std::memory_order_relaxed);
+  }
+  for (std::size_t bucket = 1; bucket < snapshot.cumulative.size(); ++bucket) {
+    snapshot.cumulative[bucket] += snapshot.cumulative[bucket - 1];
+  }
+  snapshot.count = snapshot.cumulative.back();
+  snapshot.sum = static_cast<double>(sumNanos) / 1e9;
+  return snapshot;
+}
+
+std::vector<double> defaultLatencyBuckets() {
+  return {0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0};
+}
+
+Registry& Registry::instance() {
+  static Registry registry;
+  return registry;
+}
+
+Registry::Series& Registry::series(const std::string& name, const std::string& help, Type type,
+                                   const Labels& labels) {
+  auto& family = families_[name];
+  if (family.series.empty()) {
+    family.help = help;
+    family.type = type;
+  } else if (family.type != type) {
+    throw std::logic_error("Metric " + name + " registered with different types");
+  }
+
+  const auto rendered = renderLabels(labels);
+  for (auto& existing : family.series) {
+    if (existing.labels == rendered) {
+      return existing;
+    }
+  }
+  family.series.push_back(Series{rendered, nullptr, nullptr, nullptr});
+  return family.series.back();
+}
+
+Counter& Registry::counter(const std::string& name, const std::string& help, const Labels& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& entry = series(name, help, Type::Counter, labels);
+  if (!entry.counter) {
+    entry.counter = std::make_unique<Counter>();
+  }
+  return *entry.counter;
+}
+
+Gauge& Registry::gauge(const std::string& name, const std::string& help, const Labels& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& entry = series(name, help, Type::Gauge, labels);
+  if (!entry.gauge) {
+    entry.gauge = std::make_unique<Gauge>();
+  }
+  return *entry.gauge;
+}
+
+Histogram& Registry::histogram(const std::string& name, const std::string& help, const Labels& labels,
+                               std::vector<double> bounds) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& entry = series(name, help, Type::Histogram, labels);
+  if (!entry.histogram) {
+    entry.histogram = std::make_unique<Histogram>(std::move(bounds));
+  }
+  return *entry.histogram;
+}
+
+void Registry::addCollector(Collector collector) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  collectors_.push_back(std::move(collector));
+}
+
+void Registry::setConstantLabels(const Labels& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  constantLabels() = renderLabels(labels);
+}
+
+std::string Registry::render() const {
+  std::string out;
+  out.reserve(16 * 1024);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& [name, family] : families_) {
+    const char* type = family.type == Type::Counter ? "counter" : family.type == Type::Gauge ? "gauge" : "histogram";
+    writeHeader(out, name, family.help, type);
+    for (const auto& series : family.series) {
+      if (series.counter) {
+        appendSample(out, name, series.labels, std::to_string(series.counter->value()));
+      } else if (series.gauge) {
+        appendSample(out, name, series.labels, std::to_string(series.gauge->value()));
+      } else if (series.histogram) {
+        const auto snapshot = series.histogram->snapshot();
+        const auto& bounds = series.histogram->bounds();
+        for (std::size_t bucket = 0; bucket < snapshot.cumulative.size(); ++bucket) {
+          const auto le = bucket < bounds.size() ? formatValue(bounds[bucket]) : std::string{"+Inf"};
+          appendSample(out, name + "_bucket", withLabel(series.labels, "le", le),
+                       std::to_string(snapshot.cumulative[bucket]));
+        }
+        appendSample(out, name + "_sum", series.labels, formatValue(snapshot.sum));
+        appendSample(out, name + "_count", series.labels, std::to_string(snapshot.count));
+      }
+    }
+  }
+
+  for (const auto& collector : collectors_) {
+    collector(out);
+  }
+  return out;
+}
+
+void writeHeader(std::string& out, const std::string& name, const std::string& help, const char* type) {
+  out += "# HELP ";
+  out += name;
+  out += ' ';
+  out += help;
+  out += "\n# TYPE ";
+  out += name;
+  out += ' ';
+  out += type;
+  out += '\n';
+}
+
+void writeSample(std::string& out, const std::string& name, const Labels& labels, double value) {
+  appendSample(out, name, renderLabels(labels), formatValue(value));
+}
+
+}  // namespace auction::core::metrics
@@ -0,0 +1,100 @@
+#include "auction/core/pg_binary.h"
+
+#include <limits>
+#include <stdexcept>
+
+namespace auction::core::pg {
+
+namespace {
+
+constexpr std::uint16_t kNumericNegative = 0x4000;
+constexpr std::uint16_t kNumericNaN = 0xC000;
+
+// 2000-01-01 относительно 1970-01-01
+constexpr std::chrono::microseconds kPostgresEpoch{946684800LL * 1000000LL};
+
+std::uint64_t readBigEndian(const char* data, int bytes) {
+  std::uint64_t value = 0;
+  for (int i = 0; i < bytes; ++i) {
+    value = (value << 8) | static_cast<unsigned char>(data[i]);
+  }
+  return value;
+}
+
+constexpr std::int16_t kDigitDivisors[] = {1000, 100, 10, 1};
+
+}  // namespace
+
+std::int16_t readInt2(const char* data) {
+  return static_cast<std::int16_t>(readBigEndian(data, 2));
+}
+
+std::int32_t readInt4(const char* data) {
+  return static_cast<std::int32_t>(readBigEndian(data, 4));
+}
+
+std::int64_t readInt8(const char* data) {
+  return static_cast<std::int64_t>(readBigEndian(data, 8));
+}
+
+std::int64_t readNumericScaled(const char* data, int length, int scale) {
+  if (length < 8) {
+    throw std::runtime_error("Malformed NUMERIC value");
+  }
+
+  const int ndigits = readInt2(data);
+  const int weight = readInt2(data + 2);
+  const auto sign = static_cast<std::uint16_t>(readInt2(data + 4));
+  if (sign == kNumericNaN) {
+    throw std::runtime_error("NUMERIC NaN cannot be represented as a scaled integer");
+  }
+  if (ndigits < 0 || length < 8 + ndigits * 2) {
+    throw std::runtime_error("Malformed NUMERIC value");
+  }
+
+  // Разворачиваем цифры по основанию 10000 в десятичные, начиная со старшей; next — десятичный порядок очередной цифры.
+  // Цифры младше 10^-scale не нужны, кроме первой из них — она решает округление.
+  constexpr std::int64_t kOverflowGuard = (std::numeric_limits<std::int64_t>::max() - 9) / 10;
+  std::int64_t value = 0;
+  bool roundUp = false;
+  int next = 4 * weight + 3;
+  for (int i = 0; i < ndigits && next >= -scale - 1; ++i) {
+    const std::int16_t group = readInt2(data + 8 + i * 2);
+    for (const std::int16_t divisor : kDigitDivisors) {
+      const int digit = group / divisor % 10;
+      if (next >= -scale) {
+        if (value > kOverflowGuard) {
+          throw std::runtime_error("NUMERIC value is out of range");
+        }
+        value = value * 10 + digit;
+      } else if (next == -scale - 1) {
+        roundUp = digit >= 5;
+      }
+      --next;
+    }
+  }
+  for (; next >= -scale; --next) {
+    if (value > kOverflowGuard) {
+      throw std::runtime_error("NUMERIC value is out of range");
+    }
+    value *= 10;
+  }
+  if (roundUp) {
+    ++value;
+  }
+
+  return sign == kNumericNegative ? -value : value;
+}
+
+Timestamp readTimestamptz(const char* data) {
+  const std::int64_t micros = readInt8(data);
+  if (micros == std::numeric_limits<std::int64_t>::max()) {
+    return Timestamp::max();
+  }
+  if (micros == std::numeric_limits<std::int64_t>::min()) {
+    return Timestamp::min();
+  }
+  return Timestamp{kPostgresEpoch + std::chrono::microseconds{micros}};
+}
+
+}  // namespace auction::core::pg
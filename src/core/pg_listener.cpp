@@ -0,0 +1,152 @@
+#include "auction/core/pg_listener.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "auction/core/logger.h"
+
+namespace auction::core {
+
+namespace {
+
+constexpr std::chrono::milliseconds kInitialRetryDelay{1000};
+constexpr std::chrono::milliseconds kMaxRetryDelay{30000};
+
+}  // namespace
+
+PgListener::PgListener(std::string connectionString, std::string channel, NotifyHandler onNotify,
+                       StateHandler onState)
+    : connectionString_(std::move(connectionString)),
+      channel_(std::move(channel)),
+      onNotify_(std::move(onNotify)),
+      onState_(std::move(onState)) {
+  wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wakeFd_ < 0) {
+    throw std::system_error(errno, std::generic_category(), "Failed to create listener eventfd");
+  }
+  thread_ = std::thread([this] { run(); });
+}
+
+PgListener::~PgListener() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_.store(true);
+  }
+  stopped_.notify_all();
+  const std::uint64_t one = 1;
+  [[maybe_unused]] const auto written = ::write(wakeFd_, &one, sizeof(one));
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  ::close(wakeFd_);
+}
+
+void PgListener::run() {
+  auto delay = kInitialRetryDelay;
+  while (!stopping_.load()) {
+    PGconn* connection = connect();
+    if (connection) {
+      AUCTION_LOG_INFO("Listening for database notifications").field("channel", channel_);
+      delay = kInitialRetryDelay;
+      onState_(true);
+      const bool lost = listen(connection);
+      PQfinish(connection);
+      onState_(false);
+      if (!lost) {
+        return;
+      }
+      AUCTION_LOG_WARN("Database notification connection lost").field("channel", channel_);
+    }
+
+    if (!sleep(delay)) {
+      return;
+    }
+    delay = std::min(delay * 2, kMaxRetryDelay);
+  }
+}
+
+PGconn* PgListener::connect() {
+  PGconn* connection = PQconnectdb(connectionString_.c_str());
+  if (!connection || PQstatus(connection) != CONNECTION_OK) {
+    AUCTION_LOG_WARN("Failed to open database notification connection")
+        .field("channel", channel_)
+        .field("error", connection ? PQerrorMessage(connection) : "null connection");
+    PQfinish(connection);
+    return nullptr;
+  }
+
+  char* channel = PQescapeIdentifier(connection, channel_.c_str(), channel_.size());
+  if (!channel) {
+    AUCTION_LOG_WARN("Failed to escape notification channel").field("error", PQerrorMessage(connection));
+    PQfinish(connection);
+    return nullptr;
+  }
+  const std::string sql = std::string{"LISTEN "} + channel;
+  PQfreemem(channel);
+
+  // Через pooler в режиме транзакций LISTEN не работает: ошибка здесь — повод проверить SUPABASE_PORT
+  PGresult* result = PQexec(connection, sql.c_str());
+  const bool ok = result && PQresultStatus(result) == PGRES_COMMAND_OK;
+  if (!ok) {
+    AUCTION_LOG_WARN("LISTEN failed")
+        .field("channel", channel_)
+        .field("error", result ? PQresultErrorMessage(result) : PQerrorMessage(connection));
+  }
+  PQclear(result);
+  if (!ok || PQsetnonblocking(connection, 1) != 0) {
+    PQfinish(connection);
+    return nullptr;
+  }
+  return connection;
+}
+
+bool PgListener::listen(PGconn* connection) {
+  std::array<pollfd, 2> descriptors{};
+  descriptors[0].fd = PQsocket(connection);
+  descriptors[0].events = POLLIN;
+  descriptors[1].fd = wakeFd_;
+  descriptors[1].events = POLLIN;
+
+  while (!stopping_.load()) {
+    if (::poll(descriptors.data(), descriptors.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      AUCTION_LOG_ERROR("Listener poll failed").field("error", std::strerror(errno));
+      return true;
+    }
+    if (descriptors[1].revents != 0) {
+      return false;
+    }
+
+    if (PQconsumeInput(connection) == 0) {
+      return true;
+    }
+    while (PGnotify* notify = PQnotifies(connection)) {
+      try {
+        onNotify_(notify->extra);
+      } catch (const std::exception& ex) {
+        AUCTION_LOG_ERROR("Notification handler failed").field("channel", channel_).field("error", ex.what());
+      }
+      PQfreemem(notify);
+    }
+  }
+  return false;
+}
+
+bool PgListener::sleep(std::chrono::milliseconds delay) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return !stopped_.wait_for(lock, delay, [this] { return stopping_.load(); });
+}
+
+}  // namespace auction::core
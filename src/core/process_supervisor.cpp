@@ -0,0 +1,502 @@
+#include "auction/core/process_supervisor.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/prctl.h>
+#include <sys/signalfd.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "auction/core/env.h"
+#include "auction/core/logger.h"
+
+namespace auction::core {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto kMaxRestartDelay = std::chrono::milliseconds{60000};
+// Проработавший столько процесс считается стабильным: счётчик падений подряд сбрасывается
+constexpr auto kStableUptime = std::chrono::seconds{30};
+
+sigset_t supervisedSignals() {
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGTERM);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGHUP);
+  sigaddset(&signals, SIGCHLD);
+  return signals;
+}
+
+std::string describeStatus(int status) {
+  if (WIFEXITED(status)) {
+    return "exit code " + std::to_string(WEXITSTATUS(status));
+  }
+  if (WIFSIGNALED(status)) {
+    return "signal " + std::to_string(WTERMSIG(status));
+  }
+  return "status " + std::to_string(status);
+}
+
+bool succeeded(int status) { return WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS; }
+
+void closeDescriptor(int& fd) {
+  if (fd >= 0) {
+    ::close(fd);
+    fd = -1;
+  }
+}
+
+// Тело дочернего процесса. Возврата нет: объекты родителя, скопированные в стек, не разрушаются,
+// std::exit вызывает только статические деструкторы (логгер дописывает накопленное)
+[[noreturn]] void runChild(const std::function<int()>& body) {
+  int code = EXIT_FAILURE;
+  try {
+    code = body();
+  } catch (const std::exception& ex) {
+    AUCTION_LOG_ERROR("Fatal error").field("error", ex.what());
+  } catch (...) {
+    AUCTION_LOG_ERROR("Fatal error");
+  }
+  std::exit(code);
+}
+
+long long millisSince(Clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+}
+
+}  // namespace
+
+SupervisorOptions SupervisorOptions::fromEnvironment() {
+  SupervisorOptions options;
+  options.processes = envSize("SERVER_PROCESSES", options.processes);
+  options.restartDelay = std::chrono::milliseconds{
+      envSize("SERVER_RESTART_DELAY_MS", static_cast<std::size_t>(options.restartDelay.count()))};
+  options.readyTimeout = std::chrono::milliseconds{
+      envSize("SERVER_READY_TIMEOUT_MS", static_cast<std::size_t>(options.readyTimeout.count()))};
+  options.shutdownTimeout = std::chrono::milliseconds{
+      envSize("SERVER_SHUTDOWN_TIMEOUT_MS", static_cast<std::size_t>(options.shutdownTimeout.count()))};
+  return options;
+}
+
+void WorkerContext::notifyReady() {
+  if (readyFd_ < 0) {
+    return;
+  }
+  const char byte = 1;
+  // Канал пуст и на один байт места хватит всегда; ошибка означает, что супервизора уже нет
+  [[maybe_unused]] const ssize_t written = ::write(readyFd_, &byte, 1);
+  closeDescriptor(readyFd_);
+}
+
+ProcessSupervisor::ProcessSupervisor(SupervisorOptions options) : options_(options) {
+  if (options_.processes == 0) {
+    throw std::invalid_argument("ProcessSupervisor requires at least one process");
+  }
+}
+
+void ProcessSupervisor::blockSignals() {
+  const sigset_t signals = supervisedSignals();
+  if (const int error = pthread_sigmask(SIG_BLOCK, &signals, nullptr); error != 0) {
+    throw std::system_error(error, std::generic_category(), "pthread_sigmask");
+  }
+}
+
+void ProcessSupervisor::addTask(std::string name, Task task) { tasks_.emplace_back(std::move(name), std::move(task)); }
+
+int ProcessSupervisor::run(const WorkerEntry& entry) {
+  const sigset_t signals = supervisedSignals();
+  signalFd_ = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+  if (signalFd_ < 0) {
+    throw std::system_error(errno, std::generic_category(), "signalfd");
+  }
+
+  AUCTION_LOG_INFO("Process supervisor is starting").field("processes", options_.processes).field("pid", getpid());
+
+  slots_.assign(options_.processes, Slot{});
+  for (std::size_t slot = 0; slot < slots_.size(); ++slot) {
+    if (spawn(slot, entry) < 0) {
+      slots_[slot].restartAt = Clock::now() + options_.restartDelay;
+    }
+  }
+  for (std::size_t index = 0; index < tasks_.size(); ++index) {
+    spawnTask(index);
+  }
+
+  while (!stopping_ || !processes_.empty()) {
+    std::vector<pollfd> descriptors;
+    descriptors.reserve(processes_.size() + 1);
+    descriptors.push_back(pollfd{signalFd_, POLLIN, 0});
+    for (const auto& process : processes_) {
+      if (process.readyFd >= 0) {
+        descriptors.push_back(pollfd{process.readyFd, POLLIN, 0});
+      }
+    }
+
+    const int count = ::poll(descriptors.data(), descriptors.size(), static_cast<int>(nextTimeout().count()));
+    if (count < 0 && errno != EINTR) {
+      throw std::system_error(errno, std::generic_category(), "poll");
+    }
+
+    if (count > 0) {
+      // Сигналы готовности разбираются до SIGCHLD: процесс мог успеть открыть порт и сразу упасть
+      for (std::size_t i = 1; i < descriptors.size(); ++i) {
+        if (descriptors[i].revents == 0) {
+          continue;
+        }
+        const auto process = std::find_if(processes_.begin(), processes_.end(), [&](const Process& candidate) {
+          return candidate.readyFd == descriptors[i].fd;
+        });
+        if (process != processes_.end()) {
+          readReady(*process, entry);
+        }
+      }
+
+      signalfd_siginfo info{};
+      while (::read(signalFd_, &info, sizeof(info)) == static_cast<ssize_t>(sizeof(info))) {
+        switch (info.ssi_signo) {
+          case SIGHUP:
+            if (!stopping_) {
+              startRollout(entry);
+            }
+            break;
+          case SIGTERM:
+          case SIGINT:
+            if (!stopping_) {
+              stop(static_cast<int>(info.ssi_signo));
+            }
+            break;
+          default:
+            break;
+        }
+      }
+    }
+
+    // SIGCHLD склеиваются, поэтому процессы собираются при каждом пробуждении
+    reap(entry);
+    onTimers(entry);
+  }
+
+  closeDescriptor(signalFd_);
+  AUCTION_LOG_INFO("Process supervisor stopped");
+  return EXIT_SUCCESS;
+}
+
+void ProcessSupervisor::prepareChild(pid_t parent) {
+  // Рабочий процесс не должен пережить супервизор: SIGTERM придёт и при его аварийном завершении
+  prctl(PR_SET_PDEATHSIG, SIGTERM);
+  if (getppid() != parent) {
+    std::_Exit(EXIT_FAILURE);
+  }
+  closeDescriptor(signalFd_);
+  for (auto& process : processes_) {
+    closeDescriptor(process.readyFd);
+  }
+}
+
+pid_t ProcessSupervisor::spawn(std::size_t slot, const WorkerEntry& entry) {
+  int ready[2];
+  if (pipe2(ready, O_CLOEXEC | O_NONBLOCK) != 0) {
+    AUCTION_LOG_ERROR("Failed to start worker process").field("slot", slot).field("error", std::strerror(errno));
+    return -1;
+  }
+
+  const pid_t parent = getpid();
+  const pid_t pid = fork();
+  if (pid < 0) {
+    const int error = errno;
+    ::close(ready[0]);
+    ::close(ready[1]);
+    AUCTION_LOG_ERROR("Failed to start worker process").field("slot", slot).field("error", std::strerror(error));
+    return -1;
+  }
+
+  if (pid == 0) {
+    ::close(ready[0]);
+    prepareChild(parent);
+    WorkerContext context(slot, ready[1]);
+    runChild([&entry, &context] { return entry(context); });
+  }
+
+  ::close(ready[1]);
+  Process process;
+  process.pid = pid;
+  process.slot = slot;
+  process.readyFd = ready[0];
+  process.startedAt = Clock::now();
+  processes_.push_back(process);
+  AUCTION_LOG_INFO("Worker process started").field("slot", slot).field("pid", pid);
+  return pid;
+}
+
+void ProcessSupervisor::spawnTask(std::size_t index) {
+  const pid_t parent = getpid();
+  const pid_t pid = fork();
+  if (pid < 0) {
+    AUCTION_LOG_ERROR("Failed to start task process")
+        .field("task", tasks_[index].first)
+        .field("error", std::strerror(errno));
+    return;
+  }
+
+  if (pid == 0) {
+    prepareChild(parent);
+    // Задаче корректная остановка не нужна: SIGTERM завершает её сразу
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGINT);
+    pthread_sigmask(SIG_UNBLOCK, &signals, nullptr);
+    runChild(tasks_[index].second);
+  }
+
+  Process process;
+  process.pid = pid;
+  process.task = index;
+  process.startedAt = Clock::now();
+  processes_.push_back(process);
+}
+
+bool ProcessSupervisor::hasActive(std::size_t slot) const {
+  return std::any_of(processes_.begin(), processes_.end(), [slot](const Process& process) {
+    return !process.task && process.slot == slot && !process.retiring;
+  });
+}
+
+void ProcessSupervisor::terminate(Process& process) {
+  if (process.retiring) {
+    return;
+  }
+  ::kill(process.pid, SIGTERM);
+  process.retiring = true;
+  process.killAt = Clock::now() + options_.shutdownTimeout;
+}
+
+void ProcessSupervisor::stop(int signal) {
+  AUCTION_LOG_INFO("Process supervisor is stopping").field("signal", signal).field("processes", processes_.size());
+  stopping_ = true;
+  rollout_.reset();
+  rolloutQueue_.clear();
+  for (auto& slot : slots_) {
+    slot.restartAt.reset();
+  }
+  for (auto& process : processes_) {
+    terminate(process);
+  }
+}
+
+void ProcessSupervisor::readReady(Process& process, const WorkerEntry& entry) {
+  char byte = 0;
+  const ssize_t received = ::read(process.readyFd, &byte, 1);
+  if (received < 0 && (errno == EAGAIN || errno == EINTR)) {
+    return;
+  }
+  closeDescriptor(process.readyFd);
+  // Конец канала без байта — процесс завершился, не открыв порт; его соберёт reap
+  if (received != 1) {
+    return;
+  }
+
+  process.ready = true;
+  AUCTION_LOG_INFO("Worker process is ready")
+      .field("slot", process.slot)
+      .field("pid", process.pid)
+      .field("startup_ms", millisSince(process.startedAt));
+
+  if (!rollout_ || rollout_->replacement != process.pid) {
+    return;
+  }
+  // Новый процесс уже принимает соединения, старый можно останавливать
+  const auto previous = std::find_if(processes_.begin(), processes_.end(), [&](const Process& candidate) {
+    return !candidate.task && candidate.slot == rollout_->slot && candidate.pid != rollout_->replacement &&
+           !candidate.retiring;
+  });
+  if (previous == processes_.end()) {
+    rollout_.reset();
+    advanceRollout(entry);
+    return;
+  }
+  rollout_->retired = previous->pid;
+  terminate(*previous);
+}
+
+void ProcessSupervisor::reap(const WorkerEntry& entry) {
+  for (;;) {
+    int status = 0;
+    const pid_t pid = waitpid(-1, &status, WNOHANG);
+    if (pid <= 0) {
+      return;
+    }
+    const auto found =
+        std::find_if(processes_.begin(), processes_.end(), [pid](const Process& process) { return process.pid == pid; });
+    if (found == processes_.end()) {
+      continue;
+    }
+    Process process = *found;
+    closeDescriptor(found->readyFd);
+    processes_.erase(found);
+
+    if (process.task) {
+      const auto& name = tasks_[*process.task].first;
+      if (succeeded(status)) {
+        AUCTION_LOG_INFO("Task process finished").field("task", name);
+      } else {
+        AUCTION_LOG_WARN("Task process failed").field("task", name).field("status", describeStatus(status));
+      }
+      continue;
+    }
+
+    if (process.retiring) {
+      AUCTION_LOG_INFO("Worker process stopped")
+          .field("slot", process.slot)
+          .field("pid", pid)
+          .field("status", describeStatus(status));
+    } else {
+      AUCTION_LOG_ERROR("Worker process exited unexpectedly")
+          .field("slot", process.slot)
+          .field("pid", pid)
+          .field("status", describeStatus(status))
+          .field("uptime_ms", millisSince(process.startedAt));
+    }
+
+    if (rollout_ && pid == rollout_->replacement && !process.ready) {
+      abortRollout("replacement exited before it was ready");
+    } else if (rollout_ && pid == rollout_->retired) {
+      rollout_.reset();
+      advanceRollout(entry);
+    }
+
+    if (stopping_ || hasActive(process.slot)) {
+      continue;
+    }
+    // Место осталось без процесса: перезапуск с паузой, растущей при падениях подряд
+    auto& slot = slots_[process.slot];
+    if (Clock::now() - process.startedAt >= kStableUptime) {
+      slot.failures = 0;
+    }
+    auto delay = options_.restartDelay;
+    for (std::size_t i = 0; i < slot.failures && delay < kMaxRestartDelay; ++i) {
+      delay *= 2;
+    }
+    delay = std::min(delay, kMaxRestartDelay);
+    ++slot.failures;
+    slot.restartAt = Clock::now() + delay;
+    AUCTION_LOG_INFO("Worker process will be restarted").field("slot", process.slot).field("delay_ms", delay.count());
+  }
+}
+
+void ProcessSupervisor::startRollout(const WorkerEntry& entry) {
+  if (rollout_ || !rolloutQueue_.empty()) {
+    AUCTION_LOG_WARN("Rolling restart is already in progress");
+    return;
+  }
+  AUCTION_LOG_INFO("Rolling restart started").field("processes", slots_.size());
+  // Места заменяются по порядку, с нулевого
+  for (std::size_t slot = slots_.size(); slot > 0; --slot) {
+    rolloutQueue_.push_back(slot - 1);
+  }
+  advanceRollout(entry);
+}
+
+void ProcessSupervisor::advanceRollout(const WorkerEntry& entry) {
+  if (rolloutQueue_.empty()) {
+    AUCTION_LOG_INFO("Rolling restart finished");
+    return;
+  }
+  const std::size_t slot = rolloutQueue_.back();
+  rolloutQueue_.pop_back();
+  const pid_t replacement = spawn(slot, entry);
+  if (replacement < 0) {
+    abortRollout("failed to start replacement");
+    return;
+  }
+  rollout_ = Rollout{.slot = slot, .replacement = replacement, .readyDeadline = Clock::now() + options_.readyTimeout};
+}
+
+void ProcessSupervisor::abortRollout(const char* reason) {
+  // Старые процессы продолжают работать: лучше прежняя версия, чем место без процесса
+  AUCTION_LOG_ERROR("Rolling restart aborted")
+      .field("reason", reason)
+      .field("slot", rollout_ ? rollout_->slot : 0)
+      .field("remaining", rolloutQueue_.size());
+  if (rollout_) {
+    for (auto& process : processes_) {
+      if (process.pid == rollout_->replacement && !process.ready) {
+        terminate(process);
+      }
+    }
+  }
+  rollout_.reset();
+  rolloutQueue_.clear();
+}
+
+void ProcessSupervisor::onTimers(const WorkerEntry& entry) {
+  const auto now = Clock::now();
+  for (auto& process : processes_) {
+    if (process.retiring && now >= process.killAt) {
+      AUCTION_LOG_WARN("Process did not stop in time, killing").field("slot", process.slot).field("pid", process.pid);
+      ::kill(process.pid, SIGKILL);
+      process.killAt = Clock::time_point::max();
+    }
+  }
+
+  if (rollout_ && rollout_->retired < 0 && now >= rollout_->readyDeadline) {
+    abortRollout("replacement was not ready in time");
+  }
+
+  if (stopping_) {
+    return;
+  }
+  for (std::size_t index = 0; index < slots_.size(); ++index) {
+    auto& slot = slots_[index];
+    if (!slot.restartAt || now < *slot.restartAt) {
+      continue;
+    }
+    slot.restartAt.reset();
+    // За время паузы место мог занять процесс rolling restart
+    if (!hasActive(index) && spawn(index, entry) < 0) {
+      slot.restartAt = now + options_.restartDelay;
+    }
+  }
+}
+
+std::chrono::milliseconds ProcessSupervisor::nextTimeout() const {
+  std::optional<Clock::time_point> next;
+  const auto consider = [&next](Clock::time_point at) {
+    if (!next || at < *next) {
+      next = at;
+    }
+  };
+  for (const auto& process : processes_) {
+    if (process.retiring && process.killAt != Clock::time_point::max()) {
+      consider(process.killAt);
+    }
+  }
+  if (rollout_ && rollout_->retired < 0) {
+    consider(rollout_->readyDeadline);
+  }
+  for (const auto& slot : slots_) {
+    if (slot.restartAt) {
+      consider(*slot.restartAt);
+    }
+  }
+  if (!next) {
+    return std::chrono::milliseconds{-1};
+  }
+  const auto left = std::chrono::ceil<std::chrono::milliseconds>(*next - Clock::now());
+  return std::max(left, std::chrono::milliseconds{0});
+}
+
+}  // namespace auction::core
@@ -1,6 +1,8 @@
 #include "auction/core/service_registry.h"
 
 #include <cstdlib>
+#include <future>
+#include <memory>
 #include <stdexcept>
 #include <string_view>
 
@@ -45,9 +47,35 @@ std::string ServiceRegistry::resolveServiceName() {
   return "AuctionService";
 }
 
-ServiceRegistry::ServiceRegistry() : registryUrl_(resolveRegistryUrl()), serviceName_(resolveServiceName()) {}
+ServiceRegistry::ServiceRegistry(AsyncHttpClient& httpClient)
+    : registryUrl_(resolveRegistryUrl()), serviceName_(resolveServiceName()), httpClient_(httpClient) {}
+
+void ServiceRegistry::registerMethods(const std::vector<ApiMethod>& methods) {
+  auto promise = std::make_shared<std::promise<void>>();
+  auto done = promise->get_future();
+  registerMethodsAsync(methods, [promise](std::exception_ptr error) {
+    if (error) {
+      promise->set_exception(error);
+    } else {
+      promise->set_value();
+    }
+  });
+  done.get();
+}
+
+void ServiceRegistry::registerMethodsAsync(const std::vector<ApiMethod>& methods,
+                                           std::function<void(std::exception_ptr)> onDone) {
+  httpClient_.postJson(registryUrl_, buildPayload(methods),
+                       [onDone = std::move(onDone)](std::exception_ptr error, HttpResponse response) {
+                         if (!error && (response.status < 200 || response.status >= 300)) {
+                           error = std::make_exception_ptr(std::runtime_error(
+                               "Service registry call failed with status " + std::to_string(response.status)));
+                         }
+                         onDone(error);
+                       });
+}
 
-void ServiceRegistry::registerMethods(const std::vector<ApiMethod>& methods) const {
+nlohmann::json ServiceRegistry::buildPayload(const std::vector<ApiMethod>& methods) const {
   nlohmann::json payload;
   payload["serviceName"] = serviceName_;
 
@@ -70,11 +98,7 @@ void ServiceRegistry::registerMethods(const std::vector<ApiMethod>& methods) con
     methodsJson.push_back(std::move(methodJson));
   }
   payload["methods"] = std::move(methodsJson);
-
-  const auto response = httpClient_.postJson(registryUrl_, payload);
-  if (response.status < 200 || response.status >= 300) {
-    throw std::runtime_error("Service registry call failed with status " + std::to_string(response.status));
-  }
+  return payload;
 }
 
 }  // namespace auction::core
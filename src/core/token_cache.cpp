@@ -1,42 +1,101 @@
 #include "auction/core/token_cache.h"
 
+#include <algorithm>
+#include <functional>
+
+#include "auction/core/env.h"
+
 namespace auction::core {
 
-TokenCache::TokenCache(std::chrono::seconds ttl) : ttl_(ttl) {}
+TokenCacheOptions TokenCacheOptions::fromEnvironment() {
+  TokenCacheOptions options;
+  options.shards = std::max<std::size_t>(envSize("TOKEN_CACHE_SHARDS", options.shards), 1);
+  options.capacity = std::max<std::size_t>(envSize("TOKEN_CACHE_CAPACITY", options.capacity), 1);
+  options.positiveTtl =
+      std::chrono::seconds{envSize("TOKEN_CACHE_TTL_S", static_cast<std::size_t>(options.positiveTtl.count()))};
+  options.negativeTtl = std::chrono::seconds{
+      envSize("TOKEN_CACHE_NEGATIVE_TTL_S", static_cast<std::size_t>(options.negativeTtl.count()))};
+  return options;
+}
+
+TokenCache::TokenCache(TokenCacheOptions options)
+    : options_(options),
+      shardCapacity_(std::max<std::size_t>(options_.capacity / std::max<std::size_t>(options_.shards, 1), 1)) {
+  shards_.reserve(std::max<std::size_t>(options_.shards, 1));
+  for (std::size_t i = 0; i < std::max<std::size_t>(options_.shards, 1); ++i) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+}
+
+TokenCache::Shard& TokenCache::shardFor(const std::string& token) {
+  return *shards_[std::hash<std::string>{}(token) % shards_.size()];
+}
 
 std::optional<bool> TokenCache::get(const std::string& token) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  purgeExpiredLocked();
+  auto& shard = shardFor(token);
+  std::lock_guard<std::mutex> lock(shard.mutex);
 
-  auto it = cache_.find(token);
-  if (it == cache_.end()) {
+  auto it = shard.index.find(token);
+  if (it == shard.index.end()) {
+    ++shard.misses;
     return std::nullopt;
   }
 
-  return it->second.valid;
+  if (it->second->expires_at <= std::chrono::steady_clock::now()) {
+    shard.lru.erase(it->second);
+    shard.index.erase(it);
+    ++shard.expirations;
+    ++shard.misses;
+    return std::nullopt;
+  }
+
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+  ++shard.hits;
+  return it->second->valid;
 }
 
 void TokenCache::put(const std::string& token, bool isValid) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  Entry entry{isValid, std::chrono::steady_clock::now() + ttl_};
-  cache_[token] = entry;
+  const auto expiresAt = std::chrono::steady_clock::now() + (isValid ? options_.positiveTtl : options_.negativeTtl);
+
+  auto& shard = shardFor(token);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+
+  if (auto it = shard.index.find(token); it != shard.index.end()) {
+    it->second->valid = isValid;
+    it->second->expires_at = expiresAt;
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    return;
+  }
+
+  shard.lru.push_front(Entry{token, isValid, expiresAt});
+  shard.index.emplace(token, shard.lru.begin());
+
+  while (shard.lru.size() > shardCapacity_) {
+    shard.index.erase(shard.lru.back().key);
+    shard.lru.pop_back();
+    ++shard.evictions;
+  }
 }
 
 void TokenCache::clear() {
-  std::lock_guard<std::mutex> lock(mutex_);
-  cache_.clear();
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    shard->index.clear();
+    shard->lru.clear();
+  }
 }
 
-void TokenCache::purgeExpiredLocked() {
-  const auto now = std::chrono::steady_clock::now();
-  for (auto it = cache_.begin(); it != cache_.end();) {
-    if (it->second.expires_at <= now) {
-      it = cache_.erase(it);
-    } else {
-      ++it;
-    }
+TokenCacheStats TokenCache::stats() const {
+  TokenCacheStats stats;
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    stats.hits += shard->hits;
+    stats.misses += shard->misses;
+    stats.evictions += shard->evictions;
+    stats.expirations += shard->expirations;
+    stats.size += shard->lru.size();
   }
+  return stats;
 }
 
 }  // namespace auction::core
-
@@ -1,17 +1,40 @@
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstddef>
 #include <cstdlib>
-#include <iostream>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <httplib.h>
 #include <curl/curl.h>
+#include <pthread.h>
+#include <sys/socket.h>
 
+#include "auction/api/event_loop_server.h"
+#include "auction/api/router.h"
 #include "auction/api/routes.h"
+#include "auction/core/async_http_client.h"
 #include "auction/core/auth_service.h"
 #include "auction/core/database.h"
+#include "auction/core/executor.h"
+#include "auction/core/logger.h"
+#include "auction/core/metrics.h"
+#include "auction/core/process_supervisor.h"
 #include "auction/core/service_registry.h"
 #include "auction/core/token_cache.h"
+#include "auction/repository/bid_repository.h"
+#include "auction/repository/lot_cache.h"
 #include "auction/repository/lot_repository.h"
+#include "auction/service/bid_recorder.h"
+#include "auction/service/bidding_engine.h"
 #include "auction/service/lot_service.h"
 
 std::string requireEnvOrDefault(const char* key, const std::string& fallback) {
@@ -39,16 +62,154 @@ class CurlGlobalGuard {
 
 void logEnvVar(const char* name) {
   const char* value = std::getenv(name);
-  if (value != nullptr && *value != '\0') {
-    std::cerr << "ENV " << name << " = " << value << std::endl;
+  AUCTION_LOG_INFO("Environment")
+      .field("name", name)
+      .field("value", value != nullptr && *value != '\0' ? value : "(not set)");
+}
+
+// Корректная остановка HTTP-сервера по SIGTERM/SIGINT. Сигналы заблокированы во всех потоках
+// (ProcessSupervisor::blockSignals в начале main), их забирает sigwait в отдельном потоке
+class StopOnSignal {
+ public:
+  explicit StopOnSignal(std::function<void()> stop) : stop_(std::move(stop)) {
+    sigemptyset(&signals_);
+    sigaddset(&signals_, SIGTERM);
+    sigaddset(&signals_, SIGINT);
+    watcher_ = std::thread([this] {
+      int signal = 0;
+      sigwait(&signals_, &signal);
+      if (!released_.load()) {
+        AUCTION_LOG_INFO("Stopping HTTP server").field("signal", signal);
+        stop_();
+      }
+      fired_.store(true);
+    });
+  }
+
+  StopOnSignal(const StopOnSignal&) = delete;
+  StopOnSignal& operator=(const StopOnSignal&) = delete;
+  StopOnSignal(StopOnSignal&&) = delete;
+  StopOnSignal& operator=(StopOnSignal&&) = delete;
+
+  // Сервер остановился сам: будим ожидающий поток адресованным ему сигналом
+  ~StopOnSignal() {
+    released_.store(true);
+    if (!fired_.load()) {
+      pthread_kill(watcher_.native_handle(), SIGTERM);
+    }
+    watcher_.join();
+  }
+
+ private:
+  sigset_t signals_{};
+  std::function<void()> stop_;
+  std::atomic<bool> released_{false};
+  std::atomic<bool> fired_{false};
+  std::thread watcher_;
+};
+
+struct ServerConfig {
+  std::string host;
+  int port{0};
+  std::string backend;
+  // SO_REUSEPORT: порт открывает каждый рабочий процесс
+  bool reusePort{false};
+};
+
+void registerInRegistry(auction::core::ServiceRegistry& registry, const std::vector<auction::core::ApiMethod>& methods) {
+  // Регистрация идёт в фоне и не задерживает старт HTTP-сервера
+  registry.registerMethodsAsync(methods, [](std::exception_ptr error) {
+    if (!error) {
+      AUCTION_LOG_INFO("Service registry updated");
+      return;
+    }
+    try {
+      std::rethrow_exception(error);
+    } catch (const std::exception& ex) {
+      AUCTION_LOG_WARN("Failed to register service in registry").field("error", ex.what());
+    }
+  });
+}
+
+// Весь сервис — пулы, кэши, движок ставок и HTTP-сервер — до остановки по сигналу. В режиме нескольких
+// процессов выполняется в каждом рабочем процессе (worker — его номер); onListening вызывается, когда порт открыт
+int serve(const ServerConfig& config, bool registerService, const std::function<void()>& onListening,
+          std::optional<std::size_t> worker = std::nullopt) {
+  if (worker) {
+    auction::core::metrics::Registry::instance().setConstantLabels({{"worker", std::to_string(*worker)}});
+  }
+
+  auction::core::Database database;
+  // Корутины маршрутов; разбирается раньше пула БД (таймеры ожидания соединений), но после сервисов,
+  // которые возобновляют корутины из своих потоков
+  auction::core::Executor executor(auction::core::ExecutorOptions::fromEnvironment());
+  // Кэш лотов переживает репозиторий и подписку на изменения, которые к нему обращаются
+  std::unique_ptr<auction::repository::LotCache> lotCache;
+  if (const auto lotCacheOptions = auction::repository::LotCacheOptions::fromEnvironment(); lotCacheOptions.enabled) {
+    lotCache = std::make_unique<auction::repository::LotCache>(lotCacheOptions);
+  }
+  auction::repository::LotRepository repository(database, lotCache.get());
+  auction::repository::BidRepository bidRepository(database);
+  auction::service::BidRecorder bidRecorder(bidRepository, auction::service::BidRecorderOptions::fromEnvironment());
+  std::unique_ptr<auction::service::BiddingEngine> biddingEngine;
+  if (requireEnvOrDefault("BIDDING_ENGINE", "0") == "1") {
+    biddingEngine = std::make_unique<auction::service::BiddingEngine>(
+        repository, auction::service::BiddingEngineOptions::fromEnvironment());
+  }
+  auction::service::LotService lotService(repository, bidRepository, bidRecorder, biddingEngine.get());
+  // После LotService: триггер уведомлений создаёт ensureSchema. Останавливается раньше кэша и репозитория
+  const auto lotChanges = repository.listenForChanges();
+  auction::core::TokenCache tokenCache(auction::core::TokenCacheOptions::fromEnvironment());
+  auction::core::AsyncHttpClient httpClient;
+  auction::core::AuthService authService(tokenCache, httpClient);
+
+  auction::api::Router router;
+  auto methods = auction::api::registerRoutes(router, lotService, authService, database, worker);
+
+  auction::core::ServiceRegistry registry(httpClient);
+  if (registerService) {
+    registerInRegistry(registry, methods);
+  }
+
+  bool listened = false;
+  if (config.backend == "epoll") {
+    auto options = auction::api::EventLoopServerOptions::fromEnvironment();
+    options.reusePort = config.reusePort;
+    auction::api::EventLoopServer server(router, executor, options);
+    if (server.bind(config.host, config.port)) {
+      onListening();
+      StopOnSignal stopOnSignal([&server] { server.stop(); });
+      listened = server.listenAfterBind();
+    }
   } else {
-    std::cerr << "ENV " << name << " = (not set)" << std::endl;
+    httplib::Server server;
+    router.mount(server, executor);
+    if (config.reusePort) {
+      server.set_socket_options([](int sock) {
+        const int one = 1;
+        setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+      });
+    }
+    if (server.bind_to_port(config.host, config.port)) {
+      onListening();
+      StopOnSignal stopOnSignal([&server] { server.stop(); });
+      listened = server.listen_after_bind();
+    }
+  }
+  if (!listened) {
+    AUCTION_LOG_ERROR("Failed to start HTTP server").field("host", config.host).field("port", config.port);
+    return EXIT_FAILURE;
   }
+  AUCTION_LOG_INFO("HTTP server stopped");
+  return EXIT_SUCCESS;
 }
 
 int main() {
   try {
-    std::cerr << "=== Environment Variables ===" << std::endl;
+    // До первого потока (логгер, пулы): маска наследуется всеми потоками и рабочими процессами
+    auction::core::ProcessSupervisor::blockSignals();
+
     logEnvVar("PAYMENT_SERVICE_URL");
     logEnvVar("SERVICE_REGISTRY_URL");
     logEnvVar("SERVICE_NAME");
@@ -59,42 +220,59 @@ int main() {
     logEnvVar("SUPABASE_PORT");
     logEnvVar("SUPABASE_DB");
     logEnvVar("SUPABASE_USER");
-    std::cerr << "==============================" << std::endl;
+    logEnvVar("LOG_LEVEL");
+    logEnvVar("HTTP_SERVER");
+    logEnvVar("SERVER_PROCESSES");
 
+    // curl_global_init не потокобезопасен: один раз в родителе, рабочие процессы наследуют состояние
     CurlGlobalGuard curlGuard;
 
-    auction::core::Database database;
-    auction::repository::LotRepository repository(database);
-    auction::service::LotService lotService(repository);
-    auction::core::TokenCache tokenCache;
-    auction::core::AuthService authService(tokenCache);
-
-    httplib::Server server;
-    auto methods = auction::api::registerRoutes(server, lotService, authService);
+    ServerConfig config;
+    config.host = requireEnvOrDefault("SERVER_HOST", "0.0.0.0");
+    config.port = std::stoi(requireEnvOrDefault("SERVER_PORT", requireEnvOrDefault("PORT", "8080")));
 
-    try {
-      auction::core::ServiceRegistry registry;
-      registry.registerMethods(methods);
-      std::cout << "Service registry updated successfully" << std::endl;
-    } catch (const std::exception& ex) {
-      std::cerr << "Warning: failed to register service in registry: " << ex.what() << std::endl;
+    // httplib — поток на соединение; epoll — циклы событий на ядро и общий пул обработчиков
+    config.backend = requireEnvOrDefault("HTTP_SERVER", "httplib");
+    if (config.backend != "httplib" && config.backend != "epoll") {
+      throw std::invalid_argument("HTTP_SERVER must be 'httplib' or 'epoll', got '" + config.backend + "'");
     }
 
-    const std::string host = requireEnvOrDefault("SERVER_HOST", "0.0.0.0");
-    const std::string portString = requireEnvOrDefault("SERVER_PORT", requireEnvOrDefault("PORT", "8080"));
-    const int port = std::stoi(portString);
+    const auto supervisorOptions = auction::core::SupervisorOptions::fromEnvironment();
+    AUCTION_LOG_INFO("Auction service is starting")
+        .field("host", config.host)
+        .field("port", config.port)
+        .field("backend", config.backend)
+        .field("processes", std::max<std::size_t>(supervisorOptions.processes, 1));
 
-    std::cout << "Auction service is starting on " << host << ":" << port << std::endl;
-    
-    if (!server.listen(host.c_str(), port)) {
-      std::cerr << "Failed to start HTTP server on " << host << ":" << port << std::endl;
-      return EXIT_FAILURE;
+    if (supervisorOptions.processes <= 1) {
+      return serve(config, true, [] {});
     }
+    // Движок держит лоты в памяти процесса: у нескольких процессов ставки на один лот разошлись бы
+    if (requireEnvOrDefault("BIDDING_ENGINE", "0") == "1") {
+      throw std::invalid_argument("BIDDING_ENGINE=1 requires a single process, unset SERVER_PROCESSES");
+    }
+
+    // Несколько процессов на одном порту: у каждого свои пулы БД, кэш токенов и куча, общих блокировок нет.
+    // Родитель только следит за ними и один раз регистрирует сервис в реестре
+    config.reusePort = true;
+    auction::core::ProcessSupervisor supervisor(supervisorOptions);
+    supervisor.addTask("service-registry", [] {
+      auction::core::AsyncHttpClient httpClient;
+      auction::core::ServiceRegistry registry(httpClient);
+      try {
+        registry.registerMethods(auction::api::apiMethods());
+      } catch (const std::exception& ex) {
+        AUCTION_LOG_WARN("Failed to register service in registry").field("error", ex.what());
+        return EXIT_FAILURE;
+      }
+      AUCTION_LOG_INFO("Service registry updated");
+      return EXIT_SUCCESS;
+    });
+    return supervisor.run([&config](auction::core::WorkerContext& context) {
+      return serve(config, false, [&context] { context.notifyReady(); }, context.slot());
+    });
   } catch (const std::exception& ex) {
-    std::cerr << "Fatal error: " << ex.what() << std::endl;
+    AUCTION_LOG_ERROR("Fatal error").field("error", ex.what());
     return EXIT_FAILURE;
   }
-
-  return EXIT_SUCCESS;
 }
-
@@ -0,0 +1,41 @@
+#include "auction/model/bid.h"
+
+#include <array>
+
+#include "auction/model/field_decoder.h"
+
+namespace auction::model {
+
+namespace {
+
+constexpr std::array<FieldSpec<BidRequest>, 2> kBidRequestFields{{
+    {"amount", &BidRequest::amount, true, OnNull::Reject},
+    {"bidder_id", &BidRequest::bidder_id, false, OnNull::Reset},
+}};
+
+}  // namespace
+
+nlohmann::json Bid::toJson() const {
+  nlohmann::json json = {
+      {"id", id},
+      {"lot_id", lot_id},
+      {"amount", amount.toDouble()},
+      {"created_at", formatTimestamp(created_at)},
+  };
+
+  if (bidder_id.has_value()) {
+    json["bidder_id"] = *bidder_id;
+  } else {
+    json["bidder_id"] = nullptr;
+  }
+
+  return json;
+}
+
+BidRequest bidRequestFromJson(std::string_view body) {
+  BidRequest request;
+  decodeFields(kBidRequestFields, body, request);
+  return request;
+}
+
+}  // namespace auction::model
@@ -0,0 +1,233 @@
+#include "auction/model/json_writer.h"
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <nlohmann/json.hpp>
+
+#include "auction/model/timestamp.h"
+
+namespace auction::model::json {
+
+namespace {
+
+// Готовые фрагменты «разделитель + ключ + двоеточие» в порядке сортировки ключей nlohmann
+constexpr std::string_view kLotAuctionEndDate = "{\"auction_end_date\":";
+constexpr std::string_view kLotCreatedAt = ",\"created_at\":";
+constexpr std::string_view kLotCurrentPrice = ",\"current_price\":";
+constexpr std::string_view kLotDescription = ",\"description\":";
+constexpr std::string_view kLotId = ",\"id\":";
+constexpr std::string_view kLotName = ",\"name\":";
+constexpr std::string_view kLotOwnerId = ",\"owner_id\":";
+constexpr std::string_view kLotStartPrice = ",\"start_price\":";
+
+constexpr std::string_view kBidAmount = "{\"amount\":";
+constexpr std::string_view kBidBidderId = ",\"bidder_id\":";
+constexpr std::string_view kBidCreatedAt = ",\"created_at\":";
+constexpr std::string_view kBidId = ",\"id\":";
+constexpr std::string_view kBidLotId = ",\"lot_id\":";
+
+constexpr std::string_view kNull = "null";
+
+// Байт требует особой обработки: управляющий символ, кавычка, обратный слеш или начало не-ASCII последовательности
+bool isSpecial(unsigned char byte) { return byte < 0x20 || byte == '"' || byte == '\\' || byte >= 0x80; }
+
+std::size_t findSpecial(const char* data, std::size_t position, std::size_t size) {
+#if defined(__SSE2__)
+  // Знаковое сравнение с 0x20 ловит и управляющие символы, и байты >= 0x80 (они отрицательные)
+  const __m128i space = _mm_set1_epi8(0x20);
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  while (position + 16 <= size) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position));
+    const __m128i special = _mm_or_si128(_mm_cmplt_epi8(chunk, space),
+                                         _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)));
+    const int mask = _mm_movemask_epi8(special);
+    if (mask != 0) {
+      return position + static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+    }
+    position += 16;
+  }
+#endif
+  while (position < size && !isSpecial(static_cast<unsigned char>(data[position]))) {
+    ++position;
+  }
+  return position;
+}
+
+bool isContinuation(unsigned char byte) { return (byte & 0xC0) == 0x80; }
+
+// Длина корректной UTF-8 последовательности, начинающейся с position, или 0.
+// Те же правила, что у nlohmann: без overlong-форм, суррогатов и кодов выше U+10FFFF.
+std::size_t utf8SequenceLength(const unsigned char* data, std::size_t position, std::size_t size) {
+  const unsigned char lead = data[position];
+  const std::size_t available = size - position;
+  auto byteAt = [&](std::size_t offset) { return offset < available ? data[position + offset] : 0; };
+
+  if (lead >= 0xC2 && lead <= 0xDF) {
+    return isContinuation(byteAt(1)) ? 2 : 0;
+  }
+  if (lead >= 0xE0 && lead <= 0xEF) {
+    const unsigned char second = byteAt(1);
+    const bool valid = lead == 0xE0   ? (second >= 0xA0 && second <= 0xBF)
+                       : lead == 0xED ? (second >= 0x80 && second <= 0x9F)
+                                      : isContinuation(second);
+    return valid && isContinuation(byteAt(2)) ? 3 : 0;
+  }
+  if (lead >= 0xF0 && lead <= 0xF4) {
+    const unsigned char second = byteAt(1);
+    const bool valid = lead == 0xF0   ? (second >= 0x90 && second <= 0xBF)
+                       : lead == 0xF4 ? (second >= 0x80 && second <= 0x8F)
+                                      : isContinuation(second);
+    return valid && isContinuation(byteAt(2)) && isContinuation(byteAt(3)) ? 4 : 0;
+  }
+  return 0;
+}
+
+void appendEscaped(std::string& out, unsigned char byte) {
+  switch (byte) {
+    case '"':
+      out += "\\\"";
+      break;
+    case '\\':
+      out += "\\\\";
+      break;
+    case '\b':
+      out += "\\b";
+      break;
+    case '\f':
+      out += "\\f";
+      break;
+    case '\n':
+      out += "\\n";
+      break;
+    case '\r':
+      out += "\\r";
+      break;
+    case '\t':
+      out += "\\t";
+      break;
+    default: {
+      constexpr char kHex[] = "0123456789abcdef";
+      const char escaped[] = {'\\', 'u', '0', '0', kHex[byte >> 4], kHex[byte & 0x0F]};
+      out.append(escaped, sizeof(escaped));
+      break;
+    }
+  }
+}
+
+void appendOptionalString(std::string& out, const std::optional<std::string>& value) {
+  if (value.has_value()) {
+    appendString(out, *value);
+  } else {
+    out += kNull;
+  }
+}
+
+void appendOptionalMoney(std::string& out, const std::optional<Money>& value) {
+  if (value.has_value()) {
+    value->appendDecimal(out);
+  } else {
+    out += kNull;
+  }
+}
+
+// Отформатированное время состоит из цифр и разделителей, экранирование не нужно
+void appendTimestampString(std::string& out, Timestamp value) {
+  out.push_back('"');
+  appendTimestamp(out, value);
+  out.push_back('"');
+}
+
+}  // namespace
+
+void appendString(std::string& out, std::string_view value) {
+  const auto* bytes = reinterpret_cast<const unsigned char*>(value.data());
+  const std::size_t size = value.size();
+  out.reserve(out.size() + size + 2);
+  out.push_back('"');
+
+  std::size_t runStart = 0;
+  std::size_t position = 0;
+  while ((position = findSpecial(value.data(), position, size)) < size) {
+    const unsigned char byte = bytes[position];
+    if (byte >= 0x80) {
+      // Корректный UTF-8 копируется как есть, поэтому просто перешагиваем последовательность
+      const std::size_t length = utf8SequenceLength(bytes, position, size);
+      if (length == 0) {
+        throw std::runtime_error("Invalid UTF-8 byte at index " + std::to_string(position));
+      }
+      position += length;
+      continue;
+    }
+
+    out.append(value.data() + runStart, position - runStart);
+    appendEscaped(out, byte);
+    runStart = ++position;
+  }
+
+  out.append(value.data() + runStart, size - runStart);
+  out.push_back('"');
+}
+
+void appendNumber(std::string& out, double value) {
+  if (!std::isfinite(value)) {
+    out += kNull;
+    return;
+  }
+  // Тот же Grisu2, что в nlohmann::json::dump(): кратчайший std::to_chars расходится с ним
+  // в последней цифре примерно на 0.1% значений, а ответы должны совпадать побайтно
+  char buffer[64];
+  char* end = nlohmann::detail::to_chars(buffer, buffer + sizeof(buffer), value);
+  out.append(buffer, end);
+}
+
+void appendLot(std::string& out, const Lot& lot) {
+  out += kLotAuctionEndDate;
+  if (lot.auction_end_date.has_value()) {
+    appendTimestampString(out, *lot.auction_end_date);
+  } else {
+    out += kNull;
+  }
+  out += kLotCreatedAt;
+  if (lot.created_at.has_value()) {
+    appendTimestampString(out, *lot.created_at);
+  } else {
+    out += "\"\"";
+  }
+  out += kLotCurrentPrice;
+  appendOptionalMoney(out, lot.current_price);
+  out += kLotDescription;
+  appendOptionalString(out, lot.description);
+  out += kLotId;
+  appendNumber(out, lot.id);
+  out += kLotName;
+  appendString(out, lot.name);
+  out += kLotOwnerId;
+  appendOptionalString(out, lot.owner_id);
+  out += kLotStartPrice;
+  lot.start_price.appendDecimal(out);
+  out.push_back('}');
+}
+
+void appendBid(std::string& out, const Bid& bid) {
+  out += kBidAmount;
+  bid.amount.appendDecimal(out);
+  out += kBidBidderId;
+  appendOptionalString(out, bid.bidder_id);
+  out += kBidCreatedAt;
+  appendTimestampString(out, bid.created_at);
+  out += kBidId;
+  appendNumber(out, bid.id);
+  out += kBidLotId;
+  appendNumber(out, bid.lot_id);
+  out.push_back('}');
+}
+
+}  // namespace auction::model::json
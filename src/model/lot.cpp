@@ -1,15 +1,42 @@
 #include "auction/model/lot.h"
 
-#include <stdexcept>
+#include <array>
+
+#include "auction/model/field_decoder.h"
 
 namespace auction::model {
 
+namespace {
+
+constexpr std::array<FieldSpec<Lot>, 7> kCreateFields{{
+    {"name", &Lot::name, true, OnNull::Reject},
+    {"description", &Lot::description, false, OnNull::Reset},
+    {"start_price", &Lot::start_price, true, OnNull::Reject},
+    {"current_price", &Lot::current_price, false, OnNull::Reset},
+    {"owner_id", &Lot::owner_id, false, OnNull::Reset},
+    {"created_at", &Lot::created_at, false, OnNull::Reset},
+    {"auction_end_date", &Lot::auction_end_date, false, OnNull::Reset},
+}};
+
+// null в name/start_price оставляет прежнее значение, в остальных полях — очищает его
+constexpr std::array<FieldSpec<Lot>, 6> kPatchFields{{
+    {"name", &Lot::name, false, OnNull::Skip},
+    {"description", &Lot::description, false, OnNull::Reset},
+    {"start_price", &Lot::start_price, false, OnNull::Skip},
+    {"current_price", &Lot::current_price, false, OnNull::Reset},
+    {"owner_id", &Lot::owner_id, false, OnNull::Reset},
+    {"auction_end_date", &Lot::auction_end_date, false, OnNull::Reset},
+}};
+
+}  // namespace
+
 nlohmann::json Lot::toJson() const {
   nlohmann::json json = {
       {"id", id},
       {"name", name},
-      {"start_price", start_price},
-      {"created_at", created_at},
+      {"start_price", start_price.toDouble()},
+      // Без значения — пустая строка, как до перехода на типизированное время
+      {"created_at", created_at ? formatTimestamp(*created_at) : std::string{}},
   };
 
   if (description.has_value()) {
@@ -19,7 +46,7 @@ nlohmann::json Lot::toJson() const {
   }
 
   if (current_price.has_value()) {
-    json["current_price"] = *current_price;
+    json["current_price"] = current_price->toDouble();
   } else {
     json["current_price"] = nullptr;
   }
@@ -31,7 +58,7 @@ nlohmann::json Lot::toJson() const {
   }
 
   if (auction_end_date.has_value()) {
-    json["auction_end_date"] = *auction_end_date;
+    json["auction_end_date"] = formatTimestamp(*auction_end_date);
   } else {
     json["auction_end_date"] = nullptr;
   }
@@ -39,38 +66,13 @@ nlohmann::json Lot::toJson() const {
   return json;
 }
 
-Lot lotFromJson(const nlohmann::json& json) {
+Lot lotFromJson(std::string_view body) {
   Lot lot;
-
-  if (!json.contains("name") || !json.contains("start_price")) {
-    throw std::invalid_argument("Missing required fields: name or start_price");
-  }
-
-  lot.name = json.at("name").get<std::string>();
-  lot.start_price = json.at("start_price").get<double>();
-
-  if (json.contains("description") && !json.at("description").is_null()) {
-    lot.description = json.at("description").get<std::string>();
-  }
-
-  if (json.contains("owner_id") && !json.at("owner_id").is_null()) {
-    lot.owner_id = json.at("owner_id").get<std::string>();
-  }
-
-  if (json.contains("auction_end_date") && !json.at("auction_end_date").is_null()) {
-    lot.auction_end_date = json.at("auction_end_date").get<std::string>();
-  }
-
-  if (json.contains("current_price") && !json.at("current_price").is_null()) {
-    lot.current_price = json.at("current_price").get<double>();
-  }
-
-  if (json.contains("created_at") && !json.at("created_at").is_null()) {
-    lot.created_at = json.at("created_at").get<std::string>();
-  }
-
+  decodeFields(kCreateFields, body, lot);
   return lot;
 }
 
+void applyLotPatch(Lot& lot, std::string_view body) { decodeFields(kPatchFields, body, lot); }
+
 }  // namespace auction::model
 
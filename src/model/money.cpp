@@ -0,0 +1,139 @@
+#include "auction/model/money.h"
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <limits>
+
+namespace auction::model {
+
+namespace {
+
+bool isDigit(char ch) { return ch >= '0' && ch <= '9'; }
+
+// Больше 18 цифр в копейках не влезает в int64 с гарантией
+constexpr int kMaxMinorDigits = 18;
+
+}  // namespace
+
+std::optional<Money> Money::fromUnits(std::int64_t units) {
+  constexpr auto kLimit = std::numeric_limits<std::int64_t>::max() / kMinorPerUnit;
+  if (units > kLimit || units < -kLimit) {
+    return std::nullopt;
+  }
+  return Money{units * kMinorPerUnit};
+}
+
+std::optional<Money> Money::parse(std::string_view text) {
+  std::size_t position = 0;
+  bool negative = false;
+  if (position < text.size() && (text[position] == '-' || text[position] == '+')) {
+    negative = text[position] == '-';
+    ++position;
+  }
+
+  // Значащие цифры без ведущих нулей и позиция десятичной точки относительно первой из них
+  std::array<int, kMaxMinorDigits + 2> significant{};
+  int count = 0;
+  int point = 0;
+  bool sawDigit = false;
+
+  for (; position < text.size() && isDigit(text[position]); ++position) {
+    sawDigit = true;
+    const int digit = text[position] - '0';
+    if (count == 0 && digit == 0) {
+      continue;
+    }
+    if (count == static_cast<int>(significant.size())) {
+      return std::nullopt;
+    }
+    significant[static_cast<std::size_t>(count++)] = digit;
+    ++point;
+  }
+
+  if (position < text.size() && text[position] == '.') {
+    ++position;
+    bool sawFraction = false;
+    for (; position < text.size() && isDigit(text[position]); ++position) {
+      sawFraction = true;
+      sawDigit = true;
+      const int digit = text[position] - '0';
+      if (count == 0 && digit == 0) {
+        --point;
+        continue;
+      }
+      // Цифры за пределами буфера лежат далеко за копейками и на результат не влияют
+      if (count < static_cast<int>(significant.size())) {
+        significant[static_cast<std::size_t>(count++)] = digit;
+      }
+    }
+    if (!sawFraction) {
+      return std::nullopt;
+    }
+  }
+  if (!sawDigit) {
+    return std::nullopt;
+  }
+
+  int exponent = 0;
+  if (position < text.size() && (text[position] == 'e' || text[position] == 'E')) {
+    ++position;
+    if (position < text.size() && text[position] == '+') {
+      ++position;
+    }
+    const auto [end, error] = std::from_chars(text.data() + position, text.data() + text.size(), exponent);
+    if (error != std::errc{}) {
+      return std::nullopt;
+    }
+    position = static_cast<std::size_t>(end - text.data());
+  }
+  if (position != text.size()) {
+    return std::nullopt;
+  }
+  if (count == 0) {
+    return Money{};
+  }
+
+  // Сколько значащих цифр приходится на целую часть суммы в копейках
+  const long long integerDigits = static_cast<long long>(point) + exponent + kScale;
+  if (integerDigits > kMaxMinorDigits) {
+    return std::nullopt;
+  }
+
+  std::int64_t minor = 0;
+  for (long long i = 0; i < integerDigits; ++i) {
+    minor = minor * 10 + (i < count ? significant[static_cast<std::size_t>(i)] : 0);
+  }
+  if (integerDigits >= 0 && integerDigits < count && significant[static_cast<std::size_t>(integerDigits)] >= 5) {
+    ++minor;
+  }
+
+  return Money{negative ? -minor : minor};
+}
+
+void Money::appendDecimal(std::string& out) const {
+  std::uint64_t magnitude = static_cast<std::uint64_t>(minorUnits_);
+  if (minorUnits_ < 0) {
+    out.push_back('-');
+    magnitude = ~magnitude + 1;
+  }
+
+  char buffer[24];
+  auto* end = std::to_chars(buffer, buffer + sizeof(buffer), magnitude / kMinorPerUnit).ptr;
+  *end++ = '.';
+  const auto cents = static_cast<unsigned>(magnitude % kMinorPerUnit);
+  *end++ = static_cast<char>('0' + cents / 10);
+  // Как у nlohmann: "150.0", "275.5", но "310.25" — хвостовой ноль только у целых сумм
+  if (cents % 10 != 0) {
+    *end++ = static_cast<char>('0' + cents % 10);
+  }
+  out.append(buffer, end);
+}
+
+std::string Money::toString() const {
+  std::string out;
+  appendDecimal(out);
+  return out;
+}
+
+}  // namespace auction::model
@@ -0,0 +1,265 @@
+#include "auction/model/timestamp.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace auction::model {
+
+namespace {
+
+// Разбор слева направо по string_view; каждый шаг либо продвигает позицию, либо сообщает об ошибке
+class Cursor {
+ public:
+  explicit Cursor(std::string_view input) : input_(input) {}
+
+  [[nodiscard]] bool done() const { return position_ == input_.size(); }
+  [[nodiscard]] char peek() const { return done() ? '\0' : input_[position_]; }
+
+  bool consume(char expected) {
+    if (peek() != expected) {
+      return false;
+    }
+    ++position_;
+    return true;
+  }
+
+  // Ровно count десятичных цифр
+  bool digits(int count, int& value) {
+    if (input_.size() - position_ < static_cast<std::size_t>(count)) {
+      return false;
+    }
+    int result = 0;
+    for (int i = 0; i < count; ++i) {
+      const char ch = input_[position_ + static_cast<std::size_t>(i)];
+      if (ch < '0' || ch > '9') {
+        return false;
+      }
+      result = result * 10 + (ch - '0');
+    }
+    position_ += static_cast<std::size_t>(count);
+    value = result;
+    return true;
+  }
+
+  // Дробная часть секунды любой длины, округлённая до микросекунд, как при записи в TIMESTAMPTZ
+  bool fraction(std::int64_t& micros) {
+    std::int64_t result = 0;
+    int scale = 0;
+    bool roundUp = false;
+    const std::size_t start = position_;
+    while (!done() && peek() >= '0' && peek() <= '9') {
+      const int digit = peek() - '0';
+      if (scale < 6) {
+        result = result * 10 + digit;
+        ++scale;
+      } else if (scale == 6) {
+        roundUp = digit >= 5;
+        ++scale;
+      }
+      ++position_;
+    }
+    if (position_ == start) {
+      return false;
+    }
+    for (; scale < 6; ++scale) {
+      result *= 10;
+    }
+    micros = result + (roundUp ? 1 : 0);
+    return true;
+  }
+
+ private:
+  std::string_view input_;
+  std::size_t position_{0};
+};
+
+// Диапазон parseTimestamp в UTC: годы 0001-9999
+constexpr Timestamp kMinTimestamp{std::chrono::sys_days{std::chrono::year{1} / std::chrono::January / 1}};
+constexpr Timestamp kMaxTimestamp{std::chrono::sys_days{std::chrono::year{10000} / std::chrono::January / 1}};
+
+bool isDateTimeSeparator(char ch) { return ch == 'T' || ch == 't' || ch == ' '; }
+
+// "Z", "+HH", "+HHMM", "+HH:MM", "+HH:MM:SS" (PostgreSQL печатает секунды для исторических смещений)
+bool parseOffset(Cursor& cursor, std::chrono::seconds& offset) {
+  if (cursor.consume('Z') || cursor.consume('z')) {
+    offset = std::chrono::seconds{0};
+    return true;
+  }
+
+  int sign = 1;
+  if (cursor.consume('-')) {
+    sign = -1;
+  } else if (!cursor.consume('+')) {
+    return false;
+  }
+
+  int hours = 0;
+  int minutes = 0;
+  int seconds = 0;
+  if (!cursor.digits(2, hours)) {
+    return false;
+  }
+  if (cursor.consume(':')) {
+    if (!cursor.digits(2, minutes)) {
+      return false;
+    }
+    if (cursor.consume(':') && !cursor.digits(2, seconds)) {
+      return false;
+    }
+  } else if (!cursor.done()) {
+    if (!cursor.digits(2, minutes)) {
+      return false;
+    }
+  }
+  if (hours > 15 || minutes > 59 || seconds > 59) {
+    return false;
+  }
+
+  offset = std::chrono::seconds{sign * (hours * 3600 + minutes * 60 + seconds)};
+  return true;
+}
+
+// Десятичные цифры value шириной width с ведущими нулями; возвращает позицию за последней цифрой
+char* writeDigits(char* out, unsigned value, int width) {
+  for (int i = width - 1; i >= 0; --i) {
+    out[i] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+  return out + width;
+}
+
+}  // namespace
+
+std::optional<Timestamp> parseTimestamp(std::string_view value) {
+  if (value == "infinity") {
+    return Timestamp::max();
+  }
+  if (value == "-infinity") {
+    return Timestamp::min();
+  }
+
+  Cursor cursor(value);
+  int year = 0;
+  int month = 0;
+  int day = 0;
+  if (!cursor.digits(4, year) || !cursor.consume('-') || !cursor.digits(2, month) || !cursor.consume('-') ||
+      !cursor.digits(2, day)) {
+    return std::nullopt;
+  }
+
+  const std::chrono::year_month_day date{std::chrono::year{year}, std::chrono::month{static_cast<unsigned>(month)},
+                                         std::chrono::day{static_cast<unsigned>(day)}};
+  if (!date.ok()) {
+    return std::nullopt;
+  }
+
+  int hour = 0;
+  int minute = 0;
+  int second = 0;
+  std::int64_t micros = 0;
+  std::chrono::seconds offset{0};
+
+  if (!cursor.done()) {
+    if (!isDateTimeSeparator(cursor.peek())) {
+      return std::nullopt;
+    }
+    cursor.consume(cursor.peek());
+    if (!cursor.digits(2, hour) || !cursor.consume(':') || !cursor.digits(2, minute)) {
+      return std::nullopt;
+    }
+    if (cursor.consume(':')) {
+      if (!cursor.digits(2, second)) {
+        return std::nullopt;
+      }
+      if (cursor.consume('.') && !cursor.fraction(micros)) {
+        return std::nullopt;
+      }
+    }
+    // Секунда 60 допускается RFC 3339 и, как в PostgreSQL, переносится в следующую минуту
+    if (hour > 23 || minute > 59 || second > 60) {
+      return std::nullopt;
+    }
+    if (!cursor.done() && !parseOffset(cursor, offset)) {
+      return std::nullopt;
+    }
+    if (!cursor.done()) {
+      return std::nullopt;
+    }
+  }
+
+  // После перевода в UTC год должен остаться четырёхзначным: "9999-12-31T23:00:00-05:00" — уже 10000 год
+  const Timestamp result = Timestamp{std::chrono::sys_days{date}} + std::chrono::hours{hour} +
+                           std::chrono::minutes{minute} + std::chrono::seconds{second} +
+                           std::chrono::microseconds{micros} - offset;
+  if (result < kMinTimestamp || result >= kMaxTimestamp) {
+    return std::nullopt;
+  }
+  return result;
+}
+
+void appendTimestamp(std::string& out, Timestamp value) {
+  if (value == Timestamp::max()) {
+    out += "infinity";
+    return;
+  }
+  if (value == Timestamp::min()) {
+    out += "-infinity";
+    return;
+  }
+
+  using namespace std::chrono;
+  const auto days = floor<std::chrono::days>(value);
+  const year_month_day date{days};
+  const hh_mm_ss<microseconds> time{value - days};
+
+  // Собираем в буфер на стеке и дописываем одним append
+  char buffer[40];
+  char* position = buffer;
+  const int year = static_cast<int>(date.year());
+  if (year < 0) {
+    *position++ = '-';
+  }
+  // Из БД могут прийти годы после 9999: печатаем их всеми цифрами, а не обрезаем до четырёх
+  const auto absYear = static_cast<unsigned>(year < 0 ? -year : year);
+  int yearWidth = 4;
+  for (unsigned rest = absYear / 10000; rest != 0; rest /= 10) {
+    ++yearWidth;
+  }
+  position = writeDigits(position, absYear, yearWidth);
+  *position++ = '-';
+  position = writeDigits(position, static_cast<unsigned>(date.month()), 2);
+  *position++ = '-';
+  position = writeDigits(position, static_cast<unsigned>(date.day()), 2);
+  *position++ = ' ';
+  position = writeDigits(position, static_cast<unsigned>(time.hours().count()), 2);
+  *position++ = ':';
+  position = writeDigits(position, static_cast<unsigned>(time.minutes().count()), 2);
+  *position++ = ':';
+  position = writeDigits(position, static_cast<unsigned>(time.seconds().count()), 2);
+
+  auto fraction = static_cast<unsigned>(time.subseconds().count());
+  if (fraction != 0) {
+    // Как и PostgreSQL, отбрасываем хвостовые нули дробной части
+    int digits = 6;
+    while (fraction % 10 == 0) {
+      fraction /= 10;
+      --digits;
+    }
+    *position++ = '.';
+    position = writeDigits(position, fraction, digits);
+  }
+
+  *position++ = '+';
+  *position++ = '0';
+  *position++ = '0';
+  out.append(buffer, position);
+}
+
+std::string formatTimestamp(Timestamp value) {
+  std::string out;
+  out.reserve(32);
+  appendTimestamp(out, value);
+  return out;
+}
+
+}  // namespace auction::model
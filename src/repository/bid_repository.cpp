@@ -0,0 +1,181 @@
+#include "auction/repository/bid_repository.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "auction/core/pg_binary.h"
+#include "auction/model/timestamp.h"
+#include "auction/repository/cursor.h"
+
+namespace auction::repository {
+
+namespace {
+
+// Порядок колонок фиксирован и используется в mapBid
+constexpr const char* kSelectColumns = "id, lot_id, amount, bidder_id, created_at";
+constexpr int kIdColumn = 0;
+constexpr int kLotIdColumn = 1;
+constexpr int kAmountColumn = 2;
+constexpr int kBidderIdColumn = 3;
+constexpr int kCreatedAtColumn = 4;
+
+// История ставок — чтение списком: при перегрузке БД отклоняется первой
+constexpr core::StatementOptions kIdempotentBidRows{
+    .idempotent = true, .binaryResults = true, .priority = core::Priority::low};
+
+// Текстовый формат COPY: экранируем разделители и обратный слэш, NULL — \N
+void appendCopyField(std::string& out, const std::optional<std::string>& value) {
+  if (!value) {
+    out += "\\N";
+    return;
+  }
+  for (const char ch : *value) {
+    switch (ch) {
+      case '\\':
+        out += "\\\\";
+        break;
+      case '\t':
+        out += "\\t";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      case '\r':
+        out += "\\r";
+        break;
+      default:
+        out += ch;
+    }
+  }
+}
+
+}  // namespace
+
+BidRepository::BidRepository(core::Database& database) : database_(database) {}
+
+void BidRepository::ensureSchema() {
+  // Без внешнего ключа на lots: история — журнал аудита, и удаление лота не должно ронять пакет COPY.
+  // Процессы SERVER_PROCESSES выполняют DDL по очереди (core::kSchemaLockSql)
+  database_.executePipeline({
+      core::PipelineStep{.statement = core::kSchemaLockSql,
+                         .params = {},
+                         .prepared = false,
+                         .idempotent = true},
+      core::PipelineStep{.statement = R"(
+        CREATE TABLE IF NOT EXISTS bids (
+          id BIGSERIAL PRIMARY KEY,
+          lot_id INTEGER NOT NULL,
+          amount NUMERIC(12, 2) NOT NULL,
+          bidder_id VARCHAR(255),
+          created_at TIMESTAMPTZ NOT NULL DEFAULT CURRENT_TIMESTAMP
+        )
+      )",
+                         .params = {},
+                         .prepared = false,
+                         .idempotent = true},
+      // CREATE INDEX IF NOT EXISTS блокирует запись в bids и тогда, когда индекс уже есть
+      core::PipelineStep{.statement = R"(
+        DO $$
+        BEGIN
+          IF to_regclass('idx_bids_lot_created') IS NULL THEN
+            CREATE INDEX idx_bids_lot_created ON bids(lot_id, created_at, id);
+          END IF;
+        END
+        $$
+      )",
+                         .params = {},
+                         .prepared = false,
+                         .idempotent = true},
+  });
+}
+
+void BidRepository::prepareStatements() {
+  std::call_once(statementsPrepared_, [this] { registerStatements(); });
+}
+
+void BidRepository::registerStatements() {
+  database_.prepare("bid_select_page",
+                    std::string{"SELECT "} + kSelectColumns +
+                        " FROM bids WHERE lot_id = $1 ORDER BY created_at DESC, id DESC LIMIT $2",
+                    kIdempotentBidRows);
+  database_.prepare("bid_select_page_after",
+                    std::string{"SELECT "} + kSelectColumns +
+                        " FROM bids WHERE lot_id = $1 AND (created_at, id) < (TIMESTAMPTZ 'epoch' + $2::bigint * "
+                        "INTERVAL '1 microsecond', $3::bigint) ORDER BY created_at DESC, id DESC LIMIT $4",
+                    kIdempotentBidRows);
+}
+
+model::Bid BidRepository::mapBid(const PGresult* result, int row) {
+  model::Bid bid;
+  bid.id = core::pg::readInt8(PQgetvalue(result, row, kIdColumn));
+  bid.lot_id = core::pg::readInt4(PQgetvalue(result, row, kLotIdColumn));
+  bid.amount = model::Money::fromMinorUnits(core::pg::readNumericScaled(
+      PQgetvalue(result, row, kAmountColumn), PQgetlength(result, row, kAmountColumn), model::Money::kScale));
+  if (!PQgetisnull(result, row, kBidderIdColumn)) {
+    bid.bidder_id = std::string{PQgetvalue(result, row, kBidderIdColumn),
+                                static_cast<std::size_t>(PQgetlength(result, row, kBidderIdColumn))};
+  }
+  bid.created_at = core::pg::readTimestamptz(PQgetvalue(result, row, kCreatedAtColumn));
+  return bid;
+}
+
+void BidRepository::insertBatch(const std::vector<model::Bid>& bids) {
+  if (bids.empty()) {
+    return;
+  }
+
+  std::string data;
+  data.reserve(bids.size() * 64);
+  for (const auto& bid : bids) {
+    data += std::to_string(bid.lot_id);
+    data += '\t';
+    bid.amount.appendDecimal(data);
+    data += '\t';
+    appendCopyField(data, bid.bidder_id);
+    data += '\t';
+    model::appendTimestamp(data, bid.created_at);
+    data += '\n';
+  }
+
+  database_.copyIn("COPY bids (lot_id, amount, bidder_id, created_at) FROM STDIN", data);
+}
+
+BidRepository::PageQuery BidRepository::pageQuery(int lotId, std::size_t limit,
+                                                  const std::optional<std::string>& after) {
+  // Берём на одну строку больше, чтобы знать, есть ли следующая страница
+  const std::string fetch = std::to_string(limit + 1);
+  if (after) {
+    const auto cursor = Cursor::decode(*after);
+    return PageQuery{"bid_select_page_after",
+                     {std::to_string(lotId), std::to_string(cursor.createdAtMicros), std::to_string(cursor.id), fetch}};
+  }
+  return PageQuery{"bid_select_page", {std::to_string(lotId), fetch}};
+}
+
+BidPage BidRepository::toPage(const PGresult* result, std::size_t limit) {
+  BidPage page;
+  const int rows = PQntuples(result);
+  const int visible = std::min(rows, static_cast<int>(limit));
+  page.bids.reserve(static_cast<std::size_t>(std::max(visible, 0)));
+  for (int i = 0; i < visible; ++i) {
+    page.bids.push_back(mapBid(result, i));
+  }
+
+  if (rows > visible && visible > 0) {
+    const auto& last = page.bids.back();
+    page.nextCursor = Cursor{last.created_at.time_since_epoch().count(), last.id}.encode();
+  }
+
+  return page;
+}
+
+core::Task<BidPage> BidRepository::listByLotTask(int lotId, std::size_t limit, std::optional<std::string> after) {
+  prepareStatements();
+  auto query = pageQuery(lotId, limit, after);
+  auto result = co_await database_.executePreparedTask(query.statement, std::move(query.params));
+  co_return toPage(result.get(), limit);
+}
+
+}  // namespace auction::repository
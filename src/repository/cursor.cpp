@@ -0,0 +1,30 @@
+#include "auction/repository/cursor.h"
+
+#include <charconv>
+#include <stdexcept>
+
+namespace auction::repository {
+
+std::string Cursor::encode() const {
+  return std::to_string(createdAtMicros) + "_" + std::to_string(id);
+}
+
+Cursor Cursor::decode(const std::string& cursor) {
+  const auto separator = cursor.find('_');
+  if (separator == std::string::npos) {
+    throw std::invalid_argument("Invalid cursor");
+  }
+
+  Cursor result;
+  const char* begin = cursor.data();
+  const char* middle = begin + separator;
+  const char* end = begin + cursor.size();
+  const auto [microsEnd, microsError] = std::from_chars(begin, middle, result.createdAtMicros);
+  const auto [idEnd, idError] = std::from_chars(middle + 1, end, result.id);
+  if (microsError != std::errc{} || microsEnd != middle || idError != std::errc{} || idEnd != end) {
+    throw std::invalid_argument("Invalid cursor");
+  }
+  return result;
+}
+
+}  // namespace auction::repository
@@ -0,0 +1,151 @@
+#include "auction/repository/lot_cache.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include "auction/core/env.h"
+
+namespace auction::repository {
+
+LotCacheOptions LotCacheOptions::fromEnvironment() {
+  LotCacheOptions options;
+  options.enabled = core::envSize("LOT_CACHE", 1) != 0;
+  options.shards = std::max<std::size_t>(core::envSize("LOT_CACHE_SHARDS", options.shards), 1);
+  options.capacity = std::max<std::size_t>(core::envSize("LOT_CACHE_CAPACITY", options.capacity), 1);
+  options.ttl = std::chrono::milliseconds{
+      std::max<std::size_t>(core::envSize("LOT_CACHE_TTL_MS", static_cast<std::size_t>(options.ttl.count())), 1)};
+  return options;
+}
+
+LotCache::LotCache(LotCacheOptions options)
+    : options_(options),
+      shardCapacity_(std::max<std::size_t>(options_.capacity / std::max<std::size_t>(options_.shards, 1), 1)) {
+  shards_.reserve(std::max<std::size_t>(options_.shards, 1));
+  for (std::size_t i = 0; i < std::max<std::size_t>(options_.shards, 1); ++i) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+}
+
+LotCache::Shard& LotCache::shardFor(int id) {
+  return *shards_[std::hash<int>{}(id) % shards_.size()];
+}
+
+std::optional<model::Lot> LotCache::get(int id) {
+  if (!coherent_.load(std::memory_order_acquire)) {
+    return std::nullopt;
+  }
+
+  auto& shard = shardFor(id);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.index.find(id);
+  // Просроченная запись остаётся на месте: её освежит put после чтения из БД
+  if (it == shard.index.end() || std::chrono::steady_clock::now() - it->second->stored >= options_.ttl) {
+    ++shard.misses;
+    return std::nullopt;
+  }
+
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+  ++shard.hits;
+  return it->second->lot;
+}
+
+LotCache::Ticket LotCache::ticket(int id) {
+  auto& shard = shardFor(id);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return Ticket{epoch_.load(std::memory_order_acquire), shard.changes};
+}
+
+void LotCache::put(const Ticket& ticket, const model::Lot& lot, std::uint64_t version) {
+  if (!coherent_.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  auto& shard = shardFor(lot.id);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  if (ticket.epoch != epoch_.load(std::memory_order_acquire) || ticket.changes != shard.changes) {
+    return;
+  }
+
+  const auto now = std::chrono::steady_clock::now();
+  if (auto it = shard.index.find(lot.id); it != shard.index.end()) {
+    if (it->second->version <= version) {
+      it->second->lot = lot;
+      it->second->version = version;
+      it->second->stored = now;
+    }
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    return;
+  }
+
+  shard.lru.push_front(Entry{lot, version, now});
+  shard.index.emplace(lot.id, shard.lru.begin());
+  while (shard.lru.size() > shardCapacity_) {
+    // Вытесненная запись несла версию: без неё запрос, начатый раньше, мог бы положить более старую
+    ++shard.changes;
+    shard.index.erase(shard.lru.back().lot.id);
+    shard.lru.pop_back();
+    ++shard.evictions;
+  }
+}
+
+void LotCache::invalidate(int id, std::uint64_t version) {
+  auto& shard = shardFor(id);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  // Уведомление о собственной записи, которая уже лежит в кэше
+  if (auto it = shard.index.find(id); it != shard.index.end() && it->second->version >= version) {
+    return;
+  }
+  dropLocked(shard, id);
+}
+
+void LotCache::remove(int id) {
+  auto& shard = shardFor(id);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  dropLocked(shard, id);
+}
+
+void LotCache::dropLocked(Shard& shard, int id) {
+  ++shard.changes;
+  if (auto it = shard.index.find(id); it != shard.index.end()) {
+    shard.lru.erase(it->second);
+    shard.index.erase(it);
+    ++shard.invalidations;
+  }
+}
+
+void LotCache::invalidateAll() {
+  // Эпоха меняется до очистки: запросы, начатые до сброса, положить свой результат уже не смогут
+  epoch_.fetch_add(1, std::memory_order_acq_rel);
+  clear();
+}
+
+void LotCache::setCoherent(bool coherent) {
+  coherent_.store(false, std::memory_order_release);
+  invalidateAll();
+  coherent_.store(coherent, std::memory_order_release);
+}
+
+void LotCache::clear() {
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    shard->index.clear();
+    shard->lru.clear();
+  }
+}
+
+LotCacheStats LotCache::stats() const {
+  LotCacheStats stats;
+  stats.coherent = coherent_.load(std::memory_order_relaxed);
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    stats.hits += shard->hits;
+    stats.misses += shard->misses;
+    stats.invalidations += shard->invalidations;
+    stats.evictions += shard->evictions;
+    stats.size += shard->lru.size();
+  }
+  return stats;
+}
+
+}  // namespace auction::repository
@@ -1,181 +1,567 @@
 #include "auction/repository/lot_repository.h"
 
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "auction/core/pg_binary.h"
+#include "auction/model/money.h"
+#include "auction/model/timestamp.h"
+#include "auction/repository/cursor.h"
+
+namespace auction::repository {
+
 namespace {
 
+std::optional<std::string> formatOptionalTimestamp(const std::optional<model::Timestamp>& value) {
+  return value ? std::optional<std::string>{model::formatTimestamp(*value)} : std::nullopt;
+}
+
+std::optional<std::string> formatOptionalMoney(const std::optional<model::Money>& value) {
+  return value ? std::optional<std::string>{value->toString()} : std::nullopt;
+}
+
+// version нужна только кэшу лотов; mapLot её не читает
 constexpr const char* kSelectColumns =
-    "id, name, description, start_price, current_price, owner_id, created_at, auction_end_date";
+    "id, name, description, start_price, current_price, owner_id, created_at, auction_end_date, version";
+
+// Канал NOTIFY триггера lots_notify_change
+constexpr const char* kChangesChannel = "lot_changed";
+
+// Повтор после разрыва соединения безопасен: повторное выполнение даёт тот же результат.
+// Запись цены движком ставок идёт первой в очереди ограничителя нагрузки
+constexpr core::StatementOptions kPersistPrice{
+    .idempotent = true, .binaryResults = false, .priority = core::Priority::high};
+
+// Statements, возвращающие строки лотов, читаются в бинарном формате (см. mapLot)
+constexpr core::StatementOptions kLotRows{
+    .idempotent = false, .binaryResults = true, .priority = core::Priority::normal};
+constexpr core::StatementOptions kIdempotentLotRows{
+    .idempotent = true, .binaryResults = true, .priority = core::Priority::normal};
+// Ставки обслуживаются раньше остального, списки при перегрузке отклоняются первыми
+constexpr core::StatementOptions kBidLotRows{
+    .idempotent = false, .binaryResults = true, .priority = core::Priority::high};
+constexpr core::StatementOptions kListLotRows{
+    .idempotent = true, .binaryResults = true, .priority = core::Priority::low};
+
+int requireColumn(const PGresult* result, const char* name) {
+  const int index = PQfnumber(result, name);
+  if (index < 0) {
+    throw std::runtime_error(std::string{"Missing column in lot result: "} + name);
+  }
+  return index;
+}
 
-}  // namespace
+std::string readText(const PGresult* result, int row, int column) {
+  return std::string{PQgetvalue(result, row, column), static_cast<std::size_t>(PQgetlength(result, row, column))};
+}
 
-namespace auction::repository {
+// NUMERIC(12, 2) декодируется сразу в копейки, без double
+model::Money readMoney(const PGresult* result, int row, int column) {
+  return model::Money::fromMinorUnits(core::pg::readNumericScaled(
+      PQgetvalue(result, row, column), PQgetlength(result, row, column), model::Money::kScale));
+}
+
+// Параметры lot_insert ($1..$6) или, если передан id, lot_update ($1 — id, затем те же поля)
+std::vector<std::optional<std::string>> lotParams(const model::Lot& lot, std::optional<int> id = std::nullopt) {
+  std::vector<std::optional<std::string>> params;
+  params.reserve(7);
+  if (id) {
+    params.emplace_back(std::to_string(*id));
+  }
+  params.emplace_back(lot.name);
+  params.push_back(lot.description);
+  params.emplace_back(lot.start_price.toString());
+  params.push_back(formatOptionalMoney(lot.current_price));
+  params.push_back(lot.owner_id);
+  params.push_back(formatOptionalTimestamp(lot.auction_end_date));
+  return params;
+}
+
+// Версия строки (lots.version) в первой строке результата
+std::uint64_t readVersion(const PGresult* result) {
+  return static_cast<std::uint64_t>(core::pg::readInt8(PQgetvalue(result, 0, requireColumn(result, "version"))));
+}
+
+model::Lot requireInserted(std::optional<model::Lot> lot) {
+  if (!lot) {
+    throw std::runtime_error("Failed to insert lot");
+  }
+  return std::move(*lot);
+}
+
+int affectedRows(const PGresult* result) {
+  const char* affected = PQcmdTuples(const_cast<PGresult*>(result));
+  if (!affected || *affected == '\0') {
+    return 0;
+  }
+  return std::stoi(affected);
+}
+
+core::PipelineStep ddlStep(std::string sql) {
+  return core::PipelineStep{.statement = std::move(sql), .params = {}, .prepared = false, .idempotent = true};
+}
+
+}  // namespace
 
-LotRepository::LotRepository(core::Database& database) : database_(database) {}
+LotRepository::LotRepository(core::Database& database, LotCache* cache) : database_(database), cache_(cache) {}
 
 void LotRepository::ensureSchema() {
-  database_.query(R"(
-    CREATE TABLE IF NOT EXISTS lots (
-      id SERIAL PRIMARY KEY,
-      name VARCHAR(255) NOT NULL,
-      description TEXT,
-      start_price NUMERIC(12, 2) NOT NULL,
-      current_price NUMERIC(12, 2),
-      owner_id VARCHAR(255),
-      created_at TIMESTAMPTZ DEFAULT CURRENT_TIMESTAMP,
-      auction_end_date TIMESTAMPTZ
-    )
-  )");
-
-  database_.query("CREATE INDEX IF NOT EXISTS idx_lots_owner_id ON lots(owner_id)");
-  database_.query("CREATE INDEX IF NOT EXISTS idx_lots_auction_end_date ON lots(auction_end_date)");
+  // DDL уходит одним пакетом: один round trip вместо нескольких.
+  // version растёт с каждым UPDATE, об изменениях строки триггер сообщает в канал lot_changed —
+  // по этим уведомлениям экземпляры сервиса сбрасывают кэш лотов. Ставки (меняется только current_price)
+  // не уведомляют: транзакции с NOTIFY коммитятся по одной под глобальной блокировкой, и поток ставок
+  // на горячий лот выстроился бы в очередь на коммите. Цены в кэше догоняет LotCacheOptions::ttl.
+  // При SERVER_PROCESSES > 1 DDL выполняют все процессы сразу, и параллельные CREATE OR REPLACE падают
+  // с "tuple concurrently updated". Пакет — одна транзакция, поэтому блокировка первым шагом
+  // выстраивает процессы по очереди и снимается с коммитом
+  database_.executePipeline({
+      ddlStep(core::kSchemaLockSql),
+      ddlStep(R"(
+        CREATE TABLE IF NOT EXISTS lots (
+          id SERIAL PRIMARY KEY,
+          name VARCHAR(255) NOT NULL,
+          description TEXT,
+          start_price NUMERIC(12, 2) NOT NULL,
+          current_price NUMERIC(12, 2),
+          owner_id VARCHAR(255),
+          created_at TIMESTAMPTZ NOT NULL DEFAULT CURRENT_TIMESTAMP,
+          auction_end_date TIMESTAMPTZ
+        )
+      )"),
+      // ALTER TABLE, CREATE INDEX и CREATE TRIGGER блокируют lots даже без изменений, а с rolling restart
+      // схему проверяет каждый рабочий процесс. Поэтому они выполняются, только если каталог говорит,
+      // что объекта ещё нет. Keyset-пагинация идёт по (created_at, id): строка с NULL не попала бы ни на
+      // одну страницу после первой, так что таблицы, созданные до NOT NULL, дозаполняются
+      ddlStep(R"(
+        DO $$
+        BEGIN
+          IF to_regclass('idx_lots_owner_id') IS NULL THEN
+            CREATE INDEX idx_lots_owner_id ON lots(owner_id);
+          END IF;
+          IF to_regclass('idx_lots_auction_end_date') IS NULL THEN
+            CREATE INDEX idx_lots_auction_end_date ON lots(auction_end_date);
+          END IF;
+          IF to_regclass('idx_lots_created_at_id') IS NULL THEN
+            CREATE INDEX idx_lots_created_at_id ON lots(created_at, id);
+          END IF;
+          IF EXISTS (SELECT 1 FROM pg_attribute
+                     WHERE attrelid = 'lots'::regclass AND attname = 'created_at' AND NOT atthasdef) THEN
+            ALTER TABLE lots ALTER COLUMN created_at SET DEFAULT CURRENT_TIMESTAMP;
+          END IF;
+          IF EXISTS (SELECT 1 FROM pg_attribute
+                     WHERE attrelid = 'lots'::regclass AND attname = 'created_at' AND NOT attnotnull) THEN
+            UPDATE lots SET created_at = CURRENT_TIMESTAMP WHERE created_at IS NULL;
+            ALTER TABLE lots ALTER COLUMN created_at SET NOT NULL;
+          END IF;
+          IF NOT EXISTS (SELECT 1 FROM information_schema.columns
+                         WHERE table_schema = current_schema() AND table_name = 'lots'
+                           AND column_name = 'version') THEN
+            ALTER TABLE lots ADD COLUMN version BIGINT NOT NULL DEFAULT 1;
+          END IF;
+        END
+        $$
+      )"),
+      ddlStep(R"(
+        CREATE OR REPLACE FUNCTION lots_bump_version() RETURNS trigger LANGUAGE plpgsql AS $$
+        BEGIN
+          NEW.version := OLD.version + 1;
+          RETURN NEW;
+        END
+        $$
+      )"),
+      ddlStep(R"(
+        CREATE OR REPLACE FUNCTION lots_notify_change() RETURNS trigger LANGUAGE plpgsql AS $$
+        BEGIN
+          IF TG_OP = 'UPDATE' AND (NEW.name, NEW.description, NEW.start_price, NEW.owner_id, NEW.created_at,
+                                   NEW.auction_end_date) IS NOT DISTINCT FROM
+                                  (OLD.name, OLD.description, OLD.start_price, OLD.owner_id, OLD.created_at,
+                                   OLD.auction_end_date) THEN
+            RETURN NULL;
+          END IF;
+          IF TG_OP = 'DELETE' THEN
+            PERFORM pg_notify('lot_changed', OLD.id::text);
+          ELSE
+            PERFORM pg_notify('lot_changed', NEW.id::text || ':' || NEW.version::text);
+          END IF;
+          RETURN NULL;
+        END
+        $$
+      )"),
+      // Тела функций обновляются CREATE OR REPLACE FUNCTION, сами триггеры создаются один раз
+      ddlStep(R"(
+        DO $$
+        BEGIN
+          IF NOT EXISTS (SELECT 1 FROM pg_trigger
+                         WHERE tgrelid = 'lots'::regclass AND tgname = 'lots_bump_version') THEN
+            CREATE TRIGGER lots_bump_version BEFORE UPDATE ON lots
+              FOR EACH ROW EXECUTE FUNCTION lots_bump_version();
+          END IF;
+          IF NOT EXISTS (SELECT 1 FROM pg_trigger
+                         WHERE tgrelid = 'lots'::regclass AND tgname = 'lots_notify_change') THEN
+            CREATE TRIGGER lots_notify_change AFTER INSERT OR UPDATE OR DELETE ON lots
+              FOR EACH ROW EXECUTE FUNCTION lots_notify_change();
+          END IF;
+        END
+        $$
+      )"),
+  });
 }
 
-void LotRepository::prepareStatements() {
-  // Если база данных переподключалась, нужно пересоздать prepared statements
-  if (database_.checkAndClearReconnectFlag()) {
-    statementsPrepared_ = false;
+std::unique_ptr<core::PgListener> LotRepository::listenForChanges() {
+  if (!cache_) {
+    return nullptr;
   }
-  
-  if (statementsPrepared_) {
+  return database_.listen(
+      kChangesChannel, [this](const std::string& payload) { applyChange(payload); },
+      [this](bool listening) { cache_->setCoherent(listening); });
+}
+
+void LotRepository::applyChange(const std::string& payload) {
+  const char* begin = payload.data();
+  const char* end = begin + payload.size();
+  int id = 0;
+  auto [next, error] = std::from_chars(begin, end, id);
+  if (error == std::errc{} && next == end) {
+    cache_->remove(id);
     return;
   }
 
-  database_.prepare("lot_select_all", std::string{"SELECT "} + kSelectColumns + " FROM lots ORDER BY created_at DESC");
-  database_.prepare("lot_select_by_id", std::string{"SELECT "} + kSelectColumns + " FROM lots WHERE id = $1");
+  std::uint64_t version = 0;
+  if (error == std::errc{} && *next == ':') {
+    auto [last, versionError] = std::from_chars(next + 1, end, version);
+    if (versionError == std::errc{} && last == end) {
+      cache_->invalidate(id, version);
+      return;
+    }
+  }
+
+  // Непонятное уведомление: какой лот изменился, неизвестно — сбрасываем всё
+  cache_->invalidateAll();
+}
+
+std::optional<LotCacheStats> LotRepository::cacheStats() const {
+  if (!cache_) {
+    return std::nullopt;
+  }
+  return cache_->stats();
+}
+
+void LotRepository::prepareStatements() {
+  // Statements регистрируются один раз; на новых соединениях пула Database подготавливает их сама
+  std::call_once(statementsPrepared_, [this] { registerStatements(); });
+}
+
+void LotRepository::registerStatements() {
+  database_.prepare("lot_select_all",
+                    std::string{"SELECT "} + kSelectColumns + " FROM lots ORDER BY created_at DESC, id DESC",
+                    kListLotRows);
+  database_.prepare("lot_select_page",
+                    std::string{"SELECT "} + kSelectColumns + " FROM lots ORDER BY created_at DESC, id DESC LIMIT $1",
+                    kListLotRows);
+  database_.prepare("lot_select_page_after",
+                    std::string{"SELECT "} + kSelectColumns +
+                        " FROM lots WHERE (created_at, id) < (TIMESTAMPTZ 'epoch' + $1::bigint * INTERVAL '1 microsecond', "
+                        "$2::integer) ORDER BY created_at DESC, id DESC LIMIT $3",
+                    kListLotRows);
+  database_.prepare("lot_select_by_id", std::string{"SELECT "} + kSelectColumns + " FROM lots WHERE id = $1",
+                    kIdempotentLotRows);
   database_.prepare("lot_insert",
                     "INSERT INTO lots (name, description, start_price, current_price, owner_id, auction_end_date) "
                     "VALUES ($1, $2, $3, $4, $5, $6) RETURNING " +
-                        std::string{kSelectColumns});
+                        std::string{kSelectColumns},
+                    kLotRows);
+  // current_price не снижается: движок ставок мог принять ставки, которых ещё нет в прочитанной строке
   database_.prepare("lot_update",
-                    "UPDATE lots SET name=$2, description=$3, start_price=$4, current_price=$5, owner_id=$6, "
+                    "UPDATE lots SET name=$2, description=$3, start_price=$4, "
+                    "current_price=GREATEST(current_price, $5::numeric), owner_id=$6, "
                     "auction_end_date=$7 WHERE id=$1 RETURNING " +
-                        std::string{kSelectColumns});
+                        std::string{kSelectColumns},
+                    kIdempotentLotRows);
   database_.prepare("lot_delete", "DELETE FROM lots WHERE id=$1");
-  database_.prepare("lot_update_bid",
-                    "UPDATE lots SET current_price=$2 WHERE id=$1 RETURNING " + std::string{kSelectColumns});
+  // Равная цена тоже обновляет строку: повтор пакета после разрыва соединения не должен считаться отказом.
+  // found отличает удалённый лот от лота, цена которого в БД уже выше
+  database_.prepare("lot_persist_price",
+                    "WITH updated AS ("
+                    "  UPDATE lots SET current_price = $2::numeric"
+                    "  WHERE id = $1 AND (current_price IS NULL OR current_price <= $2::numeric)"
+                    "  RETURNING id"
+                    ") "
+                    "SELECT EXISTS (SELECT 1 FROM updated) AS persisted, "
+                    "EXISTS (SELECT 1 FROM lots WHERE id = $1) AS found",
+                    kPersistPrice);
+  // Compare-and-set ставки: проверка и запись в одном statement, без гонки между чтением и UPDATE.
+  // При READ COMMITTED UPDATE перепроверяет условие на последней версии строки после блокировки.
+  database_.prepare("lot_place_bid",
+                    "WITH updated AS ("
+                    "  UPDATE lots SET current_price = $2::numeric"
+                    "  WHERE id = $1 AND $2::numeric > start_price AND $2::numeric > COALESCE(current_price, start_price)"
+                    "    AND (auction_end_date IS NULL OR auction_end_date > now())"
+                    "  RETURNING " +
+                        std::string{kSelectColumns} +
+                        ") "
+                        "SELECT NULL::text AS rejection, " +
+                        kSelectColumns +
+                        " FROM updated "
+                        "UNION ALL "
+                        "SELECT CASE"
+                        "  WHEN $2::numeric <= start_price OR $2::numeric <= COALESCE(current_price, start_price)"
+                        "    THEN 'bid_too_low'"
+                        "  WHEN auction_end_date IS NOT NULL AND auction_end_date <= now() THEN 'auction_ended'"
+                        "  ELSE 'outbid' END, " +
+                        kSelectColumns + " FROM lots WHERE id = $1 AND NOT EXISTS (SELECT 1 FROM updated)",
+                    kBidLotRows);
+}
 
-  statementsPrepared_ = true;
+LotRepository::LotColumns LotRepository::LotColumns::resolve(const PGresult* result) {
+  return LotColumns{
+      .id = requireColumn(result, "id"),
+      .name = requireColumn(result, "name"),
+      .description = requireColumn(result, "description"),
+      .startPrice = requireColumn(result, "start_price"),
+      .currentPrice = requireColumn(result, "current_price"),
+      .ownerId = requireColumn(result, "owner_id"),
+      .createdAt = requireColumn(result, "created_at"),
+      .auctionEndDate = requireColumn(result, "auction_end_date"),
+  };
 }
 
-model::Lot LotRepository::mapLot(PGresult* result, int row) {
+LotRepository::LotColumns LotRepository::columnsFor(const std::string& statement, const PGresult* result) {
+  std::lock_guard<std::mutex> lock(columnsMutex_);
+  auto it = columns_.find(statement);
+  if (it == columns_.end()) {
+    it = columns_.emplace(statement, LotColumns::resolve(result)).first;
+  }
+  return it->second;
+}
+
+model::Lot LotRepository::mapLot(const PGresult* result, int row, const LotColumns& columns) {
+  // Значения в бинарном формате: int4, NUMERIC и TIMESTAMPTZ декодируются без промежуточных строк
   model::Lot lot;
-  lot.id = std::stoi(PQgetvalue(result, row, 0));
-  lot.name = PQgetvalue(result, row, 1);
+  lot.id = core::pg::readInt4(PQgetvalue(result, row, columns.id));
+  lot.name = readText(result, row, columns.name);
 
-  if (!PQgetisnull(result, row, 2)) {
-    lot.description = PQgetvalue(result, row, 2);
+  if (!PQgetisnull(result, row, columns.description)) {
+    lot.description = readText(result, row, columns.description);
   }
 
-  lot.start_price = std::stod(PQgetvalue(result, row, 3));
+  lot.start_price = readMoney(result, row, columns.startPrice);
 
-  if (!PQgetisnull(result, row, 4)) {
-    lot.current_price = std::stod(PQgetvalue(result, row, 4));
+  if (!PQgetisnull(result, row, columns.currentPrice)) {
+    lot.current_price = readMoney(result, row, columns.currentPrice);
   }
 
-  if (!PQgetisnull(result, row, 5)) {
-    lot.owner_id = PQgetvalue(result, row, 5);
+  if (!PQgetisnull(result, row, columns.ownerId)) {
+    lot.owner_id = readText(result, row, columns.ownerId);
   }
 
-  if (!PQgetisnull(result, row, 6)) {
-    lot.created_at = PQgetvalue(result, row, 6);
+  if (!PQgetisnull(result, row, columns.createdAt)) {
+    lot.created_at = core::pg::readTimestamptz(PQgetvalue(result, row, columns.createdAt));
   }
 
-  if (!PQgetisnull(result, row, 7)) {
-    lot.auction_end_date = PQgetvalue(result, row, 7);
+  if (!PQgetisnull(result, row, columns.auctionEndDate)) {
+    lot.auction_end_date = core::pg::readTimestamptz(PQgetvalue(result, row, columns.auctionEndDate));
   }
 
   return lot;
 }
 
-std::vector<model::Lot> LotRepository::list() {
-  prepareStatements();
-  auto result = database_.executePrepared("lot_select_all");
+LotRepository::PageQuery LotRepository::pageQuery(std::size_t limit, const std::optional<std::string>& after) {
+  // Берём на одну строку больше, чтобы знать, есть ли следующая страница
+  const std::string fetch = std::to_string(limit + 1);
+  if (after) {
+    const auto cursor = Cursor::decode(*after);
+    return PageQuery{"lot_select_page_after",
+                     {std::to_string(cursor.createdAtMicros), std::to_string(cursor.id), fetch}};
+  }
+  return PageQuery{"lot_select_page", {fetch}};
+}
+
+LotPage LotRepository::toPage(const std::string& statement, const PGresult* result, std::size_t limit) {
+  LotPage page;
+  const int rows = PQntuples(result);
+  if (rows == 0) {
+    return page;
+  }
 
-  std::vector<model::Lot> lots;
-  int rows = PQntuples(result.get());
-  lots.reserve(rows);
+  const auto columns = columnsFor(statement, result);
+  const int visible = std::min(rows, static_cast<int>(limit));
+  page.lots.reserve(static_cast<std::size_t>(visible));
+  for (int i = 0; i < visible; ++i) {
+    page.lots.push_back(mapLot(result, i, columns));
+  }
 
-  for (int i = 0; i < rows; ++i) {
-    lots.push_back(mapLot(result.get(), i));
+  // created_at NOT NULL (ensureSchema), так что курсор есть у любой неполной страницы
+  if (rows > visible && !page.lots.empty() && page.lots.back().created_at) {
+    const auto& last = page.lots.back();
+    page.nextCursor = Cursor{last.created_at->time_since_epoch().count(), last.id}.encode();
   }
 
-  return lots;
+  return page;
+}
+
+core::Task<LotPage> LotRepository::listPageTask(std::size_t limit, std::optional<std::string> after) {
+  prepareStatements();
+  auto query = pageQuery(limit, after);
+  auto result = co_await database_.executePreparedTask(query.statement, std::move(query.params));
+  co_return toPage(query.statement, result.get(), limit);
 }
 
-std::optional<model::Lot> LotRepository::findById(int id) {
+core::Task<LotRepository::Stream> LotRepository::openStreamTask() {
   prepareStatements();
+  co_return Stream(*this, co_await database_.openStreamTask("lot_select_all"));
+}
 
-  auto result = database_.executePrepared("lot_select_by_id", {std::to_string(id)});
-  if (PQntuples(result.get()) == 0) {
+LotRepository::Stream::Stream(LotRepository& repository, core::Database::RowStream rows)
+    : repository_(&repository), rows_(std::move(rows)) {}
+
+void LotRepository::Stream::forEach(const std::function<bool(const model::Lot&)>& onLot) {
+  std::optional<LotColumns> columns;
+  rows_.read([&](const PGresult* row) {
+    if (!columns) {
+      columns = repository_->columnsFor("lot_select_all", row);
+    }
+    return onLot(mapLot(row, 0, *columns));
+  });
+}
+
+std::optional<model::Lot> LotRepository::firstLot(const std::string& statement, const PGresult* result) {
+  if (PQntuples(result) == 0) {
     return std::nullopt;
   }
-
-  return mapLot(result.get(), 0);
+  return mapLot(result, 0, columnsFor(statement, result));
 }
 
-model::Lot LotRepository::create(const model::Lot& lot) {
-  prepareStatements();
+LotCache::Ticket LotRepository::cacheTicket(int id) {
+  return cache_ ? cache_->ticket(id) : LotCache::Ticket{};
+}
 
-  std::vector<std::optional<std::string>> params = {
-      lot.name,
-      lot.description,
-      std::to_string(lot.start_price),
-      lot.current_price ? std::optional<std::string>{std::to_string(*lot.current_price)} : std::nullopt,
-      lot.owner_id,
-      lot.auction_end_date,
-  };
+std::optional<model::Lot> LotRepository::cacheFirstLot(const LotCache::Ticket& ticket, const std::string& statement,
+                                                       const PGresult* result) {
+  auto lot = firstLot(statement, result);
+  if (cache_ && lot) {
+    cache_->put(ticket, *lot, readVersion(result));
+  }
+  return lot;
+}
 
-  auto result = database_.executePrepared("lot_insert", params);
-  if (PQntuples(result.get()) == 0) {
-    throw std::runtime_error("Failed to insert lot");
+core::Task<std::optional<model::Lot>> LotRepository::findByIdTask(int id) {
+  if (cache_) {
+    if (auto lot = cache_->get(id)) {
+      co_return lot;
+    }
   }
+  co_return co_await findFreshByIdTask(id);
+}
 
-  return mapLot(result.get(), 0);
+core::Task<std::optional<model::Lot>> LotRepository::findFreshByIdTask(int id) {
+  prepareStatements();
+  const auto ticket = cacheTicket(id);
+  std::vector<std::optional<std::string>> params{std::to_string(id)};
+  auto result = co_await database_.executePreparedTask("lot_select_by_id", std::move(params));
+  co_return cacheFirstLot(ticket, "lot_select_by_id", result.get());
 }
 
-std::optional<model::Lot> LotRepository::update(int id, const model::Lot& lot) {
+// Новый лот в кэш не кладётся: id известен только после INSERT, и тикет до запроса взять не из чего.
+// Кэш заполнит первое чтение
+core::Task<model::Lot> LotRepository::createTask(model::Lot lot) {
   prepareStatements();
+  auto result = co_await database_.executePreparedTask("lot_insert", lotParams(lot));
+  co_return requireInserted(firstLot("lot_insert", result.get()));
+}
 
-  std::vector<std::optional<std::string>> params = {
-      std::to_string(id),
-      lot.name,
-      lot.description,
-      std::to_string(lot.start_price),
-      lot.current_price ? std::optional<std::string>{std::to_string(*lot.current_price)} : std::nullopt,
-      lot.owner_id,
-      lot.auction_end_date,
-  };
+core::Task<std::optional<model::Lot>> LotRepository::updateTask(int id, model::Lot lot) {
+  prepareStatements();
+  const auto ticket = cacheTicket(id);
+  auto result = co_await database_.executePreparedTask("lot_update", lotParams(lot, id));
+  co_return cacheFirstLot(ticket, "lot_update", result.get());
+}
 
-  auto result = database_.executePrepared("lot_update", params);
-  if (PQntuples(result.get()) == 0) {
-    return std::nullopt;
+core::Task<bool> LotRepository::removeTask(int id) {
+  prepareStatements();
+  std::vector<std::optional<std::string>> params{std::to_string(id)};
+  auto result = co_await database_.executePreparedTask("lot_delete", std::move(params));
+  if (cache_) {
+    cache_->remove(id);
   }
-
-  return mapLot(result.get(), 0);
+  co_return affectedRows(result.get()) > 0;
 }
 
-bool LotRepository::remove(int id) {
+PersistedPrices LotRepository::persistCurrentPrices(const std::vector<std::pair<int, model::Money>>& prices) {
+  if (prices.empty()) {
+    return {};
+  }
   prepareStatements();
-  auto result = database_.executePrepared("lot_delete", {std::to_string(id)});
-  const char* affected = PQcmdTuples(result.get());
-  if (!affected) {
-    return false;
+
+  // Весь пакет — один pipeline: один round trip и одна транзакция
+  std::vector<core::PipelineStep> steps;
+  steps.reserve(prices.size());
+  for (const auto& [id, amount] : prices) {
+    steps.push_back(core::PipelineStep{
+        .statement = "lot_persist_price", .params = {std::to_string(id), amount.toString()}, .prepared = true,
+        .idempotent = true});
+  }
+  const auto results = database_.executePipeline(steps);
+
+  // Новые версии строк придут уведомлением; до тех пор в кэше не должно остаться старых цен
+  if (cache_) {
+    for (const auto& [id, amount] : prices) {
+      cache_->remove(id);
+    }
+  }
+
+  // Результаты в текстовом формате (kPersistPrice): булевы колонки приходят как "t"/"f"
+  auto flag = [](const PGresult* result, const char* column) {
+    return PQgetvalue(result, 0, requireColumn(result, column))[0] == 't';
+  };
+  PersistedPrices outcome;
+  for (std::size_t i = 0; i < prices.size(); ++i) {
+    const PGresult* result = results[i].get();
+    if (flag(result, "persisted")) {
+      continue;
+    }
+    (flag(result, "found") ? outcome.outdated : outcome.missing).push_back(prices[i].first);
   }
-  return std::stoi(affected) > 0;
+  return outcome;
 }
 
-std::optional<model::Lot> LotRepository::updateCurrentPrice(int id, double bidAmount) {
+core::Task<BidResult> LotRepository::placeBidTask(int id, model::Money bidAmount) {
   prepareStatements();
-  auto result = database_.executePrepared("lot_update_bid", {std::to_string(id), std::to_string(bidAmount)});
-  if (PQntuples(result.get()) == 0) {
-    return std::nullopt;
+  const auto ticket = cacheTicket(id);
+  std::vector<std::optional<std::string>> params{std::to_string(id), bidAmount.toString()};
+  auto result = co_await database_.executePreparedTask("lot_place_bid", std::move(params));
+  co_return toBidResult(ticket, result.get());
+}
+
+BidResult LotRepository::toBidResult(const LotCache::Ticket& ticket, const PGresult* result) {
+  // И принятая, и отклонённая ставка возвращают актуальную строку лота — она годится для кэша
+  BidResult outcome;
+  outcome.lot = cacheFirstLot(ticket, "lot_place_bid", result);
+  if (!outcome.lot) {
+    return outcome;
+  }
+
+  const int rejection = PQfnumber(result, "rejection");
+  if (PQgetisnull(result, 0, rejection)) {
+    outcome.status = BidResult::Status::Accepted;
+    return outcome;
   }
 
-  return mapLot(result.get(), 0);
+  const std::string_view reason{PQgetvalue(result, 0, rejection),
+                                static_cast<std::size_t>(PQgetlength(result, 0, rejection))};
+  if (reason == "bid_too_low") {
+    outcome.status = BidResult::Status::BidTooLow;
+  } else if (reason == "auction_ended") {
+    outcome.status = BidResult::Status::AuctionEnded;
+  } else {
+    outcome.status = BidResult::Status::Outbid;
+  }
+  return outcome;
 }
 
 }  // namespace auction::repository
-
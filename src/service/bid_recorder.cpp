@@ -0,0 +1,106 @@
+#include "auction/service/bid_recorder.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "auction/core/env.h"
+#include "auction/core/logger.h"
+
+namespace auction::service {
+
+BidRecorderOptions BidRecorderOptions::fromEnvironment() {
+  BidRecorderOptions options;
+  options.maxBatch = std::max<std::size_t>(core::envSize("BID_HISTORY_BATCH", options.maxBatch), 1);
+  options.flushInterval = std::chrono::milliseconds{
+      core::envSize("BID_HISTORY_FLUSH_MS", static_cast<std::size_t>(options.flushInterval.count()))};
+  options.maxBuffered = std::max(core::envSize("BID_HISTORY_MAX_BUFFERED", options.maxBuffered), options.maxBatch);
+  return options;
+}
+
+BidRecorder::BidRecorder(repository::BidRepository& repository, BidRecorderOptions options)
+    : repository_(repository), options_(options) {
+  flusher_ = std::thread([this] { run(); });
+}
+
+BidRecorder::~BidRecorder() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wakeup_.notify_all();
+  if (flusher_.joinable()) {
+    flusher_.join();
+  }
+}
+
+void BidRecorder::record(model::Bid bid) {
+  bool full = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (buffer_.size() >= options_.maxBuffered) {
+      buffer_.pop_front();
+      ++dropped_;
+    }
+    buffer_.push_back(std::move(bid));
+    full = buffer_.size() >= options_.maxBatch;
+  }
+  if (full) {
+    wakeup_.notify_one();
+  }
+}
+
+void BidRecorder::run() {
+  std::vector<model::Bid> batch;
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    wakeup_.wait_for(lock, options_.flushInterval,
+                     [this] { return stopping_ || buffer_.size() >= options_.maxBatch; });
+    if (buffer_.empty()) {
+      if (stopping_) {
+        return;
+      }
+      continue;
+    }
+
+    const auto count = std::min(buffer_.size(), options_.maxBatch);
+    batch.assign(std::make_move_iterator(buffer_.begin()),
+                 std::make_move_iterator(buffer_.begin() + static_cast<std::ptrdiff_t>(count)));
+    buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(count));
+    const auto dropped = std::exchange(dropped_, 0);
+    lock.unlock();
+
+    if (dropped > 0) {
+      AUCTION_LOG_WARN("Bid history buffer is full, dropped oldest records").field("count", dropped);
+    }
+
+    bool written = true;
+    try {
+      repository_.insertBatch(batch);
+    } catch (const std::exception& ex) {
+      written = false;
+      AUCTION_LOG_ERROR("Failed to write bid history").field("count", batch.size()).field("error", ex.what());
+    }
+
+    lock.lock();
+    if (!written) {
+      if (stopping_) {
+        // При остановке повторять некуда — не зацикливаемся на недоступной БД
+        AUCTION_LOG_ERROR("Dropping unsaved bid history").field("count", buffer_.size() + batch.size());
+        return;
+      }
+      // Возвращаем пакет в начало буфера и пробуем на следующем тике
+      buffer_.insert(buffer_.begin(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+      if (buffer_.size() > options_.maxBuffered) {
+        const auto excess = buffer_.size() - options_.maxBuffered;
+        buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(excess));
+        dropped_ += excess;
+      }
+      wakeup_.wait_for(lock, options_.flushInterval, [this] { return stopping_; });
+    }
+    batch.clear();
+  }
+}
+
+}  // namespace auction::service
@@ -0,0 +1,320 @@
+#include "auction/service/bidding_engine.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+#include "auction/core/concurrency_limiter.h"
+#include "auction/core/env.h"
+#include "auction/core/executor.h"
+#include "auction/core/logger.h"
+#include "auction/service/lot_service.h"
+
+namespace auction::service {
+
+namespace {
+
+// Цена только растёт, поэтому из двух известных берём большую
+std::optional<model::Money> higherPrice(std::optional<model::Money> left, std::optional<model::Money> right) {
+  if (!left) {
+    return right;
+  }
+  if (!right) {
+    return left;
+  }
+  return std::max(*left, *right);
+}
+
+}  // namespace
+
+BiddingEngineOptions BiddingEngineOptions::fromEnvironment() {
+  BiddingEngineOptions options;
+  options.shards = core::envSize("BIDDING_ENGINE_SHARDS", options.shards);
+  options.maxBatch = std::max<std::size_t>(core::envSize("BIDDING_ENGINE_BATCH", options.maxBatch), 1);
+  options.flushInterval = std::chrono::milliseconds{
+      core::envSize("BIDDING_ENGINE_FLUSH_MS", static_cast<std::size_t>(options.flushInterval.count()))};
+  if (auto durability = core::readEnv("BIDDING_ENGINE_DURABILITY"); durability && *durability == "accepted") {
+    options.durability = DurabilityMode::Accepted;
+  }
+  return options;
+}
+
+BiddingEngine::BiddingEngine(repository::LotRepository& repository, BiddingEngineOptions options)
+    : repository_(repository), options_(options) {
+  if (options_.shards == 0) {
+    options_.shards = std::max(1U, std::thread::hardware_concurrency());
+  }
+
+  shards_.reserve(options_.shards);
+  for (std::size_t i = 0; i < options_.shards; ++i) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+  for (auto& shard : shards_) {
+    shard->worker = std::thread([this, &shard = *shard] { runShard(shard); });
+  }
+  writer_ = std::thread([this] { runWriter(); });
+
+  AUCTION_LOG_INFO("Bidding engine started")
+      .field("shards", options_.shards)
+      .field("durability", options_.durability == DurabilityMode::Persisted ? "persisted" : "accepted");
+}
+
+BiddingEngine::~BiddingEngine() {
+  // Сначала останавливаем шарды (они дорабатывают свои очереди), затем сбрасываем хвост write-behind
+  for (auto& shard : shards_) {
+    {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      shard->stopping = true;
+    }
+    shard->wakeup.notify_all();
+  }
+  for (auto& shard : shards_) {
+    if (shard->worker.joinable()) {
+      shard->worker.join();
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    writerStopping_ = true;
+  }
+  writeWakeup_.notify_all();
+  if (writer_.joinable()) {
+    writer_.join();
+  }
+}
+
+BiddingEngine::Shard& BiddingEngine::shardFor(int id) {
+  return *shards_[static_cast<std::size_t>(id) % shards_.size()];
+}
+
+void BiddingEngine::enqueue(Shard& shard, Command command) {
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.queue.push_back(std::move(command));
+  }
+  shard.wakeup.notify_one();
+}
+
+core::Task<model::Lot> BiddingEngine::placeBidTask(int id, model::Money bidAmount) {
+  std::optional<model::Lot> loaded;
+  std::uint64_t generation = 0;
+  for (;;) {
+    auto outcome = co_await core::Executor::callback<Outcome>([&](auto resume) {
+      enqueue(shardFor(id), Command{Command::Kind::Bid, id, bidAmount, std::move(loaded), generation,
+                                    std::move(resume)});
+    });
+    if (outcome.lot) {
+      co_return std::move(*outcome.lot);
+    }
+
+    // Шард не знает лот: загружаем его здесь, не занимая поток шарда, и повторяем ставку
+    generation = outcome.generation;
+    loaded = co_await repository_.findFreshByIdTask(id);
+    if (!loaded) {
+      throw BidRejected("lot_not_found", "Lot not found");
+    }
+  }
+}
+
+core::Task<model::Lot> BiddingEngine::overlayTask(model::Lot lot) {
+  const int id = lot.id;
+  auto outcome = co_await core::Executor::callback<Outcome>([&](auto resume) {
+    enqueue(shardFor(id), Command{Command::Kind::Overlay, id, model::Money{}, std::move(lot), 0, std::move(resume)});
+  });
+  co_return std::move(*outcome.lot);
+}
+
+core::Task<model::Lot> BiddingEngine::updateTask(model::Lot lot) {
+  const int id = lot.id;
+  auto outcome = co_await core::Executor::callback<Outcome>([&](auto resume) {
+    enqueue(shardFor(id), Command{Command::Kind::Update, id, model::Money{}, std::move(lot), 0, std::move(resume)});
+  });
+  co_return std::move(*outcome.lot);
+}
+
+void BiddingEngine::invalidate(int id) {
+  enqueue(shardFor(id), Command{Command::Kind::Invalidate, id, model::Money{}, std::nullopt, 0, {}});
+}
+
+void BiddingEngine::runShard(Shard& shard) {
+  std::deque<Command> batch;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(shard.mutex);
+      shard.wakeup.wait(lock, [&shard] { return shard.stopping || !shard.queue.empty(); });
+      if (shard.queue.empty() && shard.stopping) {
+        return;
+      }
+      batch.swap(shard.queue);
+    }
+
+    for (auto& command : batch) {
+      try {
+        handleCommand(shard, command);
+      } catch (...) {
+        if (command.reply) {
+          command.reply(std::current_exception(), Outcome{});
+        }
+      }
+    }
+    batch.clear();
+  }
+}
+
+void BiddingEngine::handleCommand(Shard& shard, Command& command) {
+  switch (command.kind) {
+    case Command::Kind::Bid:
+      handleBid(shard, command);
+      return;
+    case Command::Kind::Overlay: {
+      auto lot = std::move(*command.lot);
+      if (auto it = shard.lots.find(command.id); it != shard.lots.end()) {
+        lot.current_price = higherPrice(lot.current_price, it->second.current_price);
+      }
+      command.reply(nullptr, Outcome{std::move(lot), shard.generation});
+      return;
+    }
+    case Command::Kind::Update: {
+      ++shard.generation;
+      auto lot = std::move(*command.lot);
+      if (auto it = shard.lots.find(command.id); it != shard.lots.end()) {
+        lot.current_price = higherPrice(lot.current_price, it->second.current_price);
+        it->second = lot;
+      }
+      command.reply(nullptr, Outcome{std::move(lot), shard.generation});
+      return;
+    }
+    case Command::Kind::Invalidate:
+      ++shard.generation;
+      shard.lots.erase(command.id);
+      return;
+  }
+}
+
+void BiddingEngine::handleBid(Shard& shard, Command& command) {
+  auto it = shard.lots.find(command.id);
+  if (it == shard.lots.end()) {
+    // Первая ставка на лот: его загружает вызывающая корутина, дальше цена живёт в памяти шарда.
+    // Лот, загруженный до изменения в обход движка, мог устареть — пусть загрузят заново
+    if (!command.lot || command.generation != shard.generation) {
+      command.reply(nullptr, Outcome{std::nullopt, shard.generation});
+      return;
+    }
+    it = shard.lots.emplace(command.id, std::move(*command.lot)).first;
+  }
+
+  auto& lot = it->second;
+  const model::Money currentPrice = lot.current_price.value_or(lot.start_price);
+  if (command.amount <= lot.start_price || command.amount <= currentPrice) {
+    throw BidRejected("bid_too_low", "Bid must be greater than current and starting price");
+  }
+
+  if (lot.auction_end_date && std::chrono::system_clock::now() >= *lot.auction_end_date) {
+    // Завершённый аукцион больше не нужен в памяти
+    shard.lots.erase(it);
+    throw BidRejected("auction_ended", "Auction already ended");
+  }
+
+  lot.current_price = command.amount;
+
+  PendingWrite write{command.id, command.amount, lot, nullptr};
+  if (options_.durability == DurabilityMode::Persisted) {
+    write.reply = std::move(command.reply);
+  } else {
+    command.reply(nullptr, Outcome{lot, shard.generation});
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    pendingWrites_.push_back(std::move(write));
+    if (pendingWrites_.size() < options_.maxBatch) {
+      return;
+    }
+  }
+  writeWakeup_.notify_one();
+}
+
+void BiddingEngine::runWriter() {
+  std::vector<PendingWrite> batch;
+  std::unique_lock<std::mutex> lock(writeMutex_);
+  for (;;) {
+    writeWakeup_.wait_for(lock, options_.flushInterval, [this] {
+      return writerStopping_ || pendingWrites_.size() >= options_.maxBatch;
+    });
+    if (pendingWrites_.empty()) {
+      if (writerStopping_) {
+        return;
+      }
+      continue;
+    }
+
+    batch.swap(pendingWrites_);
+    lock.unlock();
+    flush(batch);
+    batch.clear();
+    lock.lock();
+  }
+}
+
+void BiddingEngine::flush(std::vector<PendingWrite>& batch) {
+  // Внутри шарда ставки на лот принимаются по возрастанию, поэтому достаточно последней цены по каждому лоту
+  std::unordered_map<int, model::Money> latest;
+  for (const auto& write : batch) {
+    latest[write.id] = write.amount;
+  }
+  std::vector<std::pair<int, model::Money>> prices(latest.begin(), latest.end());
+
+  repository::PersistedPrices rejected;
+  try {
+    rejected = repository_.persistCurrentPrices(prices);
+  } catch (const std::exception& ex) {
+    AUCTION_LOG_ERROR("Bidding engine write-behind failed").field("lots", prices.size()).field("error", ex.what());
+    // Память разошлась с БД: забываем лоты, следующая ставка перечитает фактическое состояние
+    for (const auto& [id, amount] : prices) {
+      invalidate(id);
+    }
+    // Отказ ограничителя нагрузки доходит до клиента как есть: на него отвечают 503 с Retry-After
+    const auto error = dynamic_cast<const core::Overloaded*>(&ex) != nullptr
+                           ? std::current_exception()
+                           : std::make_exception_ptr(BidNotPersisted("Failed to persist bid"));
+    for (auto& write : batch) {
+      if (write.reply) {
+        write.reply(error, Outcome{});
+      }
+    }
+    return;
+  }
+
+  // Строка не обновилась: лот удалён или в БД уже цена выше — ставка не записана, память разошлась с БД
+  const std::unordered_set<int> missing(rejected.missing.begin(), rejected.missing.end());
+  const std::unordered_set<int> outdated(rejected.outdated.begin(), rejected.outdated.end());
+  if (!missing.empty() || !outdated.empty()) {
+    AUCTION_LOG_WARN("Bidding engine write-behind skipped stale lots")
+        .field("deleted", missing.size())
+        .field("overtaken", outdated.size());
+    for (const int id : missing) {
+      invalidate(id);
+    }
+    for (const int id : outdated) {
+      invalidate(id);
+    }
+  }
+  for (auto& write : batch) {
+    if (!write.reply) {
+      continue;
+    }
+    if (missing.contains(write.id)) {
+      write.reply(std::make_exception_ptr(BidRejected("lot_not_found", "Lot not found")), Outcome{});
+    } else if (outdated.contains(write.id)) {
+      write.reply(std::make_exception_ptr(BidRejected("bid_too_low", "Bid was overtaken before it was persisted")),
+                  Outcome{});
+    } else {
+      write.reply(nullptr, Outcome{std::move(write.lot), 0});
+    }
+  }
+}
+
+}  // namespace auction::service
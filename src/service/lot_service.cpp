@@ -1,184 +1,149 @@
 #include "auction/service/lot_service.h"
 
-#include <algorithm>
 #include <chrono>
-#include <iomanip>
-#include <sstream>
 #include <stdexcept>
+#include <utility>
 
-namespace {
-
-std::optional<std::chrono::system_clock::time_point> parseTimestamp(const std::optional<std::string>& value) {
-  if (!value || value->empty()) {
-    return std::nullopt;
-  }
+#include "auction/service/bidding_engine.h"
 
-  std::string input = *value;
-  std::replace(input.begin(), input.end(), 'T', ' ');
+namespace {
 
-  bool hasOffset = false;
-  int offsetMinutes = 0;
+constexpr std::size_t kMaxPageSize = 1000;
 
-  // Handle trailing 'Z'
-  if (!input.empty() && (input.back() == 'Z' || input.back() == 'z')) {
-    hasOffset = true;
-    input.pop_back();
+void requirePageLimit(std::size_t limit) {
+  if (limit == 0 || limit > kMaxPageSize) {
+    throw std::invalid_argument("limit must be between 1 and " + std::to_string(kMaxPageSize));
   }
+}
 
-  const auto spacePos = input.find(' ');
-  if (spacePos != std::string::npos) {
-    std::size_t offsetPos = std::string::npos;
-    for (std::size_t i = spacePos + 1; i < input.size(); ++i) {
-      if (input[i] == '+' || input[i] == '-') {
-        offsetPos = i;
-        break;
-      }
-    }
-
-    if (offsetPos != std::string::npos) {
-      hasOffset = true;
-      std::string offsetStr = input.substr(offsetPos);
-      input = input.substr(0, offsetPos);
-
-      try {
-        if (offsetStr.size() >= 3) {
-          const int sign = offsetStr[0] == '-' ? -1 : 1;
-          std::string hoursPart;
-          std::string minutesPart = "0";
-
-          auto colonPos = offsetStr.find(':');
-          if (colonPos != std::string::npos) {
-            hoursPart = offsetStr.substr(1, colonPos - 1);
-            minutesPart = offsetStr.substr(colonPos + 1);
-          } else {
-            hoursPart = offsetStr.substr(1, 2);
-            if (offsetStr.size() >= 5) {
-              minutesPart = offsetStr.substr(3, 2);
-            }
-          }
-
-          offsetMinutes = sign * (std::stoi(hoursPart) * 60 + std::stoi(minutesPart));
-        }
-      } catch (const std::exception&) {
-        return std::nullopt;
-      }
-    }
+void requireLotId(int id) {
+  if (id <= 0) {
+    throw std::invalid_argument("Invalid lot id");
   }
+}
 
-  std::tm tm = {};
-  std::istringstream stream(input);
-
-  if (!(stream >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S"))) {
-    stream.clear();
-    stream.str(input);
-    if (!(stream >> std::get_time(&tm, "%Y-%m-%d %H:%M"))) {
-      stream.clear();
-      stream.str(input);
-      if (!(stream >> std::get_time(&tm, "%Y-%m-%d"))) {
-        return std::nullopt;
-      }
-    }
+void requireNewLot(const auction::model::Lot& lot) {
+  if (lot.name.empty()) {
+    throw std::invalid_argument("Lot name is required");
   }
-
-  using namespace std::chrono;
-
-  const auto year = std::chrono::year{tm.tm_year + 1900};
-  const auto month = std::chrono::month{static_cast<unsigned>(tm.tm_mon + 1)};
-  const auto day = std::chrono::day{static_cast<unsigned>(tm.tm_mday)};
-
-  if (!year.ok() || !month.ok() || !day.ok()) {
-    return std::nullopt;
+  if (lot.start_price <= auction::model::Money{}) {
+    throw std::invalid_argument("start_price must be positive");
   }
+}
 
-  sys_days date{year / month / day};
-  auto timePoint = date + hours{tm.tm_hour} + minutes{tm.tm_min} + seconds{tm.tm_sec};
-
-  if (hasOffset && offsetMinutes != 0) {
-    timePoint -= minutes{offsetMinutes};
+void requireBid(int id, auction::model::Money bidAmount) {
+  requireLotId(id);
+  if (bidAmount <= auction::model::Money{}) {
+    throw std::invalid_argument("Bid amount must be positive");
   }
-
-  return timePoint;
 }
 
 }  // namespace
 
 namespace auction::service {
 
-LotService::LotService(repository::LotRepository& repository) : repository_(repository) {
+LotService::LotService(repository::LotRepository& repository, repository::BidRepository& bidRepository,
+                       BidRecorder& bidRecorder, BiddingEngine* engine)
+    : repository_(repository), bidRepository_(bidRepository), bidRecorder_(bidRecorder), engine_(engine) {
   repository_.ensureSchema();
+  bidRepository_.ensureSchema();
 }
 
-std::vector<model::Lot> LotService::listLots() {
-  return repository_.list();
+std::optional<repository::LotCacheStats> LotService::lotCacheStats() const {
+  return repository_.cacheStats();
 }
 
-std::optional<model::Lot> LotService::getLot(int id) {
-  if (id <= 0) {
-    throw std::invalid_argument("Invalid lot id");
-  }
-
-  return repository_.findById(id);
+core::Task<repository::LotPage> LotService::listLotsPageTask(std::size_t limit, std::optional<std::string> after) {
+  requirePageLimit(limit);
+  co_return co_await repository_.listPageTask(limit, std::move(after));
 }
 
-model::Lot LotService::createLot(const model::Lot& lot) {
-  if (lot.name.empty()) {
-    throw std::invalid_argument("Lot name is required");
-  }
-  if (lot.start_price <= 0) {
-    throw std::invalid_argument("start_price must be positive");
-  }
-
-  return repository_.create(lot);
+core::Task<repository::LotRepository::Stream> LotService::openLotStreamTask() {
+  co_return co_await repository_.openStreamTask();
 }
 
-std::optional<model::Lot> LotService::updateLot(int id, const model::Lot& lot) {
-  if (id <= 0) {
-    throw std::invalid_argument("Invalid lot id");
+core::Task<std::optional<model::Lot>> LotService::getLotTask(int id) {
+  requireLotId(id);
+  auto lot = co_await repository_.findByIdTask(id);
+  // Принятые движком ставки попадают в БД с задержкой: цену берём из памяти шарда
+  if (lot && engine_) {
+    lot = co_await engine_->overlayTask(std::move(*lot));
   }
+  co_return lot;
+}
 
-  return repository_.update(id, lot);
+core::Task<model::Lot> LotService::createLotTask(model::Lot lot) {
+  requireNewLot(lot);
+  co_return co_await repository_.createTask(std::move(lot));
 }
 
-bool LotService::deleteLot(int id) {
-  if (id <= 0) {
-    throw std::invalid_argument("Invalid lot id");
+core::Task<std::optional<model::Lot>> LotService::updateLotTask(int id, model::Lot lot) {
+  requireLotId(id);
+  auto updated = co_await repository_.updateTask(id, std::move(lot));
+  // Не invalidate: шард перечитал бы из БД цену без ещё не записанных ставок
+  if (updated && engine_) {
+    updated = co_await engine_->updateTask(std::move(*updated));
   }
-
-  return repository_.remove(id);
+  co_return updated;
 }
 
-model::Lot LotService::placeBid(int id, double bidAmount) {
-  if (id <= 0) {
-    throw std::invalid_argument("Invalid lot id");
-  }
-  if (bidAmount <= 0) {
-    throw std::invalid_argument("Bid amount must be positive");
+core::Task<bool> LotService::deleteLotTask(int id) {
+  requireLotId(id);
+  const bool removed = co_await repository_.removeTask(id);
+  if (engine_) {
+    engine_->invalidate(id);
   }
+  co_return removed;
+}
 
-  auto lotOpt = repository_.findById(id);
-  if (!lotOpt.has_value()) {
-    throw std::runtime_error("Lot not found");
+core::Task<model::Lot> LotService::placeBidTask(int id, model::Money bidAmount, std::optional<std::string> bidderId) {
+  requireBid(id, bidAmount);
+  model::Lot lot;
+  if (engine_) {
+    lot = co_await engine_->placeBidTask(id, bidAmount);
+  } else {
+    lot = bidOutcome(co_await repository_.placeBidTask(id, bidAmount));
   }
+  recordBid(id, bidAmount, bidderId);
+  co_return lot;
+}
 
-  auto lot = lotOpt.value();
-
-  const double currentPrice = lot.current_price.value_or(lot.start_price);
-  if (bidAmount <= lot.start_price || bidAmount <= currentPrice) {
-    throw std::runtime_error("Bid must be greater than current and starting price");
+core::Task<std::optional<repository::BidPage>> LotService::listBidsTask(int lotId, std::size_t limit,
+                                                                       std::optional<std::string> after) {
+  requireLotId(lotId);
+  requirePageLimit(limit);
+  // Проверка через findByIdTask обычно попадает в кэш лотов и не стоит лишнего запроса
+  if (!co_await repository_.findByIdTask(lotId)) {
+    co_return std::nullopt;
   }
+  co_return co_await bidRepository_.listByLotTask(lotId, limit, std::move(after));
+}
 
-  if (auto auctionEnd = parseTimestamp(lot.auction_end_date)) {
-    if (std::chrono::system_clock::now() >= *auctionEnd) {
-      throw std::runtime_error("Auction already ended");
-    }
-  }
+void LotService::recordBid(int id, model::Money bidAmount, const std::optional<std::string>& bidderId) {
+  // История пишется асинхронно пакетами; время ставки фиксируем в момент принятия
+  bidRecorder_.record(model::Bid{
+      .id = 0,
+      .lot_id = id,
+      .amount = bidAmount,
+      .bidder_id = bidderId,
+      .created_at = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::system_clock::now()),
+  });
+}
 
-  auto updated = repository_.updateCurrentPrice(id, bidAmount);
-  if (!updated.has_value()) {
-    throw std::runtime_error("Failed to place bid");
+model::Lot LotService::bidOutcome(repository::BidResult result) {
+  switch (result.status) {
+    case repository::BidResult::Status::Accepted:
+      return std::move(*result.lot);
+    case repository::BidResult::Status::NotFound:
+      throw BidRejected("lot_not_found", "Lot not found");
+    case repository::BidResult::Status::BidTooLow:
+    case repository::BidResult::Status::Outbid:
+      throw BidRejected("bid_too_low", "Bid must be greater than current and starting price");
+    case repository::BidResult::Status::AuctionEnded:
+      throw BidRejected("auction_ended", "Auction already ended");
   }
 
-  return updated.value();
+  throw std::runtime_error("Failed to place bid");
 }
 
 }  // namespace auction::service
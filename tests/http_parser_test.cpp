@@ -0,0 +1,142 @@
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "auction/api/http_parser.h"
+
+namespace {
+
+using auction::api::HttpRequestParser;
+using Status = HttpRequestParser::Status;
+
+// Буфер соединения, как в EventLoopServer: данные дописываются в конец, поглощённые байты выбрасываются
+class Connection {
+ public:
+  Status feed(std::string_view data) {
+    buffer_.append(data);
+    std::size_t consumed = 0;
+    const auto status = parser.parse(buffer_, consumed);
+    buffer_.erase(0, consumed);
+    return status;
+  }
+
+  // Подаёт data порциями по step байт, пока парсеру нужны данные
+  Status feedBy(std::string_view data, std::size_t step) {
+    auto status = Status::NeedMore;
+    for (std::size_t offset = 0; offset < data.size() && status == Status::NeedMore; offset += step) {
+      status = feed(data.substr(offset, step));
+    }
+    return status;
+  }
+
+  [[nodiscard]] const std::string& buffer() const { return buffer_; }
+
+  HttpRequestParser parser;
+
+ private:
+  std::string buffer_;
+};
+
+void expectRejected(std::string_view request) {
+  Connection connection;
+  EXPECT_EQ(connection.feed(request), Status::Error);
+  EXPECT_EQ(connection.parser.errorStatus(), 400);
+  EXPECT_FALSE(connection.parser.keepAlive());
+}
+
+TEST(HttpRequestParserTest, ParsesRequestWithoutBody) {
+  Connection connection;
+  ASSERT_EQ(connection.feed("GET /lots?limit=10 HTTP/1.1\r\nHost: localhost\r\n\r\n"), Status::Complete);
+  EXPECT_TRUE(connection.parser.keepAlive());
+
+  const auto request = connection.parser.take();
+  EXPECT_EQ(request.method, "GET");
+  EXPECT_EQ(request.path, "/lots");
+  EXPECT_EQ(request.get_param_value("limit"), "10");
+  EXPECT_EQ(request.get_header_value("Host"), "localhost");
+  EXPECT_TRUE(request.body.empty());
+}
+
+TEST(HttpRequestParserTest, ParsesContentLengthBodySplitByteByByte) {
+  const std::string request =
+      "POST /lots HTTP/1.1\r\nHost: localhost\r\nContent-Length: 13\r\n\r\n{\"name\":\"a\"}\n";
+  Connection connection;
+  ASSERT_EQ(connection.feedBy(request, 1), Status::Complete);
+  EXPECT_EQ(connection.parser.take().body, "{\"name\":\"a\"}\n");
+  EXPECT_TRUE(connection.buffer().empty());
+}
+
+TEST(HttpRequestParserTest, FindsHeaderEndSplitAcrossReads) {
+  Connection connection;
+  EXPECT_EQ(connection.feed("GET /health HTTP/1.1\r\nHost: localhost\r\n\r"), Status::NeedMore);
+  ASSERT_EQ(connection.feed("\n"), Status::Complete);
+  EXPECT_EQ(connection.parser.take().path, "/health");
+}
+
+TEST(HttpRequestParserTest, ParsesChunkedBodySplitAcrossReads) {
+  const std::string request =
+      "POST /lots HTTP/1.1\r\nHost: localhost\r\nTransfer-Encoding: chunked\r\n\r\n"
+      "5\r\nhello\r\n7;ext=1\r\n, world\r\n0\r\nX-Trailer: 1\r\n\r\n";
+  for (const std::size_t step : {1, 2, 3, 7}) {
+    Connection connection;
+    ASSERT_EQ(connection.feedBy(request, step), Status::Complete) << "step " << step;
+    EXPECT_EQ(connection.parser.take().body, "hello, world") << "step " << step;
+  }
+}
+
+TEST(HttpRequestParserTest, ParsesPipelinedRequestsOneByOne) {
+  Connection connection;
+  ASSERT_EQ(connection.feed("GET /a HTTP/1.1\r\n\r\nPOST /b HTTP/1.1\r\nContent-Length: 2\r\n\r\nok"),
+            Status::Complete);
+  EXPECT_EQ(connection.parser.take().path, "/a");
+
+  ASSERT_EQ(connection.feed(""), Status::Complete);
+  const auto second = connection.parser.take();
+  EXPECT_EQ(second.path, "/b");
+  EXPECT_EQ(second.body, "ok");
+  EXPECT_TRUE(connection.buffer().empty());
+}
+
+TEST(HttpRequestParserTest, RejectsDuplicateContentLength) {
+  expectRejected("POST /lots HTTP/1.1\r\nContent-Length: 2\r\nContent-Length: 2\r\n\r\nok");
+}
+
+TEST(HttpRequestParserTest, RejectsConflictingContentLength) {
+  expectRejected("POST /lots HTTP/1.1\r\nContent-Length: 2\r\nContent-Length: 10\r\n\r\nok");
+}
+
+TEST(HttpRequestParserTest, RejectsDuplicateContentLengthInAnyCase) {
+  expectRejected("POST /lots HTTP/1.1\r\ncontent-length: 2\r\nContent-Length: 2\r\n\r\nok");
+}
+
+TEST(HttpRequestParserTest, RejectsContentLengthList) {
+  expectRejected("POST /lots HTTP/1.1\r\nContent-Length: 2, 2\r\n\r\nok");
+}
+
+TEST(HttpRequestParserTest, RejectsContentLengthWithTransferEncoding) {
+  expectRejected("POST /lots HTTP/1.1\r\nContent-Length: 2\r\nTransfer-Encoding: chunked\r\n\r\n0\r\n\r\n");
+  expectRejected("POST /lots HTTP/1.1\r\nTransfer-Encoding: chunked\r\nContent-Length: 2\r\n\r\n0\r\n\r\n");
+}
+
+TEST(HttpRequestParserTest, RejectsDuplicateTransferEncoding) {
+  expectRejected("POST /lots HTTP/1.1\r\nTransfer-Encoding: chunked\r\nTransfer-Encoding: chunked\r\n\r\n0\r\n\r\n");
+}
+
+TEST(HttpRequestParserTest, RejectsSmugglingHeadersSplitAcrossReads) {
+  const std::string request = "POST /lots HTTP/1.1\r\nContent-Length: 2\r\nContent-Length: 10\r\n\r\nok";
+  Connection connection;
+  EXPECT_EQ(connection.feedBy(request, 1), Status::Error);
+  EXPECT_EQ(connection.parser.errorStatus(), 400);
+  EXPECT_FALSE(connection.parser.keepAlive());
+}
+
+TEST(HttpRequestParserTest, StaysFailedAfterError) {
+  Connection connection;
+  ASSERT_EQ(connection.feed("POST /lots HTTP/1.1\r\nContent-Length: 2\r\nContent-Length: 3\r\n\r\n"), Status::Error);
+  EXPECT_EQ(connection.feed("GET / HTTP/1.1\r\n\r\n"), Status::Error);
+}
+
+}  // namespace
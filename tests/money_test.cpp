@@ -0,0 +1,92 @@
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include "auction/model/money.h"
+
+namespace {
+
+using auction::model::Money;
+
+std::optional<std::int64_t> parseMinor(const std::string& text) {
+  const auto money = Money::parse(text);
+  return money ? std::optional<std::int64_t>{money->minorUnits()} : std::nullopt;
+}
+
+TEST(MoneyParseTest, ParsesPlainDecimals) {
+  EXPECT_EQ(parseMinor("310.25"), 31025);
+  EXPECT_EQ(parseMinor("150"), 15000);
+  EXPECT_EQ(parseMinor("-1"), -100);
+  EXPECT_EQ(parseMinor("+5"), 500);
+  EXPECT_EQ(parseMinor(".5"), 50);
+  EXPECT_EQ(parseMinor("000123.40"), 12340);
+  EXPECT_EQ(parseMinor("0"), 0);
+  EXPECT_EQ(parseMinor("-0.00"), 0);
+}
+
+TEST(MoneyParseTest, RoundsHalfAwayFromZero) {
+  EXPECT_EQ(parseMinor("0.005"), 1);
+  EXPECT_EQ(parseMinor("1.005"), 101);
+  EXPECT_EQ(parseMinor("-1.005"), -101);
+  EXPECT_EQ(parseMinor("0.004"), 0);
+  EXPECT_EQ(parseMinor("1.0049999999"), 100);
+  EXPECT_EQ(parseMinor("0.995"), 100);
+  EXPECT_EQ(parseMinor("99.995"), 10000);
+  EXPECT_EQ(parseMinor("0.00000000000000000000000000000000000000005"), 0);
+}
+
+TEST(MoneyParseTest, AppliesExponent) {
+  EXPECT_EQ(parseMinor("1.5e2"), 15000);
+  EXPECT_EQ(parseMinor("1.5E+2"), 15000);
+  EXPECT_EQ(parseMinor("1e-2"), 1);
+  EXPECT_EQ(parseMinor("5e-3"), 1);
+  EXPECT_EQ(parseMinor("4e-3"), 0);
+  EXPECT_EQ(parseMinor("31025e-2"), 31025);
+  EXPECT_EQ(parseMinor("0.0001e4"), 100);
+  EXPECT_EQ(parseMinor("1e-400"), 0);
+}
+
+TEST(MoneyParseTest, RejectsOverflow) {
+  EXPECT_EQ(parseMinor("9999999999999999.99"), 999999999999999999);
+  EXPECT_EQ(parseMinor("10000000000000000"), std::nullopt);
+  EXPECT_EQ(parseMinor("-10000000000000000"), std::nullopt);
+  EXPECT_EQ(parseMinor("1e15"), 100000000000000000);
+  EXPECT_EQ(parseMinor("1e16"), std::nullopt);
+  EXPECT_EQ(parseMinor("1e99999999999999999999"), std::nullopt);
+  EXPECT_EQ(parseMinor("123456789012345678901234567890"), std::nullopt);
+}
+
+TEST(MoneyParseTest, RejectsMalformedText) {
+  for (const char* text : {"", "-", "+", ".", "1.", "abc", "1e", "1e+", "1e-", "1 ", " 1", "0x10", "1,5", "--1", "1..2"}) {
+    EXPECT_EQ(parseMinor(text), std::nullopt) << '"' << text << '"';
+  }
+}
+
+TEST(MoneyAppendDecimalTest, FormatsLikeJsonDump) {
+  auto expectSameAsDump = [](std::int64_t minor) {
+    const auto money = Money::fromMinorUnits(minor);
+    EXPECT_EQ(money.toString(), nlohmann::json(money.toDouble()).dump()) << minor;
+  };
+
+  for (std::int64_t minor = -100000; minor <= 100000; ++minor) {
+    expectSameAsDump(minor);
+  }
+  // До верхней границы NUMERIC(12,2) с шагом, перебирающим все остатки копеек
+  for (std::int64_t minor = 100000; minor <= 999999999999; minor += 999999937) {
+    expectSameAsDump(minor);
+    expectSameAsDump(-minor);
+  }
+  expectSameAsDump(999999999999);
+  expectSameAsDump(-999999999999);
+}
+
+TEST(MoneyAppendDecimalTest, RoundTripsThroughParse) {
+  for (const std::int64_t minor : {0LL, 1LL, 10LL, 99LL, 100LL, 27550LL, -31025LL, 999999999999LL}) {
+    EXPECT_EQ(parseMinor(Money::fromMinorUnits(minor).toString()), minor);
+  }
+}
+
+}  // namespace
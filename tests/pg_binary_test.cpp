@@ -0,0 +1,95 @@
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "auction/core/pg_binary.h"
+
+namespace {
+
+using auction::core::pg::readNumericScaled;
+
+constexpr std::uint16_t kPositive = 0x0000;
+constexpr std::uint16_t kNegative = 0x4000;
+constexpr std::uint16_t kNaN = 0xC000;
+
+void appendInt2(std::string& out, std::uint16_t value) {
+  out.push_back(static_cast<char>(value >> 8));
+  out.push_back(static_cast<char>(value & 0xFF));
+}
+
+// NUMERIC в бинарном формате: ndigits, weight, sign, dscale и цифры по основанию 10000
+std::string numeric(std::int16_t weight, std::uint16_t sign, std::int16_t dscale,
+                    std::initializer_list<std::uint16_t> digits) {
+  std::string out;
+  appendInt2(out, static_cast<std::uint16_t>(digits.size()));
+  appendInt2(out, static_cast<std::uint16_t>(weight));
+  appendInt2(out, sign);
+  appendInt2(out, static_cast<std::uint16_t>(dscale));
+  for (const auto digit : digits) {
+    appendInt2(out, digit);
+  }
+  return out;
+}
+
+std::int64_t readCents(const std::string& value) {
+  return readNumericScaled(value.data(), static_cast<int>(value.size()), 2);
+}
+
+TEST(ReadNumericScaledTest, ReadsExactValues) {
+  EXPECT_EQ(readCents(numeric(0, kPositive, 2, {310, 2500})), 31025);
+  EXPECT_EQ(readCents(numeric(0, kPositive, 0, {150})), 15000);
+  EXPECT_EQ(readCents(numeric(1, kPositive, 1, {1234, 5678, 9000})), 1234567890);
+  EXPECT_EQ(readCents(numeric(1, kPositive, 0, {10})), 10000000);
+  EXPECT_EQ(readCents(numeric(-1, kPositive, 2, {2500})), 25);
+  EXPECT_EQ(readCents(numeric(2, kPositive, 2, {99, 9999, 9999, 9900})), 999999999999);
+}
+
+TEST(ReadNumericScaledTest, ReadsZero) {
+  EXPECT_EQ(readCents(numeric(0, kPositive, 2, {})), 0);
+  EXPECT_EQ(readCents(numeric(0, kPositive, 0, {})), 0);
+}
+
+TEST(ReadNumericScaledTest, ReadsNegativeValues) {
+  EXPECT_EQ(readCents(numeric(0, kNegative, 2, {310, 2500})), -31025);
+  EXPECT_EQ(readCents(numeric(-1, kNegative, 2, {100})), -1);
+}
+
+TEST(ReadNumericScaledTest, RoundsHalfAwayFromZero) {
+  // 0.005, 1.005, 0.004, 0.995, 0.00005
+  EXPECT_EQ(readCents(numeric(-1, kPositive, 3, {50})), 1);
+  EXPECT_EQ(readCents(numeric(0, kPositive, 3, {1, 50})), 101);
+  EXPECT_EQ(readCents(numeric(0, kNegative, 3, {1, 50})), -101);
+  EXPECT_EQ(readCents(numeric(-1, kPositive, 3, {40})), 0);
+  EXPECT_EQ(readCents(numeric(-1, kPositive, 3, {9950})), 100);
+  EXPECT_EQ(readCents(numeric(-2, kPositive, 5, {5000})), 0);
+  // Решает только первая отброшенная цифра: 1.00499 → 1.00
+  EXPECT_EQ(readCents(numeric(0, kPositive, 5, {1, 49, 9000})), 100);
+}
+
+TEST(ReadNumericScaledTest, HonoursScale) {
+  const auto value = numeric(0, kPositive, 2, {2, 5000});  // 2.5
+  EXPECT_EQ(readNumericScaled(value.data(), static_cast<int>(value.size()), 0), 3);
+  EXPECT_EQ(readNumericScaled(value.data(), static_cast<int>(value.size()), 4), 25000);
+}
+
+TEST(ReadNumericScaledTest, RejectsNaN) {
+  EXPECT_THROW(readCents(numeric(0, kNaN, 0, {})), std::runtime_error);
+}
+
+TEST(ReadNumericScaledTest, RejectsOverflow) {
+  // 10^20 и 10^17 не помещаются в int64 копеек
+  EXPECT_THROW(readCents(numeric(5, kPositive, 0, {1})), std::runtime_error);
+  EXPECT_THROW(readCents(numeric(4, kPositive, 0, {10})), std::runtime_error);
+  EXPECT_EQ(readCents(numeric(4, kPositive, 0, {1})), 10000000000000000 * 100);
+}
+
+TEST(ReadNumericScaledTest, RejectsMalformedValues) {
+  const auto value = numeric(0, kPositive, 2, {310, 2500});
+  EXPECT_THROW(readNumericScaled(value.data(), 6, 2), std::runtime_error);
+  EXPECT_THROW(readNumericScaled(value.data(), 10, 2), std::runtime_error);
+}
+
+}  // namespace
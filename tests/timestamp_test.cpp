@@ -0,0 +1,161 @@
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "auction/model/field_decoder.h"
+#include "auction/model/lot.h"
+#include "auction/model/timestamp.h"
+
+namespace {
+
+using auction::model::formatTimestamp;
+using auction::model::parseTimestamp;
+using auction::model::Timestamp;
+
+Timestamp at(int year, unsigned month, unsigned day, int hour = 0, int minute = 0, int second = 0,
+             std::int64_t micros = 0) {
+  using namespace std::chrono;
+  return Timestamp{sys_days{std::chrono::year{year} / std::chrono::month{month} / std::chrono::day{day}}} +
+         hours{hour} + minutes{minute} + seconds{second} + microseconds{micros};
+}
+
+TEST(TimestampParseTest, ParsesRfc3339AndPostgresForms) {
+  EXPECT_EQ(parseTimestamp("2025-12-31T18:00:00Z"), at(2025, 12, 31, 18));
+  EXPECT_EQ(parseTimestamp("2025-12-31t18:00:00z"), at(2025, 12, 31, 18));
+  EXPECT_EQ(parseTimestamp("2025-12-31 18:00:00.5+00"), at(2025, 12, 31, 18, 0, 0, 500000));
+  EXPECT_EQ(parseTimestamp("2025-12-31 18:00"), at(2025, 12, 31, 18));
+  EXPECT_EQ(parseTimestamp("2025-12-31"), at(2025, 12, 31));
+}
+
+TEST(TimestampParseTest, AppliesEveryOffsetForm) {
+  EXPECT_EQ(parseTimestamp("2025-06-01T12:00:00+05"), at(2025, 6, 1, 7));
+  EXPECT_EQ(parseTimestamp("2025-06-01T12:00:00-05"), at(2025, 6, 1, 17));
+  EXPECT_EQ(parseTimestamp("2025-06-01T12:00:00+0530"), at(2025, 6, 1, 6, 30));
+  EXPECT_EQ(parseTimestamp("2025-06-01T12:00:00+05:30"), at(2025, 6, 1, 6, 30));
+  EXPECT_EQ(parseTimestamp("2025-06-01 12:00+05:30"), at(2025, 6, 1, 6, 30));
+  // Исторические смещения PostgreSQL печатает с секундами
+  EXPECT_EQ(parseTimestamp("1880-01-01 12:00:00+02:30:17"), at(1880, 1, 1, 9, 29, 43));
+  EXPECT_EQ(parseTimestamp("1880-01-01 12:00:00-00:25:21"), at(1880, 1, 1, 12, 25, 21));
+}
+
+TEST(TimestampParseTest, RejectsMalformedOffsets) {
+  EXPECT_EQ(parseTimestamp("2025-06-01T12:00:00+5"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2025-06-01T12:00:00+053"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2025-06-01T12:00:00+05:3"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2025-06-01T12:00:00+05:30:1"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2025-06-01T12:00:00+16"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2025-06-01T12:00:00+05:60"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2025-06-01T12:00:00+05:30:60"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2025-06-01T12:00:00 +05"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2025-06-01T12:00:00Z "), std::nullopt);
+}
+
+TEST(TimestampParseTest, RoundsFractionToMicroseconds) {
+  EXPECT_EQ(parseTimestamp("2025-06-01T12:00:00.1234564Z"), at(2025, 6, 1, 12, 0, 0, 123456));
+  EXPECT_EQ(parseTimestamp("2025-06-01T12:00:00.1234565Z"), at(2025, 6, 1, 12, 0, 0, 123457));
+  EXPECT_EQ(parseTimestamp("2025-06-01T12:00:00.000000999999Z"), at(2025, 6, 1, 12, 0, 0, 1));
+  EXPECT_EQ(parseTimestamp("2025-06-01T12:00:00.Z"), std::nullopt);
+}
+
+TEST(TimestampParseTest, CarriesRoundedFractionAcrossSecondBoundary) {
+  EXPECT_EQ(parseTimestamp("2025-06-01T12:00:59.9999995Z"), at(2025, 6, 1, 12, 1));
+  EXPECT_EQ(parseTimestamp("1999-12-31T23:59:59.9999999Z"), at(2000, 1, 1));
+  EXPECT_EQ(parseTimestamp("2000-01-01T00:59:59.9999999+01"), at(2000, 1, 1));
+}
+
+TEST(TimestampParseTest, MovesLeapSecondIntoNextMinute) {
+  EXPECT_EQ(parseTimestamp("2016-12-31T23:59:60Z"), at(2017, 1, 1));
+  EXPECT_EQ(parseTimestamp("2016-12-31T23:59:60.5Z"), at(2017, 1, 1, 0, 0, 0, 500000));
+  EXPECT_EQ(parseTimestamp("2017-01-01T02:59:60+03:00"), at(2017, 1, 1));
+  EXPECT_EQ(parseTimestamp("2016-12-31T23:59:61Z"), std::nullopt);
+}
+
+TEST(TimestampParseTest, ChecksYearRangeAfterOffset) {
+  EXPECT_EQ(parseTimestamp("0001-01-01T00:00:00Z"), at(1, 1, 1));
+  EXPECT_EQ(parseTimestamp("9999-12-31T23:59:59.999999Z"), at(9999, 12, 31, 23, 59, 59, 999999));
+  EXPECT_EQ(parseTimestamp("0001-01-01T03:00:00+02:00"), at(1, 1, 1, 1));
+  EXPECT_EQ(parseTimestamp("9999-12-31T20:00:00-03:00"), at(9999, 12, 31, 23));
+
+  // В UTC это уже 0000 и 10000 год
+  EXPECT_EQ(parseTimestamp("0001-01-01T01:00:00+02:00"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("9999-12-31T23:00:00-05:00"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("9999-12-31T23:59:59.9999999Z"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("9999-12-31T23:59:60Z"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("0000-12-31T23:00:00Z"), std::nullopt);
+}
+
+TEST(TimestampParseTest, RejectsInvalidDates) {
+  EXPECT_EQ(parseTimestamp(""), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2025-02-29"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2025-13-01"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2025-1-01"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2025-06-01T24:00:00Z"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2025-06-01T12:60:00Z"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2025-06-01T12"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2025-06-01X12:00:00Z"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2024-02-29"), at(2024, 2, 29));
+}
+
+TEST(TimestampParseTest, MapsInfinityToRangeEnds) {
+  EXPECT_EQ(parseTimestamp("infinity"), Timestamp::max());
+  EXPECT_EQ(parseTimestamp("-infinity"), Timestamp::min());
+  EXPECT_EQ(parseTimestamp("+infinity"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("Infinity"), std::nullopt);
+}
+
+TEST(TimestampFormatTest, PrintsPostgresUtcForm) {
+  EXPECT_EQ(formatTimestamp(at(2025, 1, 2, 3, 4, 5, 123456)), "2025-01-02 03:04:05.123456+00");
+  EXPECT_EQ(formatTimestamp(at(2025, 1, 2, 3, 4, 5, 120000)), "2025-01-02 03:04:05.12+00");
+  EXPECT_EQ(formatTimestamp(at(2025, 1, 2, 3, 4, 5, 1)), "2025-01-02 03:04:05.000001+00");
+  EXPECT_EQ(formatTimestamp(at(2025, 1, 2)), "2025-01-02 00:00:00+00");
+  EXPECT_EQ(formatTimestamp(at(1, 1, 1)), "0001-01-01 00:00:00+00");
+  EXPECT_EQ(formatTimestamp(at(9999, 12, 31, 23, 59, 59, 999999)), "9999-12-31 23:59:59.999999+00");
+}
+
+TEST(TimestampFormatTest, PrintsYearsBeyond9999InFull) {
+  EXPECT_EQ(formatTimestamp(at(10000, 1, 1)), "10000-01-01 00:00:00+00");
+  EXPECT_EQ(formatTimestamp(at(32767, 7, 8, 9, 10, 11)), "32767-07-08 09:10:11+00");
+}
+
+TEST(TimestampFormatTest, PrintsInfinity) {
+  EXPECT_EQ(formatTimestamp(Timestamp::max()), "infinity");
+  EXPECT_EQ(formatTimestamp(Timestamp::min()), "-infinity");
+}
+
+TEST(TimestampFormatTest, AppendsToExistingBuffer) {
+  std::string out = "at=";
+  auction::model::appendTimestamp(out, at(2025, 6, 1, 12));
+  EXPECT_EQ(out, "at=2025-06-01 12:00:00+00");
+}
+
+TEST(TimestampFormatTest, RoundTripsThroughParse) {
+  for (const Timestamp value : {at(1, 1, 1), at(1970, 1, 1), at(2016, 12, 31, 23, 59, 59, 999999),
+                                at(2025, 6, 1, 12, 0, 0, 500000), at(9999, 12, 31, 23, 59, 59, 999999),
+                                Timestamp::max(), Timestamp::min()}) {
+    EXPECT_EQ(parseTimestamp(formatTimestamp(value)), value) << formatTimestamp(value);
+  }
+}
+
+TEST(LotPayloadTimestampTest, TreatsEmptyEndDateAsAbsent) {
+  const auto lot = auction::model::lotFromJson(R"({"name":"a","start_price":1,"auction_end_date":""})");
+  EXPECT_EQ(lot.auction_end_date, std::nullopt);
+
+  auction::model::Lot patched = auction::model::lotFromJson(
+      R"({"name":"a","start_price":1,"auction_end_date":"2025-06-01T12:00:00+05:30"})");
+  EXPECT_EQ(patched.auction_end_date, at(2025, 6, 1, 6, 30));
+  auction::model::applyLotPatch(patched, R"({"auction_end_date":""})");
+  EXPECT_EQ(patched.auction_end_date, std::nullopt);
+}
+
+TEST(LotPayloadTimestampTest, RejectsUnparsableEndDate) {
+  EXPECT_THROW(auction::model::lotFromJson(R"({"name":"a","start_price":1,"auction_end_date":"tomorrow"})"),
+               auction::model::PayloadError);
+  EXPECT_THROW(
+      auction::model::lotFromJson(R"({"name":"a","start_price":1,"auction_end_date":"9999-12-31T23:00:00-05"})"),
+      auction::model::PayloadError);
+}
+
+}  // namespace